@@ -144,7 +144,7 @@ bool AStrategyAIController::IsTargetValid(AActor* InActor) const
 		}
 	}
 
-	if ( TestChar && (TestChar->GetHealth() > 0) && AStrategyGameMode::OnEnemyTeam(TestChar, this) )
+	if ( TestChar && (TestChar->GetHealth() > 0) && AStrategyGameMode::OnEnemyTeam(TestChar, GetPawn()) )
 	{
 		return true;
 	}
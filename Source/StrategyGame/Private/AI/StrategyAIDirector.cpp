@@ -5,6 +5,7 @@
 #include "StrategyBuilding_Brewery.h"
 #include "StrategyGameBlueprintLibrary.h"
 #include "StrategyAttachment.h"
+#include "StrategyClassStatTable.h"
 
 UStrategyAIDirector::UStrategyAIDirector(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -13,10 +14,10 @@ UStrategyAIDirector::UStrategyAIDirector(const FObjectInitializer& ObjectInitial
 	, CustomScale(1.0)
 	, AnimationRate(1)
 	, NextSpawnTime(0)
+	, SpawnOffsetIndex(0)
 	, MyTeamNum(EStrategyTeam::Unknown)
 {
-	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.bCanEverTick = false;
 
 	// @todo, why aren't these set in BuffData ctor?
 	BuffModifier.BuffData.AttackMin = 0;
@@ -45,6 +46,7 @@ void UStrategyAIDirector::OnGameplayStateChange(EGameplayState::Type NewState)
 	{
 		Activate();
 		NextSpawnTime = 0;
+		SpawnOffsetIndex = AStrategyGameState::GetWorldRandomStream(GetWorld()).RandRange(0, 5);
 	}
 }
 
@@ -90,10 +92,8 @@ void UStrategyAIDirector::SetBuffModifier(AStrategyChar* InChar, int32 AttackMin
 struct OffsetsGeneratorHelper
 {
 	float Offset[6];
-	int32 LastIndex;
 
 	OffsetsGeneratorHelper()
-		: LastIndex( FMath::RandRange(0, 5) )
 	{
 		TArray<float> AllSlots;
 		for (int32 Idx = 0; Idx < 6; Idx++)
@@ -109,7 +109,8 @@ struct OffsetsGeneratorHelper
 		}
 	}
 
-	float GetOffset()
+	/** advance index of last used spot, each director keeps its own so matches don't depend on each other */
+	float GetOffset(int32& LastIndex) const
 	{
 		LastIndex = ++LastIndex >= 6 ? 0 : LastIndex;
 		return Offset[LastIndex];
@@ -118,9 +119,10 @@ struct OffsetsGeneratorHelper
 
 void UStrategyAIDirector::SpawnMinions()
 {
-	static OffsetsGeneratorHelper OffsetsGenerator;
+	static const OffsetsGeneratorHelper OffsetsGenerator;
 
-	const bool bShoudSpawnNewUnits = GetWorld()->GetTimeSeconds() > NextSpawnTime;
+	const float CurrentTime = AStrategyGameState::GetWorldSimulationTime(GetWorld());
+	const bool bShoudSpawnNewUnits = CurrentTime > NextSpawnTime;
 	if (!bShoudSpawnNewUnits)
 	{
 		return;
@@ -147,7 +149,7 @@ void UStrategyAIDirector::SpawnMinions()
 			FVector Loc = Owner->GetActorLocation();
 			const FVector X = Owner->GetTransform().GetScaledAxis( EAxis::X );
 			const FVector Y = Owner->GetTransform().GetScaledAxis( EAxis::Y );
-			Loc += X * RadiusToSpawnOn +  Y * OffsetsGenerator.GetOffset();
+			Loc += X * RadiusToSpawnOn +  Y * OffsetsGenerator.GetOffset(SpawnOffsetIndex);
 
 			const FVector Scale(CustomScale);
 			const FVector TraceOffset(0.0f,0.0f,RadiusToSpawnOn * 0.5 * Scale.Z);
@@ -158,9 +160,9 @@ void UStrategyAIDirector::SpawnMinions()
 			{
 				Loc = Hit.Location + FVector(0.0f,0.0f,Scale.Z * 10.0f);
 			}
-			AStrategyChar* StrategyChar = Owner->MinionCharClass->GetDefaultObject<AStrategyChar>();
-			const float CapsuleHalfHeight = StrategyChar->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
-			const float CapsuleRadius = StrategyChar->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+			const FStrategyClassStats& MinionStats = FStrategyClassStatTable::GetStats(Owner->MinionCharClass);
+			const float CapsuleHalfHeight = MinionStats.CapsuleHalfHeight;
+			const float CapsuleRadius = MinionStats.CapsuleRadius;
 			Loc = Loc + FVector( 0.0f,0.0f,Scale.Z * CapsuleHalfHeight);
 
 			// and spawn our minion
@@ -181,12 +183,6 @@ void UStrategyAIDirector::SpawnMinions()
 				MinionChar->GetCapsuleComponent()->SetCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
 				MinionChar->GetMesh()->GlobalAnimRateScale = AnimationRate;
 
-				AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
-				if (GameState != nullptr)
-				{
-					GameState->OnCharSpawned(MinionChar);
-				}
-
 				MinionChar->ApplyBuff(BuffModifier);
 				if (DefaultWeapon != nullptr)
 				{
@@ -199,11 +195,15 @@ void UStrategyAIDirector::SpawnMinions()
 
 				WaveSize -= 1;
 				WaveSize = FMath::Max(WaveSize, 0);
-				if (Owner != nullptr && WaveSize <= 0 && MyTeamNum==EStrategyTeam::Enemy)
+				if (Owner != nullptr)
 				{
-					Owner->OnWaveSpawned.Broadcast();
+					Owner->NotifySpawnQueueChanged();
+					if (WaveSize <= 0 && MyTeamNum==EStrategyTeam::Enemy)
+					{
+						Owner->OnWaveSpawned.Broadcast();
+					}
 				}
-				NextSpawnTime = GetWorld()->GetTimeSeconds() + FMath::FRandRange(2.0f, 3.0f);
+				NextSpawnTime = CurrentTime + AStrategyGameState::GetWorldRandomStream(GetWorld()).FRandRange(2.0f, 3.0f);
 			}
 			else
 			{
@@ -218,7 +218,7 @@ void UStrategyAIDirector::SpawnMinions()
 		// If we failed to spawn a minion try again soon
 		if( bSpawnedNewMinion == false )
 		{
-			NextSpawnTime = GetWorld()->GetTimeSeconds() + 0.1f;
+			NextSpawnTime = CurrentTime + 0.1f;
 		}
 	}
 }
@@ -226,10 +226,10 @@ void UStrategyAIDirector::SpawnMinions()
 void UStrategyAIDirector::RequestSpawn()
 {
 	WaveSize += 1;
-}
 
-void UStrategyAIDirector::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-	SpawnMinions();
+	const AStrategyBuilding_Brewery* const Owner = Cast<AStrategyBuilding_Brewery>(GetOwner());
+	if (Owner != nullptr)
+	{
+		Owner->NotifySpawnQueueChanged();
+	}
 }
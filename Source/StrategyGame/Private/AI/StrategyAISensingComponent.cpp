@@ -2,6 +2,7 @@
 
 #include "StrategyGame.h"
 #include "StrategyAISensingComponent.h"
+#include "StrategyTeamTable.h"
 
 UStrategyAISensingComponent::UStrategyAISensingComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -34,6 +35,8 @@ bool UStrategyAISensingComponent::CanSenseAnything() const
 
 void UStrategyAISensingComponent::UpdateAISensing()
 {
+	FStrategyPerFrameScope PerFrameScope;
+
 	const AActor* const Owner = GetOwner();
 	if (!IsValid(Owner) || (Owner->GetWorld() == NULL))
 	{
@@ -41,9 +44,25 @@ void UStrategyAISensingComponent::UpdateAISensing()
 		return;
 	}
 
-	for (AStrategyChar* const TestChar : TActorRange<AStrategyChar>(Owner->GetWorld()))
+	const AStrategyGameState* const GameState = Owner->GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState == NULL)
+	{
+		return;
+	}
+
+	// cells no one on our team could see are skipped before the line of sight trace
+	const FStrategyVisibilityGrid& VisibilityGrid = GameState->GetVisibilityGrid();
+	const uint8 SensorTeam = FStrategyTeamTable::GetTeam(Owner);
+	const bool bUseVisibility = SensorTeam != EStrategyTeam::Unknown;
+
+	const FStrategyUnitRegistry& Registry = GameState->GetUnitRegistry();
+	const TArray<AStrategyChar*>& Chars = Registry.GetChars();
+	const TArray<FVector>& Locations = Registry.GetLocations();
+	const TArray<float>& Health = Registry.GetHealth();
+	for (int32 i = 0; i < Chars.Num(); i++)
 	{
-		if (!IsSensorActor(TestChar) && ShouldCheckVisibilityOf(TestChar))
+		AStrategyChar* const TestChar = Chars[i];
+		if (TestChar != NULL && Health[i] > 0 && (!bUseVisibility || VisibilityGrid.IsVisible(SensorTeam, Locations[i])) && !IsSensorActor(TestChar) && ShouldCheckVisibilityOf(TestChar))
 		{
 			if (CouldSeePawn(TestChar, true))
 			{
@@ -6,6 +6,8 @@
 #include "SStrategySlateHUDWidget.h"
 #include "SStrategyButtonWidget.h"
 #include "StrategySelectionInterface.h"
+#include "StrategyClassStatTable.h"
+#include "StrategyTeamTable.h"
 
 
 AStrategyBuilding::AStrategyBuilding(const FObjectInitializer& ObjectInitializer)
@@ -16,14 +18,18 @@ AStrategyBuilding::AStrategyBuilding(const FObjectInitializer& ObjectInitializer
 	, Health(100)
 	, bAffectFriendlyMinion(true)
 	, bAffectEnemyMinion(true)
+	, bUseTouchEvents(true)
 	, bIsContructionFinished(false)
 	, bIsBeingBuild(false)
 	, bIsActionMenuDisplayed(false)
 	, MyTeamNum(EStrategyTeam::Unknown)
-	, RemainingBuildTime(0)
+	, InitialBuildTime(0)
+	, BuildFinishTime(0)
+	, ClassStatsIndex(INDEX_NONE)
 {
-	PrimaryActorTick.bCanEverTick = true;
-	PrimaryActorTick.bStartWithTickEnabled = true;
+	// construction progress is driven by the game state's scheduler, buildings don't need to tick
+	PrimaryActorTick.bCanEverTick = false;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	USceneComponent* const TranslationComp = CreateDefaultSubobject<USceneComponent>(TEXT("SceneComp"));
 	TranslationComp->Mobility = EComponentMobility::Static;
@@ -71,6 +77,23 @@ void AStrategyBuilding::PostInitializeComponents()
 	{
 		SetTeamNum(SpawnTeamNum);
 	}
+	else
+	{
+		FStrategyTeamTable::SetTeam(this, MyTeamNum);
+	}
+
+	if (!bUseTouchEvents)
+	{
+		TriggerBox->SetGenerateOverlapEvents(false);
+		TriggerBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+}
+
+void AStrategyBuilding::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FStrategyTeamTable::ClearTeam(this);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AStrategyBuilding::Destroyed()
@@ -80,6 +103,7 @@ void AStrategyBuilding::Destroyed()
 	{
 		PlayerData->BuildingsList.Remove(this);
 	}
+	NotifyBuildingChanged();
 
 	Super::Destroyed();
 }
@@ -149,7 +173,7 @@ void AStrategyBuilding::NotifyActorBeginOverlap(AActor* Other)
 	Super::NotifyActorBeginOverlap(Other);
 
 	AStrategyChar* const OtherChar = Cast<AStrategyChar>(Other);
-	if (bIsContructionFinished && CanAffectChar(OtherChar))
+	if (bUseTouchEvents && bIsContructionFinished && CanAffectChar(OtherChar))
 	{
 		OnCharTouch(OtherChar);
 	}
@@ -164,11 +188,14 @@ bool AStrategyBuilding::CanAffectChar(AStrategyChar const* InChar) const
 void AStrategyBuilding::SetTeamNum(uint8 NewTeamNum)
 {
 	MyTeamNum = NewTeamNum;
+	FStrategyTeamTable::SetTeam(this, MyTeamNum);
+
 	FPlayerData* const PlayerData = GetTeamData();
 	if (PlayerData != nullptr)
 	{
 		PlayerData->BuildingsList.Add(this);
 	}
+	NotifyBuildingChanged();
 }
 
 FPlayerData* AStrategyBuilding::GetTeamData() const
@@ -182,6 +209,15 @@ FPlayerData* AStrategyBuilding::GetTeamData() const
 	return nullptr;
 }
 
+void AStrategyBuilding::NotifyBuildingChanged() const
+{
+	AStrategyGameState* const StrategyGame = GetWorld() ? GetWorld()->GetGameState<AStrategyGameState>() : nullptr;
+	if (StrategyGame != nullptr)
+	{
+		StrategyGame->OnBuildingChanged();
+	}
+}
+
 void AStrategyBuilding::ShowActionMenu()
 {
 	if (!bIsActionMenuDisplayed && !bIsCustomActionDisplayed)
@@ -213,7 +249,7 @@ void AStrategyBuilding::ShowActionMenu()
 						UpgradeAction->Data.bIsEnabled = true;
 						UpgradeAction->Widget->DeferredShow();
 						UpgradeAction->Data.ActionCost = DefBuilding->GetBuildingCost(World);
-						UpgradeAction->Data.TriggerDelegate.BindUObject(this, &AStrategyBuilding::ReplaceBuilding, UpgradeList[i]);
+						UpgradeAction->Data.TriggerDelegate.BindUObject(this, &AStrategyBuilding::RequestUpgrade, UpgradeList[i]);
 
 						if (DefBuilding->BuildingIcon != nullptr)
 						{
@@ -274,6 +310,22 @@ bool AStrategyBuilding::ReplaceBuilding(TSubclassOf<AStrategyBuilding> NewBuildi
 	return ReplaceBuilding(NewBuildingClass, &NewBuilding);
 }
 
+bool AStrategyBuilding::RequestUpgrade(TSubclassOf<AStrategyBuilding> NewBuildingClass)
+{
+	if (!ReplaceBuilding(NewBuildingClass))
+	{
+		return false;
+	}
+
+	// replaced building is still around for a moment, its name and location identify the slot
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState != nullptr && GameState->GetReplayRecorder() != nullptr)
+	{
+		GameState->GetReplayRecorder()->RecordUpgrade(GameState, this, NewBuildingClass);
+	}
+	return true;
+}
+
 bool AStrategyBuilding::ReplaceBuilding(TSubclassOf<AStrategyBuilding> NewBuildingClass, AStrategyBuilding** OutNewBuilding)
 {
 	const FPlayerData* MyData = GetTeamData();
@@ -292,6 +344,7 @@ bool AStrategyBuilding::ReplaceBuilding(TSubclassOf<AStrategyBuilding> NewBuildi
 			if(TeamData != nullptr )
 			{
 				TeamData->ResourcesAvailable -= BuildingCost;
+				GetWorld()->GetGameState<AStrategyGameState>()->NotifyResourcesChanged(GetTeamNum());
 			}
 
 			AStrategyGameMode const* const MyGame = GetWorld()->GetAuthGameMode<AStrategyGameMode>();
@@ -325,10 +378,17 @@ bool AStrategyBuilding::StartBuild()
 		bIsBeingBuild = true;
 
 		Health = 1;
-		InitialBuildTime = RemainingBuildTime = GetBuildTime();
+		InitialBuildTime = GetBuildTime();
+		BuildFinishTime = AStrategyGameState::GetWorldSimulationTime(GetWorld()) + InitialBuildTime;
 		OnBuildStarted();
 
-		SetActorTickEnabled(true);
+		AStrategyGameState* const StrategyGame = GetWorld()->GetGameState<AStrategyGameState>();
+		if (StrategyGame != nullptr)
+		{
+			StrategyGame->OnBuildStarted(this, BuildFinishTime);
+			StrategyGame->OnBuildingChanged();
+		}
+
 		if (ConstructionStartStinger)
 		{
 			UGameplayStatics::PlaySoundAtLocation(this, ConstructionStartStinger, GetActorLocation());
@@ -339,34 +399,15 @@ bool AStrategyBuilding::StartBuild()
 	return false;
 }
 
-void AStrategyBuilding::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	if (!bIsBeingBuild || bIsContructionFinished)
-	{
-		return;
-	}
-
-	RemainingBuildTime -= DeltaTime;
-	if (RemainingBuildTime <= 0 )
-	{
-		FinishBuild();
-	}
-	else
-	{
-		Health = FMath::Min<float>( (1 - (RemainingBuildTime / InitialBuildTime)) * GetMaxHealth(), GetMaxHealth() );
-	}
-}
-
 void AStrategyBuilding::FinishBuild()
 {
 	if (bIsBeingBuild)
 	{
 		bIsBeingBuild = false;
 		bIsContructionFinished = true;
-		RemainingBuildTime = 0;
+		BuildFinishTime = AStrategyGameState::GetWorldSimulationTime(GetWorld());
 		Health = GetMaxHealth();
+		NotifyBuildingChanged();
 
 		if (ConstructionEndStinger)
 		{
@@ -377,11 +418,23 @@ void AStrategyBuilding::FinishBuild()
 	}
 }
 
-bool AStrategyBuilding::IsBuildFinished()
+bool AStrategyBuilding::IsBuildFinished() const
 {
 	return bIsContructionFinished;
 }
 
+float AStrategyBuilding::GetRemainingBuildTime(bool bInterpolated) const
+{
+	if (!bIsBeingBuild)
+	{
+		return 0.0f;
+	}
+
+	const AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	const float CurrentTime = !GameState ? GetWorld()->GetTimeSeconds() : bInterpolated ? GameState->GetInterpolatedTime() : GameState->GetSimulationTime();
+	return FMath::Max(BuildFinishTime - CurrentTime, 0.0f);
+}
+
 void AStrategyBuilding::GetUpgradeList(TArray<TSubclassOf<AStrategyBuilding> >& UpgradeList) const
 {
 	for (int32 i = 0; i < Upgrades.Num(); i++)
@@ -407,10 +460,26 @@ uint8 AStrategyBuilding::GetTeamNum() const
 
 int32 AStrategyBuilding::GetHealth() const
 {
+	// health grows with construction progress, computed only when someone asks
+	if (bIsBeingBuild && InitialBuildTime > 0.0f)
+	{
+		const float Progress = 1.0f - (GetRemainingBuildTime() / InitialBuildTime);
+		return FMath::Max<int32>(Health, FMath::Min<float>(Progress * GetMaxHealth(), GetMaxHealth()));
+	}
+	return Health;
+}
+
+int32 AStrategyBuilding::GetDisplayHealth() const
+{
+	if (bIsBeingBuild && InitialBuildTime > 0.0f)
+	{
+		const float Progress = 1.0f - (GetRemainingBuildTime(true) / InitialBuildTime);
+		return FMath::Max<int32>(Health, FMath::Min<float>(Progress * GetMaxHealth(), GetMaxHealth()));
+	}
 	return Health;
 }
 
 int32 AStrategyBuilding::GetMaxHealth() const
 {
-	return GetClass()->GetDefaultObject<AStrategyBuilding>()->GetHealth();
+	return FStrategyClassStatTable::GetStats(this, ClassStatsIndex).Health;
 }
@@ -33,7 +33,7 @@ void AStrategyBuilding_Brewery::PostInitializeComponents()
 	{
 		int32 ResourceInitial = 0;
 
-		AStrategyGameState const* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
+		AStrategyGameState* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
 		if (MyGameState)
 		{
 			switch (MyGameState->GameDifficulty)
@@ -54,6 +54,10 @@ void AStrategyBuilding_Brewery::PostInitializeComponents()
 
 		MyData->ResourcesAvailable = ResourceInitial;
 		MyData->Brewery = this;
+		if (MyGameState)
+		{
+			MyGameState->NotifyResourcesChanged(GetTeamNum());
+		}
 	}
 }
 
@@ -75,6 +79,7 @@ void AStrategyBuilding_Brewery::SetTeamNum(uint8 NewTeamNum)
 		if (NewTeamNum == EStrategyTeam::Player)
 		{
 			AIDirector->WaveSize = 0;
+			NotifySpawnQueueChanged();
 		}
 	}
 
@@ -147,6 +152,11 @@ void AStrategyBuilding_Brewery::ShowActionMenu()
 
 }
 
+void AStrategyBuilding_Brewery::NotifySpawnQueueChanged() const
+{
+	OnSpawnQueueChanged.Broadcast();
+}
+
 FText AStrategyBuilding_Brewery::GetSpawnQueueLength() const
 {
 	return AIDirector->WaveSize > 0 ? FText::AsNumber(AIDirector->WaveSize) : FText::GetEmpty();
@@ -159,6 +169,16 @@ bool AStrategyBuilding_Brewery::SpawnDwarf()
 	{
 		AIDirector->RequestSpawn();
 		MyData->ResourcesAvailable -= SpawnCost;
+
+		AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+		if (GameState != nullptr)
+		{
+			GameState->NotifyResourcesChanged(GetTeamNum());
+		}
+		if (GameState != nullptr && GameState->GetReplayRecorder() != nullptr && GetTeamNum() == EStrategyTeam::Player)
+		{
+			GameState->GetReplayRecorder()->RecordSpawnDwarf(GameState);
+		}
 	}
 
 	return false;
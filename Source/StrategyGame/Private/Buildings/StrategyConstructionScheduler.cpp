@@ -0,0 +1,58 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyConstructionScheduler.h"
+#include "StrategyBuilding.h"
+
+void FStrategyConstructionScheduler::AddBuilding(AStrategyBuilding* InBuilding, float FinishTime)
+{
+	if (InBuilding != nullptr)
+	{
+		FEntry Entry;
+		Entry.FinishTime = FinishTime;
+		Entry.Building = InBuilding;
+		Heap.HeapPush(Entry);
+	}
+}
+
+void FStrategyConstructionScheduler::FinishExpiredBuilds(float CurrentTime)
+{
+	while (Heap.Num() > 0 && Heap.HeapTop().FinishTime <= CurrentTime)
+	{
+		FEntry Entry;
+		Heap.HeapPop(Entry, /*bAllowShrinking=*/false);
+
+		// building could have been replaced or destroyed in the meantime
+		AStrategyBuilding* const Building = Entry.Building.Get();
+		if (Building != nullptr)
+		{
+			Building->FinishBuild();
+		}
+	}
+}
+
+bool FStrategyConstructionScheduler::IsEmpty() const
+{
+	return Heap.Num() == 0;
+}
+
+float FStrategyConstructionScheduler::GetNextFinishTime() const
+{
+	check(Heap.Num() > 0);
+	return Heap.HeapTop().FinishTime;
+}
+
+int32 FStrategyConstructionScheduler::Num() const
+{
+	return Heap.Num();
+}
+
+AStrategyBuilding* FStrategyConstructionScheduler::GetBuilding(int32 Index) const
+{
+	return Heap[Index].Building.Get();
+}
+
+void FStrategyConstructionScheduler::Reset()
+{
+	Heap.Reset();
+}
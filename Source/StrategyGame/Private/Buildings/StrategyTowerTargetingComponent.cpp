@@ -0,0 +1,187 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyTowerTargetingComponent.h"
+#include "StrategyBuilding_Brewery.h"
+#include "StrategyProjectile.h"
+#include "StrategyTeamTable.h"
+
+UStrategyTowerTargetingComponent::UStrategyTowerTargetingComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, TargetPolicy(ETowerTargetPolicy::First)
+	, Range(1000.0f)
+	, TargetingInterval(0.25f)
+	, bAutoFire(true)
+	, FireInterval(1.0f)
+	, ProjectileDamage(20)
+	, ProjectileLifeSpan(3.0f)
+	, MuzzleOffset(0.0f, 0.0f, 200.0f)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UStrategyTowerTargetingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState == nullptr)
+	{
+		return;
+	}
+
+	// targeting and firing run on gameplay time, so they happen at the same steps at any frame rate
+	FStrategySimulationTimers& Timers = GameState->GetSimulationTimers();
+	const float CurrentTime = GameState->GetSimulationTime();
+
+	// spread towers placed at the same time over different steps
+	const float FirstDelay = GameState->GetRandomStream().FRandRange(0.0f, TargetingInterval);
+	Timers.SetTimer(TimerHandle_UpdateTarget, FTimerDelegate::CreateUObject(this, &UStrategyTowerTargetingComponent::UpdateTarget), CurrentTime + FirstDelay, TargetingInterval, true);
+
+	if (bAutoFire && FireInterval > 0.0f)
+	{
+		Timers.SetTimer(TimerHandle_AutoFire, FTimerDelegate::CreateUObject(this, &UStrategyTowerTargetingComponent::OnAutoFire), CurrentTime + FireInterval, FireInterval, true);
+	}
+}
+
+void UStrategyTowerTargetingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState != nullptr)
+	{
+		GameState->GetSimulationTimers().ClearTimer(TimerHandle_UpdateTarget);
+		GameState->GetSimulationTimers().ClearTimer(TimerHandle_AutoFire);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UStrategyTowerTargetingComponent::CanOwnerFire() const
+{
+	AStrategyBuilding* const OwnerBuilding = Cast<AStrategyBuilding>(GetOwner());
+	return OwnerBuilding == nullptr || OwnerBuilding->IsBuildFinished();
+}
+
+bool UStrategyTowerTargetingComponent::IsValidTarget(const AStrategyChar* InChar) const
+{
+	if (InChar == nullptr || InChar->bIsDying || InChar->GetHealth() <= 0 || InChar->IsPendingKill())
+	{
+		return false;
+	}
+
+	if (!AStrategyGameMode::OnEnemyTeam(GetOwner(), InChar))
+	{
+		return false;
+	}
+
+	const FVector2D Delta = FVector2D(InChar->GetActorLocation() - GetOwner()->GetActorLocation());
+	return Delta.SizeSquared() <= FMath::Square(Range);
+}
+
+float UStrategyTowerTargetingComponent::ScoreTarget(const AStrategyChar* InChar, const FVector& TowerLocation, const FVector& GoalLocation) const
+{
+	switch (TargetPolicy)
+	{
+		case ETowerTargetPolicy::First:
+			return FVector::DistSquared2D(InChar->GetActorLocation(), GoalLocation);
+		case ETowerTargetPolicy::Nearest:
+			return FVector::DistSquared2D(InChar->GetActorLocation(), TowerLocation);
+		case ETowerTargetPolicy::LowestHealth:
+			return InChar->GetHealth();
+		case ETowerTargetPolicy::Strongest:
+			return -InChar->GetMaxHealth();
+		default:
+			return 0.0f;
+	}
+}
+
+void UStrategyTowerTargetingComponent::UpdateTarget()
+{
+	AActor* const MyOwner = GetOwner();
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (MyOwner == nullptr || GameState == nullptr || !CanOwnerFire())
+	{
+		CurrentTarget.Reset();
+		return;
+	}
+
+	const FVector TowerLocation = MyOwner->GetActorLocation();
+
+	// "first" means closest to the brewery this tower defends, fall back to tower location if there is none
+	FVector GoalLocation = TowerLocation;
+	const uint8 OwnerTeam = FStrategyTeamTable::GetTeam(MyOwner);
+	const FPlayerData* const TeamData = (OwnerTeam < EStrategyTeam::MAX) ? GameState->GetPlayerData(OwnerTeam) : nullptr;
+	if (TeamData && TeamData->Brewery.IsValid())
+	{
+		GoalLocation = TeamData->Brewery->GetActorLocation();
+	}
+
+	Candidates.Reset();
+	GameState->GetUnitSpatialIndex().QueryEnemies(TowerLocation, Range, OwnerTeam, Candidates);
+
+	AStrategyChar* BestTarget = nullptr;
+	float BestScore = MAX_FLT;
+	for (AStrategyChar* const TestChar : Candidates)
+	{
+		if (IsValidTarget(TestChar))
+		{
+			const float Score = ScoreTarget(TestChar, TowerLocation, GoalLocation);
+			if (BestTarget == nullptr || Score < BestScore)
+			{
+				BestTarget = TestChar;
+				BestScore = Score;
+			}
+		}
+	}
+
+	CurrentTarget = BestTarget;
+}
+
+AStrategyChar* UStrategyTowerTargetingComponent::GetCurrentTarget() const
+{
+	AStrategyChar* const Target = CurrentTarget.Get();
+	return IsValidTarget(Target) ? Target : nullptr;
+}
+
+AStrategyProjectile* UStrategyTowerTargetingComponent::RequestFire()
+{
+	AActor* const MyOwner = GetOwner();
+	AStrategyChar* const Target = GetCurrentTarget();
+	if (MyOwner == nullptr || Target == nullptr || ProjectileClass == nullptr || !CanOwnerFire())
+	{
+		return nullptr;
+	}
+
+	const FVector Origin = MyOwner->GetActorTransform().TransformPosition(MuzzleOffset);
+
+	// lead the target by the time projectile needs to get there
+	FVector AimLocation = Target->GetActorLocation();
+	const AStrategyProjectile* const DefProjectile = ProjectileClass->GetDefaultObject<AStrategyProjectile>();
+	const float ProjectileSpeed = DefProjectile->GetMovementComp() ? DefProjectile->GetMovementComp()->InitialSpeed : 0.0f;
+	if (ProjectileSpeed > 0.0f)
+	{
+		const float TravelTime = FVector::Dist(Origin, AimLocation) / ProjectileSpeed;
+		AimLocation += Target->GetVelocity() * TravelTime;
+	}
+
+	const FVector ShootDir = (AimLocation - Origin).GetSafeNormal();
+	const FTransform SpawnTransform(ShootDir.Rotation(), Origin);
+
+	AStrategyProjectile* const Projectile = GetWorld()->SpawnActorDeferred<AStrategyProjectile>(ProjectileClass, SpawnTransform, MyOwner, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Projectile)
+	{
+		IStrategyTeamInterface* const OwnerTeam = Cast<IStrategyTeamInterface>(MyOwner);
+		Projectile->Building = Cast<AStrategyBuilding>(MyOwner);
+		UGameplayStatics::FinishSpawningActor(Projectile, SpawnTransform);
+		Projectile->InitProjectile(ShootDir, OwnerTeam ? OwnerTeam->GetTeamNum() : EStrategyTeam::Unknown, ProjectileDamage, ProjectileLifeSpan);
+
+		OnProjectileFired.Broadcast(Projectile, Target);
+	}
+
+	return Projectile;
+}
+
+void UStrategyTowerTargetingComponent::OnAutoFire()
+{
+	RequestFire();
+}
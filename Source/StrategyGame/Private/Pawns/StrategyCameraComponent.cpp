@@ -3,7 +3,6 @@
 #include "StrategyGame.h"
 #include "StrategyCameraComponent.h"
 #include "StrategyHelpers.h"
-#include "StrategySpectatorPawnMovement.h"
 #include "StrategyInput.h"
 
 UStrategyCameraComponent::UStrategyCameraComponent(const FObjectInitializer& ObjectInitializer)
@@ -15,6 +14,7 @@ UStrategyCameraComponent::UStrategyCameraComponent(const FObjectInitializer& Obj
 	MaxZoomLevel = 1.0f;
 	MiniMapBoundsLimit = 0.8f;
 	StartSwipeCoords.Set(0.0f, 0.0f, 0.0f);
+	DefaultSpectatorSpeed = -1.0f;
 }
 
 void UStrategyCameraComponent::OnZoomIn()
@@ -63,17 +63,7 @@ void UStrategyCameraComponent::UpdateCameraMovement( const APlayerController* In
 
 		const float MaxSpeed = CameraScrollSpeed * FMath::Clamp(ZoomAlpha, 0.3f, 1.0f);
 
-		AStrategyGameState const* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
-		bool bNoScrollZone = false;
-		FVector MouseCoords( MousePosition, 0.0f );
-		for (int iZone = 0; iZone < NoScrollZones.Num() ; iZone++)
-		{
-			FBox EachZone = NoScrollZones[ iZone ];
-			if( EachZone.IsInsideXY( MouseCoords ) == true )
-			{
-				bNoScrollZone = true;
-			}
-		}
+		const bool bNoScrollZone = AreCoordsInNoScrollZone(MousePosition);
 
 		const uint32 MouseX = MousePosition.X;
 		const uint32 MouseY = MousePosition.Y;
@@ -82,9 +72,15 @@ void UStrategyCameraComponent::UpdateCameraMovement( const APlayerController* In
 		if( GetPlayerController() != NULL )
 		{
 			SpectatorPawn = GetPlayerController()->GetSpectatorPawn();
-			if( SpectatorPawn->GetMovementComponent() != NULL )
+			UFloatingPawnMovement* PawnMovementComponent = SpectatorPawn ? Cast<UFloatingPawnMovement>(SpectatorPawn->GetMovementComponent()) : NULL;
+			if( PawnMovementComponent != NULL )
 			{
-				SpectatorCameraSpeed = GetDefault<UStrategySpectatorPawnMovement>(SpectatorPawn->GetMovementComponent()->GetClass())->MaxSpeed;
+				// read before the first change below, later updates restore it
+				if (DefaultSpectatorSpeed < 0.0f)
+				{
+					DefaultSpectatorSpeed = PawnMovementComponent->MaxSpeed;
+				}
+				SpectatorCameraSpeed = DefaultSpectatorSpeed;
 			}
 		}
 		if (!bNoScrollZone)
@@ -126,7 +122,6 @@ void UStrategyCameraComponent::UpdateCameraMovement( const APlayerController* In
 		}
 	}
 #endif
-	NoScrollZones.Empty();
 }
 
 void UStrategyCameraComponent::MoveForward(float Val)
@@ -163,11 +158,6 @@ void UStrategyCameraComponent::MoveRight(float Val)
 	}
 }
 
-void UStrategyCameraComponent::AddNoScrollZone( FBox InCoords )
-{
-	NoScrollZones.AddUnique( InCoords );
-}
-
 void UStrategyCameraComponent::ClampCameraLocation( const APlayerController* InPlayerController, FVector& OutCameraLocation )
 {
 	if (bShouldClampCamera)
@@ -364,17 +354,16 @@ void UStrategyCameraComponent::EndSwipeNow()
 	StartSwipeCoords.Set(0.0f, 0.0f, 0.0f);
 }
 
-bool UStrategyCameraComponent::AreCoordsInNoScrollZone(const FVector2D& SwipePosition)
+bool UStrategyCameraComponent::AreCoordsInNoScrollZone(const FVector2D& SwipePosition) const
 {
-	bool bResult = false;
-	FVector MouseCoords(SwipePosition, 0.0f);
-	for (int iZone = 0; iZone < NoScrollZones.Num(); iZone++)
-	{
-		FBox EachZone = NoScrollZones[iZone];
-		if (EachZone.IsInsideXY(MouseCoords) == true)
-		{
-			bResult = true;
-		}
-	}
-	return bResult;
+	const FStrategyExclusionZones* ExclusionZones = GetExclusionZones();
+	return ExclusionZones != NULL && ExclusionZones->IsExcluded(SwipePosition);
+}
+
+const FStrategyExclusionZones* UStrategyCameraComponent::GetExclusionZones() const
+{
+	const APawn* Owner = Cast<APawn>(GetOwner());
+	const APlayerController* Controller = Owner ? Cast<APlayerController>(Owner->GetController()) : NULL;
+	AStrategyHUD* HUD = Controller ? Cast<AStrategyHUD>(Controller->GetHUD()) : NULL;
+	return HUD ? &HUD->GetExclusionZones() : NULL;
 }
@@ -3,10 +3,15 @@
 #include "StrategyGame.h"
 #include "StrategyAIController.h"
 #include "StrategyAttachment.h"
+#include "StrategyClassStatTable.h"
+#include "StrategyTeamTable.h"
 
 AStrategyChar::AStrategyChar(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass<UCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 	, ResourcesToGather(10)
+	, BuffDelta(ForceInit)
+	, ClassStatsIndex(INDEX_NONE)
+	, UnitRegistryIndex(INDEX_NONE)
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -31,11 +36,39 @@ void AStrategyChar::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
+	FStrategyTeamTable::SetTeam(this, MyTeamNum);
+
 	// initialization
 	UpdatePawnData();
 	UpdateHealth();
 }
 
+void AStrategyChar::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState && !bIsDying)
+	{
+		GameState->GetHealthRegenSystem().AddChar(this);
+		GameState->OnCharSpawned(this);
+	}
+}
+
+void AStrategyChar::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState)
+	{
+		GameState->GetHealthRegenSystem().RemoveChar(this);
+		GameState->OnCharRemoved(this);
+	}
+
+	FStrategyTeamTable::ClearTeam(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 bool AStrategyChar::CanBeBaseForCharacter(APawn* Pawn) const
 {
 	return false;
@@ -68,8 +101,8 @@ float AStrategyChar::PlayMeleeAnim()
 
 void AStrategyChar::OnMeleeImpactNotify()
 {
-	const int32 MeleeDamage = FMath::RandRange(ModifiedPawnData.AttackMin, ModifiedPawnData.AttackMax);
-	const TSubclassOf<UDamageType> MeleeDmgType = UDamageType::StaticClass();
+	const int32 MeleeDamage = AStrategyGameState::GetWorldRandomStream(GetWorld()).RandRange(ModifiedPawnData.AttackMin, ModifiedPawnData.AttackMax);
+	const float MeleeBoxExtent = 80.f;
 
 	// Do a trace to see what we hit
 	const float CollisionRadius = GetCapsuleComponent() ? GetCapsuleComponent()->GetScaledCapsuleRadius() : 0.f;
@@ -77,21 +110,109 @@ void AStrategyChar::OnMeleeImpactNotify()
 	const FVector TraceStart = GetActorLocation();
 	const FVector TraceDir = GetActorForwardVector();
 	const FVector TraceEnd = TraceStart + TraceDir * TraceDistance;
+
+	// units are looked up in the spatial index, physics is left for buildings
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	const bool bUseSpatialQuery = GameState && GameState->bUseSpatialMeleeQuery;
+	AStrategyChar* TargetChar = nullptr;
+	float TargetDistance = TraceDistance;
+	if (bUseSpatialQuery)
+	{
+		TargetChar = FindMeleeTarget(GameState, TraceStart, TraceDir, TraceDistance, MeleeBoxExtent, TargetDistance);
+	}
+
+	// first hit wins, so with a unit found only the part of the sweep before it can hold a nearer building
+	if (TargetChar != nullptr && TargetDistance <= 0.f)
+	{
+		const FHitResult Hit(TargetChar, TargetChar->GetCapsuleComponent(), TargetChar->GetActorLocation(), -TraceDir);
+		ApplyMeleeDamage(GameState, MeleeDamage, TraceDir, Hit);
+		return;
+	}
+
 	TArray<FHitResult> Hits;
 	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(MeleeHit), false, this);
 	FCollisionResponseParams ResponseParam(ECollisionResponse::ECR_Overlap);
-	GetWorld()->SweepMultiByChannel(Hits, TraceStart, TraceEnd, FQuat::Identity, COLLISION_WEAPON, FCollisionShape::MakeBox(FVector(80.f)), TraceParams, ResponseParam);
+	const FVector SweepEnd = TargetChar ? TraceStart + TraceDir * TargetDistance : TraceEnd;
+	GetWorld()->SweepMultiByChannel(Hits, TraceStart, SweepEnd, FQuat::Identity, COLLISION_WEAPON, FCollisionShape::MakeBox(FVector(MeleeBoxExtent)), TraceParams, ResponseParam);
 
 	for (int32 i=0; i<Hits.Num(); i++)
 	{
 		FHitResult const& Hit = Hits[i];
+
+		// units were already checked against the index
+		if (bUseSpatialQuery && Cast<AStrategyChar>(Hit.GetActor()))
+		{
+			continue;
+		}
+
 		if (AStrategyGameMode::OnEnemyTeam(this, Hit.GetActor()))
 		{
-			UGameplayStatics::ApplyPointDamage(Hit.GetActor(), MeleeDamage, TraceDir, Hit, Controller, this, MeleeDmgType);
+			ApplyMeleeDamage(GameState, MeleeDamage, TraceDir, Hit);
 
 			// only damage first hit
-			break;
+			return;
+		}
+	}
+
+	if (TargetChar)
+	{
+		const FHitResult Hit(TargetChar, TargetChar->GetCapsuleComponent(), TargetChar->GetActorLocation(), -TraceDir);
+		ApplyMeleeDamage(GameState, MeleeDamage, TraceDir, Hit);
+	}
+}
+
+AStrategyChar* AStrategyChar::FindMeleeTarget(const AStrategyGameState* GameState, const FVector& TraceStart, const FVector& TraceDir, float TraceDistance, float BoxExtent, float& OutHitDistance) const
+{
+	// generous radius grown by the largest unit, candidates are tested against the swept box below
+	const FStrategyUnitSpatialIndex& SpatialIndex = GameState->GetUnitSpatialIndex();
+	FStrategyUnitSpatialIndex::FCharArray Candidates;
+	SpatialIndex.QueryEnemies(TraceStart, TraceDistance + 2.f * BoxExtent + SpatialIndex.GetMaxUnitRadius(), GetTeamNum(), Candidates);
+
+	const FVector2D Start2D(TraceStart);
+	const FVector2D Dir2D = FVector2D(TraceDir).GetSafeNormal();
+
+	AStrategyChar* BestChar = nullptr;
+	float BestDistance = MAX_FLT;
+	for (AStrategyChar* const TestChar : Candidates)
+	{
+		if (TestChar == this || TestChar->bIsDying || TestChar->Health <= 0.f)
+		{
+			continue;
+		}
+
+		// capsule touches box swept along the trace
+		const float TestRadius = TestChar->GetCapsuleComponent() ? TestChar->GetCapsuleComponent()->GetScaledCapsuleRadius() : 0.f;
+		const FVector2D Delta = FVector2D(TestChar->GetActorLocation()) - Start2D;
+		const float Along = Delta | Dir2D;
+		const float Across = (Delta - Dir2D * Along).Size();
+		if (Along < -(BoxExtent + TestRadius) || Along > TraceDistance + BoxExtent + TestRadius || Across > BoxExtent + TestRadius)
+		{
+			continue;
 		}
+
+		// sweep hits are ordered by how far the box travels before touching, first one wins
+		const float HitDistance = FMath::Max(Along - BoxExtent - TestRadius, 0.f);
+		if (HitDistance < BestDistance)
+		{
+			BestChar = TestChar;
+			BestDistance = HitDistance;
+		}
+	}
+
+	OutHitDistance = BestDistance;
+	return BestChar;
+}
+
+void AStrategyChar::ApplyMeleeDamage(AStrategyGameState* GameState, int32 MeleeDamage, const FVector& TraceDir, const FHitResult& Hit)
+{
+	if (GameState)
+	{
+		// resolved with the rest of this frame's damage
+		GameState->GetDamageQueue().QueuePointDamage(Hit.GetActor(), MeleeDamage, GetTeamNum(), TraceDir, Hit, Controller, this);
+	}
+	else
+	{
+		UGameplayStatics::ApplyPointDamage(Hit.GetActor(), MeleeDamage, TraceDir, Hit, Controller, this, UDamageType::StaticClass());
 	}
 }
 
@@ -108,6 +229,17 @@ float AStrategyChar::TakeDamage(float Damage, struct FDamageEvent const& DamageE
 	AStrategyGameMode* const Game = GetWorld()->GetAuthGameMode<AStrategyGameMode>();
 	Damage = Game ? Game->ModifyDamage(Damage, this, DamageEvent, EventInstigator, DamageCauser) : 0.f;
 
+	return ApplyResolvedDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
+}
+
+float AStrategyChar::ApplyResolvedDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
+{
+	if (Health <= 0.f)
+	{
+		// no further damage if already dead
+		return 0.f;
+	}
+
 	const float ActualDamage = Super::TakeDamage(Damage, DamageEvent, EventInstigator, DamageCauser);
 	if (ActualDamage > 0.f)
 	{
@@ -159,14 +291,13 @@ void AStrategyChar::Die(float KillingDamage, FDamageEvent const& DamageEvent, AC
 	// forcibly end any timers that may be in flight
 	GetWorldTimerManager().ClearAllTimersForObject(this);
 
-	// notify the game mode if an Enemy dies
-	if (GetTeamNum() == EStrategyTeam::Enemy)
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState)
 	{
-		AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
-		if (GameState)
-		{
-			GameState->OnCharDied(this);
-		}
+		// no more regen for the dead
+		GameState->GetHealthRegenSystem().RemoveChar(this);
+
+		GameState->OnCharDied(this);
 	}
 
 	// disable any AI
@@ -278,19 +409,38 @@ uint8 AStrategyChar::GetTeamNum() const
 void AStrategyChar::SetTeamNum(uint8 NewTeamNum)
 {
 	MyTeamNum = NewTeamNum;
+	FStrategyTeamTable::SetTeam(this, MyTeamNum);
+
+	AStrategyGameState* const GameState = GetWorld() ? GetWorld()->GetGameState<AStrategyGameState>() : nullptr;
+	if (GameState)
+	{
+		GameState->OnCharDataChanged(this);
+	}
 }
 
 void AStrategyChar::ApplyBuff(const FBuffData& Buff)
 {
-	// calc the end time
+	// buff that expires right away has no effect
+	if (!Buff.bInfiniteDuration && Buff.Duration <= 0.f)
+	{
+		return;
+	}
+
 	FBuffData NewBuff = Buff;
+	NewBuff.ApplyBuff(BuffDelta);
+
+	// only time limited buffs need to be tracked, infinite ones just stay in the delta
 	if (!Buff.bInfiniteDuration)
 	{
-		NewBuff.EndTime = GetWorld()->GetTimeSeconds() + Buff.Duration;
-	}
+		NewBuff.EndTime = AStrategyGameState::GetWorldSimulationTime(GetWorld()) + Buff.Duration;
+		ActiveBuffs.HeapPush(NewBuff);
 
-	// add to active buffs
-	ActiveBuffs.Add(NewBuff);
+		// re-arm only if this buff expires first
+		if (ActiveBuffs.HeapTop().EndTime == NewBuff.EndTime)
+		{
+			ScheduleBuffExpiry();
+		}
+	}
 
 	// update to account for changes
 	UpdatePawnData();
@@ -307,32 +457,28 @@ void FBuffData::ApplyBuff(struct FPawnData& PawnData)
 	PawnData.Speed += BuffData.Speed;
 }
 
-void AStrategyChar::UpdatePawnData()
+void FBuffData::RemoveBuff(struct FPawnData& PawnData)
 {
-	const float CurrentTime = GetWorld()->GetTimeSeconds();
-	float TimeToNextUpdate = -1.f;
+	PawnData.AttackMin -= BuffData.AttackMin;
+	PawnData.AttackMax -= BuffData.AttackMax;
+	PawnData.DamageReduction -= BuffData.DamageReduction;
+	PawnData.HealthRegen -= BuffData.HealthRegen;
+	PawnData.MaxHealthBonus -= BuffData.MaxHealthBonus;
+	PawnData.Speed -= BuffData.Speed;
+}
 
+void AStrategyChar::UpdatePawnData()
+{
 	// start from existing base data
 	FPawnData NewPawnData = PawnData;
 
-	// add in influence of any active buffs
-	for (int32 i = 0; i < ActiveBuffs.Num(); i++)
-	{
-		// expired buff, clear it out
-		if (!ActiveBuffs[i].bInfiniteDuration && CurrentTime >= ActiveBuffs[i].EndTime)
-		{
-			ActiveBuffs.RemoveAt(i);
-			i--;
-			continue;
-		}
-
-		if (TimeToNextUpdate < 0 || TimeToNextUpdate > ActiveBuffs[i].EndTime - CurrentTime)
-		{
-			TimeToNextUpdate = ActiveBuffs[i].EndTime - CurrentTime;
-		}
-
-		ActiveBuffs[i].ApplyBuff(NewPawnData);
-	}
+	// add in influence of all active buffs, summed up as they are added and removed
+	NewPawnData.AttackMin += BuffDelta.AttackMin;
+	NewPawnData.AttackMax += BuffDelta.AttackMax;
+	NewPawnData.DamageReduction += BuffDelta.DamageReduction;
+	NewPawnData.HealthRegen += BuffDelta.HealthRegen;
+	NewPawnData.MaxHealthBonus += BuffDelta.MaxHealthBonus;
+	NewPawnData.Speed += BuffDelta.Speed;
 
 	// add influence of any attachments
 	UStrategyAttachment* const InvSlots[] = { WeaponSlot, ArmorSlot };
@@ -359,34 +505,55 @@ void AStrategyChar::UpdatePawnData()
 	// update groundspeed
 	if (GetCharacterMovement())
 	{
-		GetCharacterMovement()->MaxWalkSpeed = FMath::Max(0.0f, GetClass()->GetDefaultObject<AStrategyChar>()->GetCharacterMovement()->MaxWalkSpeed + NewPawnData.Speed);
+		GetCharacterMovement()->MaxWalkSpeed = FMath::Max(0.0f, FStrategyClassStatTable::GetStats(this, ClassStatsIndex).WalkSpeed + NewPawnData.Speed);
 	}
+}
+
+void AStrategyChar::OnBuffsExpired()
+{
+	const float CurrentTime = AStrategyGameState::GetWorldSimulationTime(GetWorld());
 
-	// update the buffs next time any expires, they are also updated when any buff is added
-	if (TimeToNextUpdate > 0.f)
+	// pop everything that's due, buffs can end within the same step
+	while (ActiveBuffs.Num() > 0 && CurrentTime >= ActiveBuffs.HeapTop().EndTime)
 	{
-		GetWorldTimerManager().SetTimer(TimerHandle_UpdatePawnData, this, &AStrategyChar::UpdatePawnData, TimeToNextUpdate, false);
+		FBuffData ExpiredBuff;
+		ActiveBuffs.HeapPop(ExpiredBuff, /*bAllowShrinking=*/false);
+		ExpiredBuff.RemoveBuff(BuffDelta);
 	}
+
+	UpdatePawnData();
+	ScheduleBuffExpiry();
 }
 
-void AStrategyChar::UpdateHealth()
+void AStrategyChar::ScheduleBuffExpiry()
 {
-	if ( (Health > 0.f) && (ModifiedPawnData.HealthRegen != 0.f) )
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState == nullptr)
 	{
-		if (ModifiedPawnData.HealthRegen < 0.f)
-		{
-			// negative health regen is a DoT, so do the damage
-			UGameplayStatics::ApplyDamage(this, -ModifiedPawnData.HealthRegen, Controller, this, UDamageType::StaticClass());
-		}
-		else
-		{
-			// add health regen
-			Health = FMath::Min<int32>(Health + ModifiedPawnData.HealthRegen, GetMaxHealth());
-		}
+		return;
+	}
+
+	// due exactly at end time of simulation, so the timer never fires before the buff can be popped
+	FStrategySimulationTimers& Timers = GameState->GetSimulationTimers();
+	if (ActiveBuffs.Num() > 0)
+	{
+		Timers.SetTimer(TimerHandle_BuffExpiry, FTimerDelegate::CreateUObject(this, &AStrategyChar::OnBuffsExpired), ActiveBuffs.HeapTop().EndTime);
 	}
+	else
+	{
+		Timers.ClearTimer(TimerHandle_BuffExpiry);
+	}
+}
 
-	// update again in 1 second
-	GetWorldTimerManager().SetTimer(TimerHandle_UpdateHealth, this, &AStrategyChar::UpdateHealth, 1.0f, false);
+void AStrategyChar::UpdateHealth()
+{
+	// regen itself is applied by the game state, once per second for all chars
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState)
+	{
+		GameState->GetHealthRegenSystem().UpdateChar(this);
+		GameState->OnCharDataChanged(this);
+	}
 }
 
 const struct FPawnData* AStrategyChar::GetPawnData() const
@@ -401,5 +568,5 @@ int32 AStrategyChar::GetHealth() const
 
 int32 AStrategyChar::GetMaxHealth() const
 {
-	return GetClass()->GetDefaultObject<AStrategyChar>()->GetHealth() + ModifiedPawnData.MaxHealthBonus;
+	return FStrategyClassStatTable::GetStats(this, ClassStatsIndex).Health + ModifiedPawnData.MaxHealthBonus;
 }
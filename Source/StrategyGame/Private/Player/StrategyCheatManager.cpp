@@ -2,9 +2,16 @@
 
 #include "StrategyGame.h"
 #include "StrategyCheatManager.h"
+#include "StrategyClassStatTable.h"
+#include "StrategyTeamTable.h"
+#include "StrategyTeamInterface.h"
+#include "StrategyBuilding.h"
+#include "StrategySnapshot.h"
+#include "StrategyInput.h"
 
 
 UStrategyCheatManager::UStrategyCheatManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+	, ReportedInputDrops(0)
 {
 }
 
@@ -17,6 +24,7 @@ void UStrategyCheatManager::AddGold(uint32 NewGold)
 	{
 		TeamData->ResourcesAvailable += NewGold;
 		TeamData->ResourcesGathered += NewGold;
+		MyGameState->NotifyResourcesChanged(EStrategyTeam::Player);
 
 		AStrategyPlayerController* MyPC = Cast<AStrategyPlayerController>(GetOuter());
 		if (MyPC)
@@ -26,3 +34,162 @@ void UStrategyCheatManager::AddGold(uint32 NewGold)
 		}
 	}
 }
+
+void UStrategyCheatManager::BenchmarkClassStats(int32 Iterations)
+{
+	// use classes of chars that are in the world, so both paths work on real data
+	TArray<UClass*> CharClasses;
+	for (AStrategyChar* const TestChar : FStrategyUnitRegistry::SlowActorRange<AStrategyChar>(GetWorld()))
+	{
+		CharClasses.AddUnique(TestChar->GetClass());
+	}
+	if (CharClasses.Num() == 0 || Iterations <= 0)
+	{
+		UE_LOG(LogGame, Warning, TEXT("BenchmarkClassStats: no chars in world"));
+		return;
+	}
+
+	TArray<int32> ClassIndices;
+	for (UClass* const CharClass : CharClasses)
+	{
+		ClassIndices.Add(FStrategyClassStatTable::GetClassIndex(CharClass));
+	}
+
+	// sums are logged so the loops can't be optimized away
+	float DefaultObjectSum = 0.0f;
+	const double DefaultObjectStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		DefaultObjectSum += CharClasses[i % CharClasses.Num()]->GetDefaultObject<AStrategyChar>()->GetHealth();
+	}
+	const double DefaultObjectTime = FPlatformTime::Seconds() - DefaultObjectStart;
+
+	float StatTableSum = 0.0f;
+	const double StatTableStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		StatTableSum += FStrategyClassStatTable::GetStats(ClassIndices[i % ClassIndices.Num()]).Health;
+	}
+	const double StatTableTime = FPlatformTime::Seconds() - StatTableStart;
+
+	const FString Str = FString::Printf(TEXT("BenchmarkClassStats: %d lookups, default object %.2f ns/call, stat table %.2f ns/call (checksum %.0f/%.0f)"),
+		Iterations, DefaultObjectTime * 1e9 / Iterations, StatTableTime * 1e9 / Iterations, DefaultObjectSum, StatTableSum);
+	UE_LOG(LogGame, Log, TEXT("%s"), *Str);
+
+	AStrategyPlayerController* MyPC = Cast<AStrategyPlayerController>(GetOuter());
+	if (MyPC)
+	{
+		MyPC->ClientMessage(Str);
+	}
+}
+
+/** enemy check as done before FStrategyTeamTable, kept for comparison */
+static bool OnEnemyTeamWithCasts(const AActor* ActorA, const AActor* ActorB)
+{
+	const IStrategyTeamInterface* TeamA = Cast<const IStrategyTeamInterface>(ActorA);
+	const IStrategyTeamInterface* TeamB = Cast<const IStrategyTeamInterface>(ActorB);
+
+	if( (TeamA != nullptr && TeamA->GetTeamNum() == EStrategyTeam::Unknown) || (TeamB != nullptr && TeamB->GetTeamNum() == EStrategyTeam::Unknown))
+		return false;
+
+	return (TeamA != nullptr) && (TeamB != nullptr) && (TeamA->GetTeamNum() != TeamB->GetTeamNum());
+}
+
+void UStrategyCheatManager::BenchmarkTeamLookup(int32 Iterations)
+{
+	// chars and buildings make up most of the pairs tested in game
+	TArray<AActor*> TeamActors;
+	for (AStrategyChar* const TestChar : FStrategyUnitRegistry::SlowActorRange<AStrategyChar>(GetWorld()))
+	{
+		TeamActors.Add(TestChar);
+	}
+	for (AStrategyBuilding* const TestBuilding : FStrategyUnitRegistry::SlowActorRange<AStrategyBuilding>(GetWorld()))
+	{
+		TeamActors.Add(TestBuilding);
+	}
+	if (TeamActors.Num() < 2 || Iterations <= 0)
+	{
+		UE_LOG(LogGame, Warning, TEXT("BenchmarkTeamLookup: need at least two chars or buildings in world"));
+		return;
+	}
+
+	const int32 NumActors = TeamActors.Num();
+	int32 CastEnemies = 0;
+	const double CastStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		CastEnemies += OnEnemyTeamWithCasts(TeamActors[i % NumActors], TeamActors[(i / NumActors) % NumActors]) ? 1 : 0;
+	}
+	const double CastTime = FPlatformTime::Seconds() - CastStart;
+
+	int32 TableEnemies = 0;
+	const double TableStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		TableEnemies += AStrategyGameMode::OnEnemyTeam(TeamActors[i % NumActors], TeamActors[(i / NumActors) % NumActors]) ? 1 : 0;
+	}
+	const double TableTime = FPlatformTime::Seconds() - TableStart;
+
+	const FString Str = FString::Printf(TEXT("BenchmarkTeamLookup: %d checks on %d actors, casts %.2f ns/call, team table %.2f ns/call (enemies %d/%d)"),
+		Iterations, NumActors, CastTime * 1e9 / Iterations, TableTime * 1e9 / Iterations, CastEnemies, TableEnemies);
+	UE_LOG(LogGame, Log, TEXT("%s"), *Str);
+
+	AStrategyPlayerController* MyPC = Cast<AStrategyPlayerController>(GetOuter());
+	if (MyPC)
+	{
+		MyPC->ClientMessage(Str);
+	}
+}
+
+/** @returns file of named snapshot */
+static FString GetSnapshotPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Snapshots") / Name + TEXT(".sgsnap");
+}
+
+void UStrategyCheatManager::SaveSnapshot(const FString& Name)
+{
+	AStrategyGameState* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
+	const FString Path = GetSnapshotPath(Name);
+	const bool bSaved = FStrategySnapshot::Save(MyGameState, Path);
+
+	AStrategyPlayerController* MyPC = Cast<AStrategyPlayerController>(GetOuter());
+	if (MyPC)
+	{
+		MyPC->ClientMessage(FString::Printf(TEXT("%s %s"), bSaved ? TEXT("Snapshot saved:") : TEXT("Can't save snapshot"), *Path));
+	}
+}
+
+void UStrategyCheatManager::LoadSnapshot(const FString& Name)
+{
+	AStrategyGameState* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
+	const FString Path = GetSnapshotPath(Name);
+	const bool bRestored = FStrategySnapshot::Restore(MyGameState, Path);
+
+	AStrategyPlayerController* MyPC = Cast<AStrategyPlayerController>(GetOuter());
+	if (MyPC)
+	{
+		MyPC->ClientMessage(FString::Printf(TEXT("%s %s"), bRestored ? TEXT("Snapshot restored:") : TEXT("Can't restore snapshot"), *Path));
+	}
+}
+
+void UStrategyCheatManager::InputLatency()
+{
+	AStrategyPlayerController* MyPC = Cast<AStrategyPlayerController>(GetOuter());
+	UStrategyInput* InputHandler = MyPC ? MyPC->GetInputHandler() : NULL;
+	if (InputHandler == NULL)
+	{
+		return;
+	}
+
+	const FStrategyInputLatency Latency = InputHandler->GetLatency();
+	InputHandler->ResetLatency();
+
+	const int32 NumDropped = InputHandler->GetNumDroppedEvents() - ReportedInputDrops;
+	ReportedInputDrops = InputHandler->GetNumDroppedEvents();
+
+	FString Str = FString::Printf(TEXT("InputLatency: %d events, avg %.3f ms, max %.3f ms, %d dropped"),
+		Latency.NumEvents, Latency.NumEvents > 0 ? Latency.TotalLatency * 1000.0 / Latency.NumEvents : 0.0, Latency.MaxLatency * 1000.0, NumDropped);
+	UE_LOG(LogGame, Log, TEXT("%s"), *Str);
+	MyPC->ClientMessage(Str);
+}
@@ -4,10 +4,58 @@
 #include "StrategyInput.h"
 
 
+FStrategyInputEventQueue::FStrategyInputEventQueue()
+	: Head(0)
+	, Tail(0)
+	, NumDropped(0)
+{
+}
+
+bool FStrategyInputEventQueue::Push(const FStrategyInputEvent& Event)
+{
+	const uint32 CurrentHead = Head.Load();
+	if (CurrentHead - Tail.Load() >= Capacity)
+	{
+		NumDropped++;
+		return false;
+	}
+
+	Events[CurrentHead & (Capacity - 1)] = Event;
+	Head.Store(CurrentHead + 1);
+	return true;
+}
+
+bool FStrategyInputEventQueue::Pop(FStrategyInputEvent& OutEvent)
+{
+	const uint32 CurrentTail = Tail.Load();
+	if (CurrentTail == Head.Load())
+	{
+		return false;
+	}
+
+	OutEvent = Events[CurrentTail & (Capacity - 1)];
+	Tail.Store(CurrentTail + 1);
+	return true;
+}
+
+int32 FStrategyInputEventQueue::Num() const
+{
+	return (int32)(Head.Load() - Tail.Load());
+}
+
 UStrategyInput::UStrategyInput(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, PrevTouchState(0)
 {
+	TouchInputTimes[0] = TouchInputTimes[1] = 0.0;
+}
+
+void UStrategyInput::NotifyTouchInput(uint32 Handle)
+{
+	if (Handle < ARRAY_COUNT(TouchInputTimes))
+	{
+		TouchInputTimes[Handle] = FPlatformTime::Seconds();
+	}
 }
 
 void UStrategyInput::UpdateDetection(float DeltaTime)
@@ -18,30 +66,87 @@ void UStrategyInput::UpdateDetection(float DeltaTime)
 
 void UStrategyInput::ProcessKeyStates(float DeltaTime)
 {
-	for (const FActionBinding1P& AB : ActionBindings1P)
+	// two point gestures wait for both touches, one point ones only use the first
+	const double DetectTime = FPlatformTime::Seconds();
+	const double OnePointInputTime = TouchInputTimes[0];
+	const double TwoPointsInputTime = FMath::Max(TouchInputTimes[0], TouchInputTimes[1]);
+
+	// every detected gesture goes through the queue
+	for (int32 KeyIdx = 0; KeyIdx < EGameKey::MAX; KeyIdx++)
+	{
+		const FSimpleKeyState& KeyState = KeyStates[KeyIdx];
+
+		for (int32 EventIdx = 0; EventIdx < ARRAY_COUNT(KeyState.Events); EventIdx++)
+		{
+			if (KeyState.Events[EventIdx] > 0)
+			{
+				FStrategyInputEvent Event;
+				Event.Key = (uint8)KeyIdx;
+				Event.Event = (uint8)EventIdx;
+				Event.Count = KeyState.Events[EventIdx];
+				Event.Position = KeyState.Position;
+				Event.Position2 = KeyState.Position2;
+				Event.DownTime = KeyState.DownTime;
+				Event.InputTime = (KeyIdx == EGameKey::SwipeTwoPoints || KeyIdx == EGameKey::Pinch) ? TwoPointsInputTime : OnePointInputTime;
+				Event.DetectTime = DetectTime;
+				Event.HandledTime = 0.0;
+
+				Events.Push(Event);
+			}
+		}
+	}
+
+	// drain into a table by key and event, so handlers run in bind order like they did before the queue
+	FStrategyInputEvent Detected[EGameKey::MAX][ARRAY_COUNT(FSimpleKeyState::Events)];
+	FMemory::Memzero(Detected, sizeof(Detected));
+
+	FStrategyInputEvent Event;
+	while (Events.Pop(Event))
 	{
-		const FSimpleKeyState* KeyState = KeyStateMap.Find(AB.Key);
+		Detected[Event.Key][Event.Event] = Event;
+	}
 
-		if (KeyState && KeyState->Events[AB.KeyEvent] > 0)
+	for (const FActionBinding1P& AB : ActionBindings1P)
+	{
+		const FStrategyInputEvent& BoundEvent = Detected[AB.Key][AB.KeyEvent];
+		if (BoundEvent.Count > 0)
 		{
-			AB.ActionDelegate.ExecuteIfBound(KeyState->Position, KeyState->DownTime);
+			AB.ActionDelegate.ExecuteIfBound(BoundEvent.Position, BoundEvent.DownTime);
 		}
 	}
 
 	for (const FActionBinding2P& AB : ActionBindings2P)
 	{
-		const FSimpleKeyState* KeyState = KeyStateMap.Find(AB.Key);
+		const FStrategyInputEvent& BoundEvent = Detected[AB.Key][AB.KeyEvent];
+		if (BoundEvent.Count > 0)
+		{
+			AB.ActionDelegate.ExecuteIfBound(BoundEvent.Position, BoundEvent.Position2, BoundEvent.DownTime);
+		}
+	}
 
-		if (KeyState && KeyState->Events[AB.KeyEvent] > 0)
+	// measure time from touch until actions of press and release gestures are done, held keys are just updates
+	const double HandledTime = FPlatformTime::Seconds();
+	for (int32 KeyIdx = 0; KeyIdx < EGameKey::MAX; KeyIdx++)
+	{
+		for (int32 EventIdx = 0; EventIdx < ARRAY_COUNT(FSimpleKeyState::Events); EventIdx++)
 		{
-			AB.ActionDelegate.ExecuteIfBound(KeyState->Position, KeyState->Position2, KeyState->DownTime);
+			const FStrategyInputEvent& HandledEvent = Detected[KeyIdx][EventIdx];
+
+			// gestures not driven by a touch yet (e.g. detection before first input) carry no arrival time
+			if (HandledEvent.Count > 0 && EventIdx != IE_Repeat && HandledEvent.InputTime > 0.0)
+			{
+				const double EventLatency = HandledTime - HandledEvent.InputTime;
+				Latency.TotalLatency += EventLatency;
+				Latency.MaxLatency = FMath::Max(Latency.MaxLatency, EventLatency);
+				Latency.NumEvents++;
+			}
 		}
 	}
 
 	// update states
-	for (TMap<EGameKey::Type,FSimpleKeyState>::TIterator It(KeyStateMap); It; ++It)
+	for (int32 KeyIdx = 0; KeyIdx < EGameKey::MAX; KeyIdx++)
 	{
-		FSimpleKeyState* const KeyState = &It.Value();
+		FSimpleKeyState* const KeyState = &KeyStates[KeyIdx];
 
 		if (KeyState->Events[IE_Pressed])
 		{
@@ -95,7 +200,7 @@ void UStrategyInput::DetectOnePointActions(bool bCurrentState, bool bPrevState,
 		}
 
 		// swipe detection & upkeep
-		FSimpleKeyState& SwipeState = KeyStateMap.FindOrAdd(EGameKey::Swipe);
+		FSimpleKeyState& SwipeState = KeyStates[EGameKey::Swipe];
 		if (SwipeState.bDown)
 		{
 			SwipeState.Events[IE_Repeat]++;
@@ -113,7 +218,7 @@ void UStrategyInput::DetectOnePointActions(bool bCurrentState, bool bPrevState,
 		// hold detection
 		if (DownTime + DeltaTime > HoldTime && DownTime <= HoldTime && !SwipeState.bDown)
 		{
-			FSimpleKeyState& HoldState = KeyStateMap.FindOrAdd(EGameKey::Hold);
+			FSimpleKeyState& HoldState = KeyStates[EGameKey::Hold];
 			HoldState.Events[IE_Pressed]++;
 			HoldState.Position = AnchorPosition;
 			HoldState.DownTime = DownTime;
@@ -129,14 +234,14 @@ void UStrategyInput::DetectOnePointActions(bool bCurrentState, bool bPrevState,
 			// tap detection
 			if (DownTime < HoldTime)
 			{
-				FSimpleKeyState& TapState = KeyStateMap.FindOrAdd(EGameKey::Tap);
+				FSimpleKeyState& TapState = KeyStates[EGameKey::Tap];
 				TapState.Events[IE_Pressed]++;
 				TapState.Position = AnchorPosition;
 				TapState.DownTime = DownTime;
 			}
 			else
 			{
-				FSimpleKeyState& HoldState = KeyStateMap.FindOrAdd(EGameKey::Hold);
+				FSimpleKeyState& HoldState = KeyStates[EGameKey::Hold];
 				if (HoldState.bDown)
 				{
 					HoldState.Events[IE_Released]++;
@@ -146,7 +251,7 @@ void UStrategyInput::DetectOnePointActions(bool bCurrentState, bool bPrevState,
 			}
 
 			// swipe finish
-			FSimpleKeyState& SwipeState = KeyStateMap.FindOrAdd(EGameKey::Swipe);
+			FSimpleKeyState& SwipeState = KeyStates[EGameKey::Swipe];
 			if (SwipeState.bDown)
 			{
 				SwipeState.Events[IE_Released]++;
@@ -177,14 +282,14 @@ void UStrategyInput::DetectTwoPointsActions(bool bCurrentState, bool bPrevState,
 			const float DistanceSq = (CurrentPosition1 - CurrentPosition2).SizeSquared();
 			if (DistanceSq < FMath::Square(MaxSwipeDistance))
 			{
-				FSimpleKeyState& SwipeState = KeyStateMap.FindOrAdd(EGameKey::SwipeTwoPoints);
+				FSimpleKeyState& SwipeState = KeyStates[EGameKey::SwipeTwoPoints];
 				SwipeState.Events[IE_Pressed]++;
 				SwipeState.Position = CurrentPosition1;
 				SwipeState.Position2 = CurrentPosition2;
 				SwipeState.DownTime = TwoPointsDownTime;
 			}
 
-			FSimpleKeyState& PinchState = KeyStateMap.FindOrAdd(EGameKey::Pinch);
+			FSimpleKeyState& PinchState = KeyStates[EGameKey::Pinch];
 			PinchState.Events[IE_Pressed]++;
 			PinchState.Position = CurrentPosition1;
 			PinchState.Position2 = CurrentPosition2;
@@ -198,7 +303,7 @@ void UStrategyInput::DetectTwoPointsActions(bool bCurrentState, bool bPrevState,
 		MaxPinchDistanceSq = FMath::Max(PinchDistanceSq, MaxPinchDistanceSq);
 
 		// finish swipe if distance changed before midpoint moved away from anchors
-		FSimpleKeyState& SwipeState = KeyStateMap.FindOrAdd(EGameKey::SwipeTwoPoints);
+		FSimpleKeyState& SwipeState = KeyStates[EGameKey::SwipeTwoPoints];
 		if (SwipeState.bDown)
 		{
 			bool bFinishSwipe = false;
@@ -215,7 +320,7 @@ void UStrategyInput::DetectTwoPointsActions(bool bCurrentState, bool bPrevState,
 		}
 
 		// finish pinch if midpoint moved away from anchors before any distance changed
-		FSimpleKeyState& PinchState = KeyStateMap.FindOrAdd(EGameKey::Pinch);
+		FSimpleKeyState& PinchState = KeyStates[EGameKey::Pinch];
 		if (PinchState.bDown)
 		{
 			bool bFinishPinch = false;
@@ -239,7 +344,7 @@ void UStrategyInput::DetectTwoPointsActions(bool bCurrentState, bool bPrevState,
 		if (bPrevState)
 		{
 			// swipe finish
-			FSimpleKeyState& SwipeState = KeyStateMap.FindOrAdd(EGameKey::SwipeTwoPoints);
+			FSimpleKeyState& SwipeState = KeyStates[EGameKey::SwipeTwoPoints];
 			if (SwipeState.bDown)
 			{
 				SwipeState.Events[IE_Released]++;
@@ -249,7 +354,7 @@ void UStrategyInput::DetectTwoPointsActions(bool bCurrentState, bool bPrevState,
 			}
 
 			// pinch finish
-			FSimpleKeyState& PinchState = KeyStateMap.FindOrAdd(EGameKey::Pinch);
+			FSimpleKeyState& PinchState = KeyStates[EGameKey::Pinch];
 			if (PinchState.bDown)
 			{
 				PinchState.Events[IE_Released]++;
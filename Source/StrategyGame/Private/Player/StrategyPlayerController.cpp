@@ -9,6 +9,7 @@
 #include "StrategySpectatorPawn.h"
 #include "StrategySelectionInterface.h"
 #include "StrategyInputInterface.h"
+#include "StrategyBuilding.h"
 
 
 AStrategyPlayerController::AStrategyPlayerController(const FObjectInitializer& ObjectInitializer)
@@ -59,15 +60,11 @@ void AStrategyPlayerController::GetAudioListenerPosition(FVector& OutLocation, F
 
 			float GroundLevel = MyGameState->MiniMapCamera->AudioListenerGroundLevel;
 			const FPlane GroundPlane = FPlane(FVector(0,0,GroundLevel), FVector::UpVector);
-			ULocalPlayer* const MyPlayer = Cast<ULocalPlayer>(Player);
 
-			// @todo: once PlayerCamera is back in, we can just get the ray origin and dir from that instead of
-			// needing to deproject. will be much simpler.
-			FVector RayOrigin, RayDirection;
+			FVector WorldPoint = FVector::ZeroVector;
 			FVector2D const ScreenCenterPoint = ScreenRes * 0.5f;
-			FStrategyHelpers::DeprojectScreenToWorld(ScreenCenterPoint, MyPlayer, RayOrigin, RayDirection);
+			GetViewProjection().DeprojectToPlane(ScreenCenterPoint, GroundPlane, WorldPoint);
 
-			FVector const WorldPoint = FStrategyHelpers::IntersectRayWithPlane(RayOrigin, RayDirection, GroundPlane);
 			FVector const AudioListenerOffset = MyGameState->MiniMapCamera->AudioListenerLocationOffset;
 			OutLocation = WorldPoint.GetClampedToSize(MyGameState->WorldBounds.Min.GetMin(), MyGameState->WorldBounds.Max.GetMax()) + AudioListenerOffset;
 
@@ -81,6 +78,12 @@ void AStrategyPlayerController::GetAudioListenerPosition(FVector& OutLocation, F
 	}
 }
 
+const FStrategyViewProjection& AStrategyPlayerController::GetViewProjection() const
+{
+	ViewProjection.Update(this);
+	return ViewProjection;
+}
+
 void AStrategyPlayerController::OnToggleInGameMenu()
 {
 	AStrategyHUD* const StrategyHUD = Cast<AStrategyHUD>(GetHUD());
@@ -103,6 +106,16 @@ void AStrategyPlayerController::UpdateRotation(float DeltaTime)
 	SetControlRotation(ViewRotation);
 }
 
+bool AStrategyPlayerController::InputTouch(uint32 Handle, ETouchType::Type Type, const FVector2D& TouchLocation, float Force, FDateTime DeviceTimestamp, uint32 TouchpadIndex)
+{
+	if (InputHandler)
+	{
+		InputHandler->NotifyTouchInput(Handle);
+	}
+
+	return Super::InputTouch(Handle, Type, TouchLocation, Force, DeviceTimestamp, TouchpadIndex);
+}
+
 void AStrategyPlayerController::ProcessPlayerInput(const float DeltaTime, const bool bGamePaused)
 {
 	if (!bGamePaused && PlayerInput && InputHandler && !bIgnoreInput)
@@ -114,28 +127,12 @@ void AStrategyPlayerController::ProcessPlayerInput(const float DeltaTime, const
 
 	if (!bIgnoreInput )
 	{
+		// areas covered by UI (minimap, action buttons, pause menu) are kept by the HUD and only change with its layout
 		const ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
 		AStrategySpectatorPawn* StrategyPawn = GetStrategySpectatorPawn();
-		if(( StrategyPawn != NULL ) && ( LocalPlayer != NULL ))
+		if(( StrategyPawn != NULL ) && ( LocalPlayer != NULL ) && ( LocalPlayer->ViewportClient != NULL ))
 		{
-			// Create the bounds for the minimap so we can add it as a 'no scroll' zone.
-			AStrategyHUD* const HUD = Cast<AStrategyHUD>(GetHUD());
-			AStrategyGameState const* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
-			if( (MyGameState != NULL ) && ( MyGameState->MiniMapCamera.IsValid() == true ) )
-			{
-				if( LocalPlayer->ViewportClient != NULL )
-				{
-					const FIntPoint ViewportSize = LocalPlayer->ViewportClient->Viewport->GetSizeXY();
-					const uint32 ViewTop = FMath::TruncToInt(LocalPlayer->Origin.Y * ViewportSize.Y);
-					const uint32 ViewBottom = ViewTop + FMath::TruncToInt(LocalPlayer->Size.Y * ViewportSize.Y);
-
-					FVector TopLeft( HUD->MiniMapMargin, ViewBottom - HUD->MiniMapMargin - MyGameState->MiniMapCamera->MiniMapHeight, 0 );
-					FVector BottomRight( (int32)MyGameState->MiniMapCamera->MiniMapWidth, MyGameState->MiniMapCamera->MiniMapHeight, 0 );
-					FBox MiniMapBounds( TopLeft, TopLeft + BottomRight );
-					StrategyPawn->GetStrategyCameraComponent()->AddNoScrollZone( MiniMapBounds );
-					StrategyPawn->GetStrategyCameraComponent()->UpdateCameraMovement( this );
-				}
-			}
+			StrategyPawn->GetStrategyCameraComponent()->UpdateCameraMovement( this );
 		}
 	}
 }
@@ -211,6 +208,13 @@ void AStrategyPlayerController::OnTapPressed(const FVector2D& ScreenPosition, fl
 	if (HitActor && HitActor->GetClass()->ImplementsInterface(UStrategyInputInterface::StaticClass()) )
 	{
 		IStrategyInputInterface::Execute_OnInputTap(HitActor);
+
+		// taps on buildings only open the action menu, upgrades are recorded on their own
+		AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+		if (GameState != nullptr && GameState->GetReplayRecorder() != nullptr && !HitActor->IsA<AStrategyBuilding>())
+		{
+			GameState->GetReplayRecorder()->RecordTap(GameState, HitActor);
+		}
 	}
 }
 
@@ -262,12 +266,10 @@ void AStrategyPlayerController::OnSwipeUpdate(const FVector2D& ScreenPosition, f
 	AActor* const Selected = SelectedActor.Get();
 	if ( Selected && Selected->GetClass()->ImplementsInterface(UStrategyInputInterface::StaticClass()) )
 	{
-		ULocalPlayer* const MyPlayer =  Cast<ULocalPlayer>(Player);
 		const FPlane GroundPlane = FPlane(FVector(0, 0, SelectedActor->GetActorLocation().Z), FVector(0,0,1));
 
-		FVector RayOrigin, RayDirection;
-		FStrategyHelpers::DeprojectScreenToWorld(ScreenPosition, MyPlayer, RayOrigin, RayDirection);
-		const FVector ScreenPosition3D = FStrategyHelpers::IntersectRayWithPlane(RayOrigin, RayDirection, GroundPlane);
+		FVector ScreenPosition3D = SwipeAnchor3D;
+		GetViewProjection().DeprojectToPlane(ScreenPosition, GroundPlane, ScreenPosition3D);
 
 		IStrategyInputInterface::Execute_OnInputSwipeUpdate(Selected, ScreenPosition3D - SwipeAnchor3D);
 	}
@@ -287,12 +289,10 @@ void AStrategyPlayerController::OnSwipeReleased(const FVector2D& ScreenPosition,
 	AActor* const Selected = SelectedActor.Get();
 	if ( Selected && Selected->GetClass()->ImplementsInterface(UStrategyInputInterface::StaticClass()) )
 	{
-		ULocalPlayer* const MyPlayer =  Cast<ULocalPlayer>(this->Player);
 		const FPlane GroundPlane = FPlane(FVector(0, 0, SelectedActor->GetActorLocation().Z), FVector(0,0,1));
 
-		FVector RayOrigin, RayDirection;
-		FStrategyHelpers::DeprojectScreenToWorld(ScreenPosition, MyPlayer, RayOrigin, RayDirection);
-		const FVector ScreenPosition3D = FStrategyHelpers::IntersectRayWithPlane(RayOrigin, RayDirection, GroundPlane);
+		FVector ScreenPosition3D = SwipeAnchor3D;
+		GetViewProjection().DeprojectToPlane(ScreenPosition, GroundPlane, ScreenPosition3D);
 
 		IStrategyInputInterface::Execute_OnInputSwipeReleased(Selected, ScreenPosition3D - SwipeAnchor3D, DownTime);
 	}
@@ -0,0 +1,79 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyViewProjection.h"
+#include "StrategyHelpers.h"
+
+FStrategyViewProjection::FStrategyViewProjection()
+	: InvViewProjectionMatrix(FMatrix::Identity)
+	, ViewRect(0, 0, 0, 0)
+	, CameraLocation(FVector::ZeroVector)
+	, CameraRotation(FRotator::ZeroRotator)
+	, CameraFOV(-1.0f)
+	, ViewportSize(0, 0)
+	, Revision(0)
+	, bValid(false)
+{
+}
+
+bool FStrategyViewProjection::Update(const APlayerController* PlayerController)
+{
+	ULocalPlayer* const Player = PlayerController ? Cast<ULocalPlayer>(PlayerController->Player) : NULL;
+	const APlayerCameraManager* const CameraManager = PlayerController ? PlayerController->PlayerCameraManager : NULL;
+	if (Player == NULL || Player->ViewportClient == NULL || Player->ViewportClient->Viewport == NULL || CameraManager == NULL)
+	{
+		bValid = false;
+		return false;
+	}
+
+	FViewport* const Viewport = Player->ViewportClient->Viewport;
+	const FVector NewLocation = CameraManager->GetCameraLocation();
+	const FRotator NewRotation = CameraManager->GetCameraRotation();
+	const float NewFOV = CameraManager->GetFOVAngle();
+	const FIntPoint NewViewportSize = Viewport->GetSizeXY();
+	if (bValid && NewLocation == CameraLocation && NewRotation == CameraRotation && NewFOV == CameraFOV && NewViewportSize == ViewportSize)
+	{
+		return true;
+	}
+
+	FSceneViewProjectionData ProjectionData;
+	bValid = Player->GetProjectionData(Viewport, eSSP_FULL, ProjectionData);
+	if (bValid)
+	{
+		InvViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix().InverseFast();
+		ViewRect = ProjectionData.GetConstrainedViewRect();
+		CameraLocation = NewLocation;
+		CameraRotation = NewRotation;
+		CameraFOV = NewFOV;
+		ViewportSize = NewViewportSize;
+		Revision++;
+	}
+	return bValid;
+}
+
+bool FStrategyViewProjection::Deproject(const FVector2D& ScreenPosition, FVector& RayOrigin, FVector& RayDirection) const
+{
+	if (!bValid)
+	{
+		return false;
+	}
+
+	FSceneView::DeprojectScreenToWorld(ScreenPosition, ViewRect, InvViewProjectionMatrix, /*out*/ RayOrigin, /*out*/ RayDirection);
+	return true;
+}
+
+bool FStrategyViewProjection::DeprojectToPlane(const FVector2D* ScreenPositions, int32 NumPositions, const FPlane& Plane, FVector* OutPoints) const
+{
+	if (!bValid)
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < NumPositions; Index++)
+	{
+		FVector RayOrigin, RayDirection;
+		FSceneView::DeprojectScreenToWorld(ScreenPositions[Index], ViewRect, InvViewProjectionMatrix, /*out*/ RayOrigin, /*out*/ RayDirection);
+		OutPoints[Index] = FStrategyHelpers::IntersectRayWithPlane(RayOrigin, RayDirection, Plane);
+	}
+	return true;
+}
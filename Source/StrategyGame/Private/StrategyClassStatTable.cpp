@@ -0,0 +1,121 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyClassStatTable.h"
+#include "StrategyBuilding.h"
+#include "StrategyResourceNode.h"
+
+TArray<FStrategyClassStats> FStrategyClassStatTable::Stats;
+TArray<TWeakObjectPtr<UClass>> FStrategyClassStatTable::Classes;
+TMap<const UClass*, int32> FStrategyClassStatTable::ClassIndices;
+FDelegateHandle FStrategyClassStatTable::ObjectsReplacedHandle;
+FDelegateHandle FStrategyClassStatTable::PostWorldCleanupHandle;
+
+void FStrategyClassStatTable::Initialize()
+{
+#if WITH_EDITOR
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddStatic(&FStrategyClassStatTable::OnObjectsReplaced);
+#endif
+	PostWorldCleanupHandle = FWorldDelegates::OnPostWorldCleanup.AddStatic(&FStrategyClassStatTable::OnPostWorldCleanup);
+}
+
+void FStrategyClassStatTable::Shutdown()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+#endif
+	FWorldDelegates::OnPostWorldCleanup.Remove(PostWorldCleanupHandle);
+}
+
+void FStrategyClassStatTable::RefreshStats()
+{
+	for (int32 Index = 0; Index < Classes.Num(); Index++)
+	{
+		UClass* const Class = Classes[Index].Get();
+		if (Class)
+		{
+			Stats[Index] = FStrategyClassStats();
+			ReadStats(Class, Stats[Index]);
+		}
+	}
+}
+
+int32 FStrategyClassStatTable::GetClassIndex(UClass* InClass)
+{
+	check(InClass);
+
+	const int32* FoundIndex = ClassIndices.Find(InClass);
+	if (FoundIndex != nullptr && Classes[*FoundIndex].Get() == InClass)
+	{
+		return *FoundIndex;
+	}
+
+	// new class, or old one was unloaded and its address reused (e.g. blueprint recompile)
+	const int32 NewIndex = Stats.AddDefaulted();
+	Classes.Add(InClass);
+	ReadStats(InClass, Stats[NewIndex]);
+	ClassIndices.Add(InClass, NewIndex);
+
+	return NewIndex;
+}
+
+const FStrategyClassStats& FStrategyClassStatTable::GetStats(int32 ClassIndex)
+{
+	return Stats[ClassIndex];
+}
+
+const FStrategyClassStats& FStrategyClassStatTable::GetStats(UClass* InClass)
+{
+	return Stats[GetClassIndex(InClass)];
+}
+
+const FStrategyClassStats& FStrategyClassStatTable::GetStats(const UObject* InObject, int32& InOutIndex)
+{
+	if (InOutIndex == INDEX_NONE)
+	{
+		InOutIndex = GetClassIndex(InObject->GetClass());
+	}
+	return Stats[InOutIndex];
+}
+
+void FStrategyClassStatTable::ReadStats(UClass* InClass, FStrategyClassStats& OutStats)
+{
+	const UObject* const DefaultObject = InClass->GetDefaultObject();
+
+	const AStrategyChar* const DefChar = Cast<const AStrategyChar>(DefaultObject);
+	if (DefChar)
+	{
+		OutStats.Health = DefChar->GetHealth();
+		if (DefChar->GetCharacterMovement())
+		{
+			OutStats.WalkSpeed = DefChar->GetCharacterMovement()->MaxWalkSpeed;
+		}
+		if (DefChar->GetCapsuleComponent())
+		{
+			OutStats.CapsuleRadius = DefChar->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+			OutStats.CapsuleHalfHeight = DefChar->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+		}
+	}
+
+	const AStrategyBuilding* const DefBuilding = Cast<const AStrategyBuilding>(DefaultObject);
+	if (DefBuilding)
+	{
+		OutStats.Health = DefBuilding->GetHealth();
+	}
+
+	const AStrategyResourceNode* const DefResourceNode = Cast<const AStrategyResourceNode>(DefaultObject);
+	if (DefResourceNode)
+	{
+		OutStats.Resources = DefResourceNode->GetAvailableResources();
+	}
+}
+
+void FStrategyClassStatTable::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	RefreshStats();
+}
+
+void FStrategyClassStatTable::OnPostWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	RefreshStats();
+}
@@ -0,0 +1,202 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyDamageQueue.h"
+#include "StrategyTeamTable.h"
+
+void FStrategyDamageQueue::QueuePointDamage(AActor* Victim, float Damage, uint8 InstigatorTeam, const FVector& HitDirection, const FHitResult& HitInfo, AController* Instigator, AActor* Causer)
+{
+	if (Victim == nullptr || Damage <= 0.f)
+	{
+		return;
+	}
+
+	const AStrategyChar* const VictimChar = Cast<AStrategyChar>(Victim);
+	if (VictimChar)
+	{
+		AddPending(VictimChar, Damage, InstigatorTeam);
+	}
+
+	Victims.Add(Victim);
+	Damages.Add(Damage);
+	InstigatorTeams.Add(InstigatorTeam);
+	Flags.Add(VictimChar ? Flag_Char : 0);
+	HitDirections.Add(HitDirection);
+	HitInfos.Add(HitInfo);
+	Instigators.Add(Instigator);
+	Causers.Add(Causer);
+}
+
+void FStrategyDamageQueue::QueueDamageOverTime(AStrategyChar* Victim, float Damage)
+{
+	if (Victim == nullptr || Damage <= 0.f)
+	{
+		return;
+	}
+
+	// nobody instigates it, so friendly fire check doesn't apply and only damage reduction does
+	AddPending(Victim, Damage, FStrategyTeamTable::NoTeam);
+
+	Victims.Add(Victim);
+	Damages.Add(Damage);
+	InstigatorTeams.Add(FStrategyTeamTable::NoTeam);
+	Flags.Add(Flag_Char | Flag_DamageOverTime);
+	HitDirections.Add(FVector::ZeroVector);
+	HitInfos.AddDefaulted();
+	Instigators.AddDefaulted();
+	Causers.Add(Victim);
+}
+
+float FStrategyDamageQueue::ResolveDamage(float Damage, uint8 InstigatorTeam, uint8 VictimTeam, float DamageReduction)
+{
+	// skip friendly fire
+	if (InstigatorTeam != FStrategyTeamTable::NoTeam && VictimTeam != FStrategyTeamTable::NoTeam && InstigatorTeam == VictimTeam)
+	{
+		return 0.f;
+	}
+
+	// pawn's damage reduction
+	return Damage - DamageReduction;
+}
+
+float FStrategyDamageQueue::PredictDamage(const AActor* Victim, float Damage, uint8 InstigatorTeam) const
+{
+	const AStrategyChar* const VictimChar = Cast<AStrategyChar>(Victim);
+	if (VictimChar == nullptr)
+	{
+		return 0.f;
+	}
+
+	// health left once hits already queued this step are applied
+	const float* const Pending = PendingDamage.Find(VictimChar);
+	const float HealthLeft = VictimChar->Health - (Pending ? *Pending : 0.f);
+	if (HealthLeft <= 0.f)
+	{
+		return 0.f;
+	}
+
+	const float Resolved = ResolveDamage(Damage, InstigatorTeam, VictimChar->GetTeamNum(), VictimChar->GetPawnData()->DamageReduction);
+	return FMath::Clamp(Resolved, 0.f, HealthLeft);
+}
+
+void FStrategyDamageQueue::AddPending(const AStrategyChar* Victim, float Damage, uint8 InstigatorTeam)
+{
+	const float Resolved = ResolveDamage(Damage, InstigatorTeam, Victim->GetTeamNum(), Victim->GetPawnData()->DamageReduction);
+	if (Resolved > 0.f)
+	{
+		PendingDamage.FindOrAdd(Victim) += Resolved;
+	}
+}
+
+void FStrategyDamageQueue::Flush(AStrategyGameState* GameState)
+{
+	// damage events may queue more damage, that goes to the next frame
+	const int32 NumEntries = Victims.Num();
+	if (NumEntries == 0)
+	{
+		return;
+	}
+
+	// no health changes after game is finished
+	if (GameState->GameplayState == EGameplayState::Finished)
+	{
+		PendingDamage.Reset();
+		RemoveFirst(NumEntries);
+		return;
+	}
+
+	// resolve pass: teams and damage reduction come from unit registry's published arrays,
+	// chars spawned since last publish fall back to their own data
+	const FStrategyUnitRegistry& Registry = GameState->GetUnitRegistry();
+	const TArray<AStrategyChar*>& RegistryChars = Registry.GetChars();
+	const TArray<uint8>& RegistryTeams = Registry.GetTeams();
+	const TArray<float>& RegistryDamageReduction = Registry.GetDamageReduction();
+
+	ResolvedDamages.Reset(NumEntries);
+	for (int32 i = 0; i < NumEntries; i++)
+	{
+		if ((Flags[i] & Flag_Char) == 0)
+		{
+			ResolvedDamages.Add(Damages[i]);
+			continue;
+		}
+
+		const AStrategyChar* const VictimChar = static_cast<const AStrategyChar*>(Victims[i].Get());
+		const int32 UnitIndex = VictimChar ? VictimChar->GetUnitRegistryIndex() : INDEX_NONE;
+		if (RegistryChars.IsValidIndex(UnitIndex) && RegistryChars[UnitIndex] == VictimChar)
+		{
+			ResolvedDamages.Add(ResolveDamage(Damages[i], InstigatorTeams[i], RegistryTeams[UnitIndex], RegistryDamageReduction[UnitIndex]));
+		}
+		else
+		{
+			ResolvedDamages.Add(VictimChar ? ResolveDamage(Damages[i], InstigatorTeams[i], VictimChar->GetTeamNum(), VictimChar->GetPawnData()->DamageReduction) : 0.f);
+		}
+	}
+
+	// damage queued by events during apply pass is pending for the next flush
+	PendingDamage.Reset();
+
+	// apply pass, in queue order
+	for (int32 i = 0; i < NumEntries; i++)
+	{
+		AActor* const Victim = Victims[i].Get();
+		if (Victim == nullptr || ResolvedDamages[i] <= 0.f)
+		{
+			continue;
+		}
+
+		AStrategyChar* const VictimChar = (Flags[i] & Flag_Char) ? static_cast<AStrategyChar*>(Victim) : nullptr;
+		if (VictimChar == nullptr)
+		{
+			// not ours to resolve, let the actor handle it
+			UGameplayStatics::ApplyPointDamage(Victim, ResolvedDamages[i], HitDirections[i], HitInfos[i], Instigators[i].Get(), Causers[i].Get(), UDamageType::StaticClass());
+		}
+		else if (Flags[i] & Flag_DamageOverTime)
+		{
+			VictimChar->ApplyResolvedDamage(ResolvedDamages[i], FDamageEvent(UDamageType::StaticClass()), Instigators[i].Get(), Causers[i].Get());
+		}
+		else
+		{
+			const FPointDamageEvent DamageEvent(Damages[i], HitInfos[i], HitDirections[i], UDamageType::StaticClass());
+			VictimChar->ApplyResolvedDamage(ResolvedDamages[i], DamageEvent, Instigators[i].Get(), Causers[i].Get());
+		}
+	}
+
+	RemoveFirst(NumEntries);
+}
+
+int32 FStrategyDamageQueue::Num() const
+{
+	return Victims.Num();
+}
+
+void FStrategyDamageQueue::RemoveFirst(int32 Count)
+{
+	if (Count == Victims.Num())
+	{
+		Reset();
+		return;
+	}
+
+	Victims.RemoveAt(0, Count, false);
+	Damages.RemoveAt(0, Count, false);
+	InstigatorTeams.RemoveAt(0, Count, false);
+	Flags.RemoveAt(0, Count, false);
+	HitDirections.RemoveAt(0, Count, false);
+	HitInfos.RemoveAt(0, Count, false);
+	Instigators.RemoveAt(0, Count, false);
+	Causers.RemoveAt(0, Count, false);
+}
+
+void FStrategyDamageQueue::Reset()
+{
+	PendingDamage.Reset();
+	Victims.Reset();
+	Damages.Reset();
+	InstigatorTeams.Reset();
+	Flags.Reset();
+	HitDirections.Reset();
+	HitInfos.Reset();
+	Instigators.Reset();
+	Causers.Reset();
+}
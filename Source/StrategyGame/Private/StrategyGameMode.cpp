@@ -4,6 +4,9 @@
 #include "StrategyBuilding.h"
 #include "StrategySpectatorPawn.h"
 #include "StrategyTeamInterface.h"
+#include "StrategyTeamTable.h"
+#include "StrategyPreloader.h"
+#include "StrategyStartupTrace.h"
 
 
 AStrategyGameMode::AStrategyGameMode(const FObjectInitializer& ObjectInitializer)
@@ -34,6 +37,8 @@ const FString AStrategyGameMode::DifficultyOptionName(TEXT("Difficulty"));
 
 void AStrategyGameMode::InitGameState()
 {
+	FStrategyStartupScope StartupScope(TEXT("InitGameState"));
+
 	Super::InitGameState();
 
 	AStrategyGameState* const StrategyGameState = GetGameState<AStrategyGameState>();
@@ -47,6 +52,13 @@ void AStrategyGameMode::InitGameState()
 	}
 }
 
+void AStrategyGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	UStrategyPreloader::Get()->Release();
+}
+
 void AStrategyGameMode::RestartPlayer(AController* NewPlayer)
 {
 	AActor* const StartSpot = FindPlayerStart(NewPlayer);
@@ -77,15 +89,15 @@ float AStrategyGameMode::ModifyDamage(float Damage, AActor* DamagedActor, struct
 
 	if (Damage > 0.f)
 	{
-		const IStrategyTeamInterface* VictimTeam = Cast<IStrategyTeamInterface>(DamagedActor);
-		IStrategyTeamInterface* InstigatorTeam = Cast<IStrategyTeamInterface>(EventInstigator);
-		if (InstigatorTeam == nullptr)
+		const uint8 VictimTeam = FStrategyTeamTable::GetTeam(DamagedActor);
+		uint8 InstigatorTeam = FStrategyTeamTable::GetTeam(EventInstigator);
+		if (InstigatorTeam == FStrategyTeamTable::NoTeam)
 		{
-			InstigatorTeam = Cast<IStrategyTeamInterface>(DamageCauser);
+			InstigatorTeam = FStrategyTeamTable::GetTeam(DamageCauser);
 		}
 
 		// skip friendly fire
-		if (InstigatorTeam && VictimTeam && InstigatorTeam->GetTeamNum() == VictimTeam->GetTeamNum())
+		if (InstigatorTeam != FStrategyTeamTable::NoTeam && VictimTeam != FStrategyTeamTable::NoTeam && InstigatorTeam == VictimTeam)
 		{
 			return 0.0f;
 		}
@@ -126,24 +138,12 @@ void AStrategyGameMode::ReturnToMenu()
 
 bool AStrategyGameMode::OnFriendlyTeam(const AActor* ActorA, const AActor* ActorB)
 {
-	const IStrategyTeamInterface* TeamA = Cast<const IStrategyTeamInterface>(ActorA);
-	const IStrategyTeamInterface* TeamB = Cast<const IStrategyTeamInterface>(ActorB);
-
-	if( (TeamA != nullptr && TeamA->GetTeamNum() == EStrategyTeam::Unknown) || (TeamB != nullptr && TeamB->GetTeamNum() == EStrategyTeam::Unknown))
-		return true;
-
-	return (TeamA != nullptr) && (TeamB != nullptr) && (TeamA->GetTeamNum() == TeamB->GetTeamNum());
+	return FStrategyTeamTable::IsFriendly(FStrategyTeamTable::GetTeam(ActorA), FStrategyTeamTable::GetTeam(ActorB));
 }
 
 bool AStrategyGameMode::OnEnemyTeam(const AActor* ActorA, const AActor* ActorB)
 {
-	const IStrategyTeamInterface* TeamA = Cast<const IStrategyTeamInterface>(ActorA);
-	const IStrategyTeamInterface* TeamB = Cast<const IStrategyTeamInterface>(ActorB);
-
-	if( (TeamA != nullptr && TeamA->GetTeamNum() == EStrategyTeam::Unknown) || (TeamB != nullptr && TeamB->GetTeamNum() == EStrategyTeam::Unknown))
-		return false;
-
-	return (TeamA != nullptr) && (TeamB != nullptr) && (TeamA->GetTeamNum() != TeamB->GetTeamNum());
+	return FStrategyTeamTable::IsEnemy(FStrategyTeamTable::GetTeam(ActorA), FStrategyTeamTable::GetTeam(ActorB));
 }
 
 
@@ -5,6 +5,9 @@
 #include "StrategyHUDSoundsWidgetStyle.h"
 #include "StrategyHUDWidgetStyle.h"
 #include "StrategyMenuWidgetStyle.h"
+#include "StrategyStartupTrace.h"
+#include "StrategyClassStatTable.h"
+#include "StrategyGameLoadingScreen.h"
 
 
 
@@ -12,6 +15,21 @@ class FStrategyGameModule : public FDefaultGameModuleImpl
 {
 	virtual void StartupModule() override
 	{
+		FStrategyStartupTrace::Initialize();
+
+		// loading screen module starts first and can't see the trace, so its timing is picked up here
+		double LoadingScreenStart = 0.0;
+		double LoadingScreenEnd = 0.0;
+		IStrategyGameLoadingScreenModule* const LoadingScreenModule = FModuleManager::GetModulePtr<IStrategyGameLoadingScreenModule>("StrategyGameLoadingScreen");
+		if (LoadingScreenModule && LoadingScreenModule->GetStartupTime(LoadingScreenStart, LoadingScreenEnd))
+		{
+			FStrategyStartupTrace::AddPhase(TEXT("LoadingScreenModule"), LoadingScreenStart, LoadingScreenEnd);
+		}
+
+		FStrategyStartupScope StartupScope(TEXT("GameModule"));
+
+		FStrategyClassStatTable::Initialize();
+
 		//Hot reload hack
 		FSlateStyleRegistry::UnRegisterSlateStyle(FStrategyStyle::GetStyleSetName());
 		FStrategyStyle::Initialize();
@@ -20,9 +38,14 @@ class FStrategyGameModule : public FDefaultGameModuleImpl
 	virtual void ShutdownModule() override
 	{
 		FStrategyStyle::Shutdown();
+		FStrategyClassStatTable::Shutdown();
+		FStrategyStartupTrace::Shutdown();
 	}
 };
 
 IMPLEMENT_PRIMARY_GAME_MODULE(FStrategyGameModule, StrategyGame, "StrategyGame");
 
 DEFINE_LOG_CATEGORY(LogGame)
+
+DEFINE_STAT(STAT_StrategyHUDAttributeEvaluations);
+DEFINE_STAT(STAT_StrategyHUDTextBuilds);
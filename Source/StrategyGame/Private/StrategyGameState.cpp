@@ -2,46 +2,69 @@
 
 #include "StrategyGame.h"
 #include "StrategyBuilding_Brewery.h"
+#include "StrategyAIDirector.h"
 #include "StrategyTypes.h"
+#include "StrategyAISensingComponent.h"
 
 AStrategyGameState::AStrategyGameState(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	// drives health regen and damage, after all units are done for the frame
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
 	// team data for: unknown, player, enemy
 	PlayersData.AddZeroed(EStrategyTeam::MAX);
 	MiniMapCamera = nullptr;
 	WinningTeam = EStrategyTeam::Unknown;
 	GameFinishedTime = 0;
+	UnitGridCellSize = 512.0f;
+	bUseSpatialMeleeQuery = true;
+	UnitSpatialIndexFrame = 0;
+	VisibilityCellSize = 256.0f;
+	BuildingSightRadius = 800.0f;
+	VisibilityGridFrame = 0;
+	BuildingsRevision = 0;
+	bUseFixedSimulationStep = false;
+	SimulationStep = 1.0f / 30.0f;
+	MatchSeed = 0;
 }
 
 int32 AStrategyGameState::GetNumberOfLivePawns(TEnumAsByte<EStrategyTeam::Type> InTeam) const
 {
-	return LivePawnCounter[InTeam];
+	return GetUnitRegistry().GetNumLive(InTeam);
 }
 
 void AStrategyGameState::AddChar(AStrategyChar* InChar)
 {
-	if (InChar != nullptr)
-	{
-		LivePawnCounter[InChar->GetTeamNum()]++;
-	}
+	UnitRegistry.AddChar(InChar);
 }
 
 void AStrategyGameState::RemoveChar(AStrategyChar* InChar)
 {
-	if (InChar != nullptr)
-	{
-		LivePawnCounter[InChar->GetTeamNum()]--;
-	}
+	UnitRegistry.RemoveChar(InChar);
 }
 
 void AStrategyGameState::OnCharDied(AStrategyChar* InChar)
 {
-	if ( InChar && (InChar->GetTeamNum() == EStrategyTeam::Enemy) )
+	if (InChar == nullptr)
+	{
+		return;
+	}
+
+	// player gets paid for dead enemies
+	if (InChar->GetTeamNum() == EStrategyTeam::Enemy)
 	{
 		PlayersData[EStrategyTeam::Player].ResourcesAvailable += InChar->ResourcesToGather;
-		RemoveChar(InChar);
+		NotifyResourcesChanged(EStrategyTeam::Player);
 	}
+	RemoveChar(InChar);
+}
+
+void AStrategyGameState::OnCharRemoved(AStrategyChar* InChar)
+{
+	RemoveChar(InChar);
 }
 
 void AStrategyGameState::OnActorDamaged(AActor* InActor, float Damage, AController* EventInstigator)
@@ -65,6 +88,258 @@ void AStrategyGameState::OnCharSpawned(AStrategyChar* InChar)
 	}
 }
 
+void AStrategyGameState::OnCharDataChanged(AStrategyChar* InChar)
+{
+	UnitRegistry.RefreshChar(InChar);
+}
+
+void AStrategyGameState::Tick(float DeltaSeconds)
+{
+	FStrategyPerFrameScope PerFrameScope;
+
+	Super::Tick(DeltaSeconds);
+
+	const double SystemsStart = FPlatformTime::Seconds();
+	const int32 NumSteps = SimulationClock.Advance(DeltaSeconds);
+	for (int32 i = 0; i < NumSteps; i++)
+	{
+		if (ReplayPlayer.IsValid())
+		{
+			ReplayPlayer->OnPreStep(this);
+		}
+
+		StepSimulation(SimulationClock.GetStepDelta());
+
+		if (ReplayRecorder.IsValid())
+		{
+			ReplayRecorder->OnStep(this);
+		}
+		if (ReplayPlayer.IsValid())
+		{
+			ReplayPlayer->OnPostStep(this);
+		}
+	}
+
+	if (ReplayRecorder.IsValid())
+	{
+		ReplayRecorder->WaitForRealTime(this);
+	}
+
+	if (ReplayPlayer.IsValid() && (ReplayPlayer->IsFinished() || ReplayPlayer->HasDiverged()))
+	{
+		UE_LOG(LogGame, Log, TEXT("Replay %s at step %lld"), ReplayPlayer->HasDiverged() ? TEXT("diverged") : TEXT("finished in sync"), SimulationClock.GetStepCount());
+		ReplayPlayer.Reset();
+		if (FApp::IsUnattended())
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+
+	if (MatchSimulation.IsValid())
+	{
+		MatchSimulation->Tick(DeltaSeconds, FPlatformTime::Seconds() - SystemsStart);
+	}
+}
+
+void AStrategyGameState::StepSimulation(float StepDelta)
+{
+	ConstructionScheduler.FinishExpiredBuilds(SimulationClock.GetTime());
+	SimulationTimers.Tick(SimulationClock.GetTime());
+
+	// spawn pacing is checked every step in team order, not whenever directors happen to tick
+	for (const FPlayerData& TeamData : PlayersData)
+	{
+		AStrategyBuilding_Brewery* const Brewery = TeamData.Brewery.Get();
+		UStrategyAIDirector* const Director = Brewery ? Brewery->GetAIDirector() : nullptr;
+		if (Director != nullptr && Director->IsActive())
+		{
+			Director->SpawnMinions();
+		}
+	}
+
+	HealthRegenSystem.Tick(StepDelta, DamageQueue);
+	DamageQueue.Flush(this);
+}
+
+void AStrategyGameState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// match left before it was over still gets its replay
+	if (ReplayRecorder.IsValid())
+	{
+		ReplayRecorder->Finish(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float AStrategyGameState::GetSimulationTime() const
+{
+	return SimulationClock.GetTime();
+}
+
+float AStrategyGameState::GetInterpolatedTime() const
+{
+	return SimulationClock.GetInterpolatedTime();
+}
+
+FRandomStream& AStrategyGameState::GetRandomStream()
+{
+	return SimulationClock.GetRandom();
+}
+
+const FStrategySimulationClock& AStrategyGameState::GetSimulationClock() const
+{
+	return SimulationClock;
+}
+
+FStrategySimulationTimers& AStrategyGameState::GetSimulationTimers()
+{
+	return SimulationTimers;
+}
+
+FStrategyReplayRecorder* AStrategyGameState::GetReplayRecorder() const
+{
+	return ReplayRecorder.Get();
+}
+
+float AStrategyGameState::GetWorldSimulationTime(const UWorld* World)
+{
+	const AStrategyGameState* const GameState = World ? World->GetGameState<AStrategyGameState>() : nullptr;
+	if (GameState != nullptr)
+	{
+		return GameState->GetSimulationTime();
+	}
+	return World ? World->GetTimeSeconds() : 0.0f;
+}
+
+FRandomStream& AStrategyGameState::GetWorldRandomStream(const UWorld* World)
+{
+	AStrategyGameState* const GameState = World ? World->GetGameState<AStrategyGameState>() : nullptr;
+	if (GameState != nullptr)
+	{
+		return GameState->GetRandomStream();
+	}
+
+	static FRandomStream FallbackStream(0);
+	return FallbackStream;
+}
+
+FStrategyDamageQueue& AStrategyGameState::GetDamageQueue()
+{
+	return DamageQueue;
+}
+
+FStrategyHealthRegenSystem& AStrategyGameState::GetHealthRegenSystem()
+{
+	return HealthRegenSystem;
+}
+
+const FStrategyUnitRegistry& AStrategyGameState::GetUnitRegistry() const
+{
+	UnitRegistry.Publish(GFrameCounter);
+	return UnitRegistry;
+}
+
+const FStrategyUnitSpatialIndex& AStrategyGameState::GetUnitSpatialIndex() const
+{
+	if (UnitSpatialIndexFrame != GFrameCounter)
+	{
+		UnitSpatialIndexFrame = GFrameCounter;
+		UnitSpatialIndex.Reset(UnitGridCellSize);
+
+		const FStrategyUnitRegistry& Registry = GetUnitRegistry();
+		const TArray<AStrategyChar*>& Chars = Registry.GetChars();
+		const TArray<FVector>& Locations = Registry.GetLocations();
+		const TArray<uint8>& Teams = Registry.GetTeams();
+		const TArray<float>& Health = Registry.GetHealth();
+		const TArray<FVector2D>& CapsuleSizes = Registry.GetCapsuleSizes();
+		for (int32 i = 0; i < Chars.Num(); i++)
+		{
+			if (Chars[i] != nullptr && Health[i] > 0)
+			{
+				UnitSpatialIndex.AddUnit(Chars[i], Locations[i], Teams[i], CapsuleSizes[i].X);
+			}
+		}
+	}
+
+	return UnitSpatialIndex;
+}
+
+const FStrategyConstructionScheduler& AStrategyGameState::GetConstructionScheduler() const
+{
+	return ConstructionScheduler;
+}
+
+const FStrategyVisibilityGrid& AStrategyGameState::GetVisibilityGrid() const
+{
+	if (VisibilityGridFrame == GFrameCounter || !WorldBounds.IsValid)
+	{
+		return VisibilityGrid;
+	}
+	VisibilityGridFrame = GFrameCounter;
+
+	if (!VisibilityGrid.IsInitialized() || !(VisibilityGrid.GetBounds() == WorldBounds))
+	{
+		VisibilityGrid.Reset(WorldBounds, VisibilityCellSize);
+	}
+
+	if (VisibilityGrid.NeedsStaticViewers(BuildingsRevision))
+	{
+		VisibilityGrid.ResetStaticViewers(BuildingsRevision);
+		for (uint8 TeamNum = 0; TeamNum < PlayersData.Num(); TeamNum++)
+		{
+			for (const TWeakObjectPtr<AActor>& Building : PlayersData[TeamNum].BuildingsList)
+			{
+				if (Building.IsValid())
+				{
+					VisibilityGrid.AddStaticViewer(TeamNum, Building->GetActorLocation(), BuildingSightRadius);
+				}
+			}
+		}
+	}
+
+	// all minions share sensing settings, so their sight matches what the AI can sense
+	const float UnitSightRadius = GetDefault<UStrategyAISensingComponent>()->GetSightDistance();
+
+	VisibilityGrid.BeginUpdate();
+	const FStrategyUnitRegistry& Registry = GetUnitRegistry();
+	const TArray<AStrategyChar*>& Chars = Registry.GetChars();
+	const TArray<FVector>& Locations = Registry.GetLocations();
+	const TArray<uint8>& Teams = Registry.GetTeams();
+	const TArray<float>& Health = Registry.GetHealth();
+	for (int32 i = 0; i < Chars.Num(); i++)
+	{
+		if (Chars[i] != nullptr && Health[i] > 0)
+		{
+			VisibilityGrid.AddViewer(Teams[i], Locations[i], UnitSightRadius);
+		}
+	}
+	VisibilityGrid.EndUpdate();
+
+	return VisibilityGrid;
+}
+
+void AStrategyGameState::OnBuildStarted(AStrategyBuilding* InBuilding, float FinishTime)
+{
+	// finished on the next simulation step that is past FinishTime
+	ConstructionScheduler.AddBuilding(InBuilding, FinishTime);
+}
+
+void AStrategyGameState::OnBuildingChanged()
+{
+	BuildingsRevision++;
+}
+
+uint32 AStrategyGameState::GetBuildingsRevision() const
+{
+	return BuildingsRevision;
+}
+
+void AStrategyGameState::NotifyResourcesChanged(uint8 TeamNum)
+{
+	OnResourcesChanged.Broadcast(TeamNum);
+}
+
 FPlayerData* AStrategyGameState::GetPlayerData(uint8 TeamNum) const
 {
 	if (TeamNum != EStrategyTeam::Unknown)
@@ -87,6 +362,8 @@ void AStrategyGameState::SetGameplayState(EGameplayState::Type NewState)
 			PlayersData[i].Brewery->OnGameplayStateChange(NewState);
 		}
 	}
+
+	OnGameplayStateChanged.Broadcast(NewState);
 }
 
 bool AStrategyGameState::IsGameActive() const
@@ -112,10 +389,10 @@ EStrategyTeam::Type AStrategyGameState::GetWinningTeam() const
 
 void AStrategyGameState::OnGameStart()
 {
-	SetGameplayState(EGameplayState::Playing);
-
 	WinningTeam = EStrategyTeam::Unknown;
 	GameFinishedTime = 0.0f;
+
+	SetGameplayState(EGameplayState::Playing);
 }
 
 
@@ -123,15 +400,88 @@ void AStrategyGameState::FinishGame(EStrategyTeam::Type InWinningTeam)
 {
 	GetWorldTimerManager().ClearAllTimersForObject(this);
 
-	SetGameplayState(EGameplayState::Finished);
+	// result is set first, observers of the state change show it
 	WinningTeam = InWinningTeam;
 	GameFinishedTime = GetWorld()->GetRealTimeSeconds();
+	SetGameplayState(EGameplayState::Finished);
+
+	if (ReplayRecorder.IsValid())
+	{
+		ReplayRecorder->Finish(this);
+	}
+
+	if (MatchSimulation.IsValid())
+	{
+		MatchSimulation->OnGameFinished(InWinningTeam);
+	}
 }
 
 
 
 void AStrategyGameState::StartGameplayStateMachine()
 {
+	// same seed and inputs play out the same match
+	int32 Seed = MatchSeed;
+	bool bFixedStep = bUseFixedSimulationStep;
+	float Step = SimulationStep;
+	FParse::Value(FCommandLine::Get(), TEXT("MatchSeed="), Seed);
+
+	FString ReplayPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("PlayReplay="), ReplayPath))
+	{
+		ReplayPlayer = MakeUnique<FStrategyReplayPlayer>();
+		if (ReplayPlayer->Load(ReplayPath))
+		{
+			Seed = ReplayPlayer->GetSeed();
+			bFixedStep = ReplayPlayer->IsFixedStep();
+			Step = ReplayPlayer->GetStep() > 0.0f ? ReplayPlayer->GetStep() : SimulationStep;
+
+			// one step per frame, with no waiting for real time in between
+			FApp::SetUseFixedTimeStep(true);
+			FApp::SetFixedDeltaTime(Step);
+		}
+		else
+		{
+			UE_LOG(LogGame, Error, TEXT("Can't play replay %s"), *ReplayPath);
+			ReplayPlayer.Reset();
+		}
+	}
+
+	// recording runs engine at the same fixed step as playback, so movement, AI and animation advance
+	// by the same deltas in both, simulation step alone isn't enough
+	const bool bRecordReplay = !ReplayPlayer.IsValid() && FParse::Value(FCommandLine::Get(), TEXT("RecordReplay="), ReplayPath);
+	if (bRecordReplay)
+	{
+		bFixedStep = true;
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(Step);
+	}
+
+	if (Seed == 0)
+	{
+		Seed = int32(FPlatformTime::Cycles() | 1);
+	}
+	// timers set before match start (e.g. by towers placed in level) keep their delay from now
+	const float TimeBeforeReset = SimulationClock.GetTime();
+	SimulationClock.Reset(bFixedStep, Step, Seed);
+	SimulationTimers.ShiftTimes(SimulationClock.GetTime() - TimeBeforeReset);
+	UE_LOG(LogGame, Log, TEXT("Match seed %d, %s"), Seed, bFixedStep ? *FString::Printf(TEXT("fixed step %.4f"), Step) : TEXT("variable step"));
+
+	if (bRecordReplay)
+	{
+		ReplayRecorder = MakeUnique<FStrategyReplayRecorder>();
+		ReplayRecorder->Start(ReplayPath, this);
+	}
+
+	if (FStrategyMatchSimulation::IsRequested())
+	{
+		MatchSimulation = MakeUnique<FStrategyMatchSimulation>();
+		if (!MatchSimulation->Init(this))
+		{
+			MatchSimulation.Reset();
+		}
+	}
+
 	if (WarmupTime > 0.f)
 	{
 		SetGameplayState(EGameplayState::Waiting);
@@ -0,0 +1,121 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyHealthRegenSystem.h"
+#include "StrategyDamageQueue.h"
+
+const float FStrategyHealthRegenSystem::RegenInterval = 1.0f;
+
+FStrategyHealthRegenSystem::FStrategyHealthRegenSystem()
+	: Cursor(0)
+	, Budget(0.0f)
+{
+}
+
+void FStrategyHealthRegenSystem::AddChar(AStrategyChar* InChar)
+{
+	if (InChar == nullptr || CharIndices.Contains(InChar))
+	{
+		return;
+	}
+
+	CharIndices.Add(InChar, Chars.Num());
+	Chars.Add(InChar);
+	Regen.Add(InChar->GetPawnData()->HealthRegen);
+	MaxHealth.Add(InChar->GetMaxHealth());
+}
+
+void FStrategyHealthRegenSystem::RemoveChar(AStrategyChar* InChar)
+{
+	int32 Index = INDEX_NONE;
+	if (!CharIndices.RemoveAndCopyValue(InChar, Index))
+	{
+		return;
+	}
+
+	// keep processed chars packed before cursor, so the entry moved into freed slot isn't skipped this pass
+	if (Index < Cursor)
+	{
+		const int32 LastProcessed = Cursor - 1;
+		if (Index != LastProcessed)
+		{
+			CharIndices[Chars[LastProcessed]] = Index;
+			Chars.Swap(Index, LastProcessed);
+			Regen.Swap(Index, LastProcessed);
+			MaxHealth.Swap(Index, LastProcessed);
+		}
+		Index = LastProcessed;
+		Cursor--;
+	}
+
+	// move last entry into freed slot
+	const int32 LastIndex = Chars.Num() - 1;
+	if (Index != LastIndex)
+	{
+		CharIndices[Chars[LastIndex]] = Index;
+	}
+
+	Chars.RemoveAtSwap(Index, 1, false);
+	Regen.RemoveAtSwap(Index, 1, false);
+	MaxHealth.RemoveAtSwap(Index, 1, false);
+}
+
+void FStrategyHealthRegenSystem::UpdateChar(AStrategyChar* InChar)
+{
+	const int32* Index = CharIndices.Find(InChar);
+	if (Index != nullptr)
+	{
+		Regen[*Index] = InChar->GetPawnData()->HealthRegen;
+		MaxHealth[*Index] = InChar->GetMaxHealth();
+	}
+}
+
+void FStrategyHealthRegenSystem::Tick(float DeltaTime, FStrategyDamageQueue& DamageQueue)
+{
+	const int32 NumChars = Chars.Num();
+	if (NumChars == 0)
+	{
+		Budget = 0.0f;
+		return;
+	}
+
+	// each char once per interval, never more than one full pass in a single frame
+	Budget = FMath::Min(Budget + DeltaTime * NumChars / RegenInterval, float(NumChars));
+	const int32 NumToProcess = FMath::FloorToInt(Budget);
+	Budget -= NumToProcess;
+
+	for (int32 i = 0; i < NumToProcess; i++)
+	{
+		if (Cursor >= NumChars)
+		{
+			Cursor = 0;
+		}
+
+		const int32 Index = Cursor++;
+		AStrategyChar* const Char = Chars[Index];
+		if (Regen[Index] == 0 || Char->Health <= 0.f)
+		{
+			continue;
+		}
+
+		if (Regen[Index] > 0)
+		{
+			Char->Health = FMath::Min<int32>(Char->Health + Regen[Index], MaxHealth[Index]);
+		}
+		else
+		{
+			// damage can kill and unregister the char, so it's applied with the rest of frame's damage
+			DamageQueue.QueueDamageOverTime(Char, -Regen[Index]);
+		}
+	}
+}
+
+void FStrategyHealthRegenSystem::Reset()
+{
+	Chars.Reset();
+	Regen.Reset();
+	MaxHealth.Reset();
+	CharIndices.Reset();
+	Cursor = 0;
+	Budget = 0.0f;
+}
@@ -2,27 +2,8 @@
 
 #include "StrategyGame.h"
 #include "StrategyHelpers.h"
-
-bool FStrategyHelpers::DeprojectScreenToWorld(const FVector2D& ScreenPosition, ULocalPlayer* Player, FVector& RayOrigin, FVector& RayDirection)
-{
-	if (Player != NULL && Player->ViewportClient != NULL && Player->ViewportClient->Viewport != NULL && Player->PlayerController != NULL)
-	{
-		//get the projection data
-		FSceneViewProjectionData ProjectionData;
-		if (Player->GetProjectionData(Player->ViewportClient->Viewport, eSSP_FULL, /*out*/ ProjectionData))
-		{
-			const FMatrix ViewMatrix = FTranslationMatrix(-ProjectionData.ViewOrigin) * ProjectionData.ViewRotationMatrix;
-			const FMatrix InvViewMatrix = ViewMatrix.InverseFast();
-			const FMatrix InvProjectionMatrix = ProjectionData.ProjectionMatrix.InverseFast();
-
-			FSceneView::DeprojectScreenToWorld(ScreenPosition, ProjectionData.GetConstrainedViewRect(), InvViewMatrix, InvProjectionMatrix, /*out*/ RayOrigin, /*out*/ RayDirection);
-
-			return true;
-		}
-	}
-
-	return false;
-}
+#include "StrategyButtonImageCache.h"
+#include "StrategyHitMaskUserData.h"
 
 FVector FStrategyHelpers::IntersectRayWithPlane(const FVector& RayOrigin, const FVector& RayDirection, const FPlane& Plane)
 {
@@ -33,20 +14,25 @@ FVector FStrategyHelpers::IntersectRayWithPlane(const FVector& RayOrigin, const
 	return RayOrigin + RayDirection * Distance;
 }
 
-TSharedPtr<TArray<uint8>> FStrategyHelpers::CreateAlphaMapFromTexture(UTexture2D* Texture)
+TSharedPtr<FStrategyHitMask> FStrategyHelpers::CreateHitMaskFromTexture(UTexture2D* Texture)
 {
-	TSharedPtr<TArray<uint8>> ResultArray;
-
-	// create temporary hitmask
-	if (Texture && Texture->GetPixelFormat() == PF_B8G8R8A8 && Texture->GetNumMips() == 1)
+	TSharedPtr<FStrategyHitMask> Result;
+	if (Texture == nullptr)
 	{
-		const int32 HitMaskSize = Texture->GetSizeX() * Texture->GetSizeY();
+		return Result;
+	}
 
-		ResultArray = TSharedPtr<TArray<uint8>>(new TArray<uint8>());
-		ResultArray->Init(255, HitMaskSize);
+	// masks are saved with the texture by UStrategyHitMaskCommandlet, without one every texel can be clicked
+	Result = MakeShareable(new FStrategyHitMask());
+	const UStrategyHitMaskUserData* const SavedMask = Texture->GetAssetUserData<UStrategyHitMaskUserData>();
+	if (SavedMask != nullptr && SavedMask->Bits.Num() > 0)
+	{
+		Result->SizeX = SavedMask->SizeX;
+		Result->SizeY = SavedMask->SizeY;
+		Result->Bits = SavedMask->Bits;
 	}
 
-	return ResultArray;
+	return Result;
 }
 
 FCanvasUVTri FStrategyHelpers::CreateCanvasTri(FVector2D V0, FVector2D V1,FVector2D V2)
@@ -0,0 +1,264 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyMatchSimulation.h"
+#include "StrategyBuilding.h"
+#include "StrategyBuilding_Brewery.h"
+#include "StrategyResourceNode.h"
+#include "StrategyInputInterface.h"
+
+FStrategyMatchSimulation::FStrategyMatchSimulation()
+	: NextAction(0)
+	, Output(nullptr)
+	, NextSummaryTime(1.0f)
+	, TimeLimit(0.0f)
+	, bFinished(false)
+	, NumFrames(0)
+	, LastFrameTime(0.0)
+	, FrameSeconds(0.0)
+	, MaxFrameSeconds(0.0)
+	, GameThreadSeconds(0.0)
+	, SystemsSeconds(0.0)
+{
+}
+
+FStrategyMatchSimulation::~FStrategyMatchSimulation()
+{
+	delete Output;
+}
+
+bool FStrategyMatchSimulation::IsRequested()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("StrategySim"));
+}
+
+bool FStrategyMatchSimulation::Init(AStrategyGameState* InGameState)
+{
+	const TCHAR* const CommandLine = FCommandLine::Get();
+	GameState = InGameState;
+
+	FString ScriptPath;
+	if (FParse::Value(CommandLine, TEXT("SimScript="), ScriptPath) && !LoadScript(ScriptPath))
+	{
+		UE_LOG(LogGame, Error, TEXT("Simulation: can't read script %s"), *ScriptPath);
+		return false;
+	}
+
+	FString OutputPath;
+	if (FParse::Value(CommandLine, TEXT("SimOutput="), OutputPath))
+	{
+		Output = IFileManager::Get().CreateFileWriter(*OutputPath);
+		if (Output == nullptr)
+		{
+			UE_LOG(LogGame, Warning, TEXT("Simulation: can't write %s, summary is only logged"), *OutputPath);
+		}
+	}
+
+	float TimeStep = 1.0f / 30.0f;
+	FParse::Value(CommandLine, TEXT("SimStep="), TimeStep);
+	if (TimeStep > 0.0f)
+	{
+		// engine doesn't wait for real time to pass with a fixed step
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(TimeStep);
+	}
+	else
+	{
+		float TimeScale = 1.0f;
+		FParse::Value(CommandLine, TEXT("SimSpeed="), TimeScale);
+		UGameplayStatics::SetGlobalTimeDilation(InGameState, TimeScale);
+	}
+
+	FParse::Value(CommandLine, TEXT("SimTimeLimit="), TimeLimit);
+
+	NextSummaryTime = InGameState->GetSimulationTime() + 1.0f;
+	LastFrameTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogGame, Log, TEXT("Simulation: %d scripted actions, step %.4f, time limit %.0f"), Actions.Num(), TimeStep, TimeLimit);
+	return true;
+}
+
+bool FStrategyMatchSimulation::LoadScript(const FString& Path)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < Lines.Num(); i++)
+	{
+		FString Line = Lines[i];
+		int32 CommentStart = INDEX_NONE;
+		if (Line.FindChar(TEXT('#'), CommentStart))
+		{
+			Line.LeftInline(CommentStart);
+		}
+
+		TArray<FString> Tokens;
+		if (Line.ParseIntoArrayWS(Tokens) == 0)
+		{
+			continue;
+		}
+		if (Tokens.Num() < 2 || !Tokens[0].IsNumeric())
+		{
+			UE_LOG(LogGame, Warning, TEXT("Simulation: %s(%d) skipped, expected \"<seconds> <action> [args]\""), *Path, i + 1);
+			continue;
+		}
+
+		FAction Action;
+		Action.Time = FCString::Atof(*Tokens[0]);
+		Action.Name = Tokens[1];
+		Action.Args.Append(Tokens.GetData() + 2, Tokens.Num() - 2);
+		Actions.Add(MoveTemp(Action));
+	}
+
+	Actions.StableSort([](const FAction& A, const FAction& B) { return A.Time < B.Time; });
+	return true;
+}
+
+void FStrategyMatchSimulation::Tick(float DeltaSeconds, double InSystemsSeconds)
+{
+	AStrategyGameState* const MyGameState = GameState.Get();
+	if (bFinished || MyGameState == nullptr)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double LastFrameSeconds = Now - LastFrameTime;
+	LastFrameTime = Now;
+	NumFrames++;
+	FrameSeconds += LastFrameSeconds;
+	MaxFrameSeconds = FMath::Max(MaxFrameSeconds, LastFrameSeconds);
+	GameThreadSeconds += FPlatformTime::ToSeconds(GGameThreadTime);
+	SystemsSeconds += InSystemsSeconds;
+
+	const float GameTime = MyGameState->GetSimulationTime();
+	while (NextAction < Actions.Num() && Actions[NextAction].Time <= GameTime)
+	{
+		RunAction(Actions[NextAction++]);
+	}
+
+	if (GameTime >= NextSummaryTime)
+	{
+		WriteSummary(TEXT("second"));
+		NextSummaryTime = FMath::FloorToFloat(GameTime) + 1.0f;
+	}
+
+	if (TimeLimit > 0.0f && GameTime >= TimeLimit)
+	{
+		AStrategyGameMode* const GameMode = MyGameState->GetWorld()->GetAuthGameMode<AStrategyGameMode>();
+		if (GameMode != nullptr)
+		{
+			GameMode->FinishGame(EStrategyTeam::Unknown);
+		}
+	}
+}
+
+void FStrategyMatchSimulation::RunAction(const FAction& Action)
+{
+	AStrategyGameState* const MyGameState = GameState.Get();
+	UWorld* const World = MyGameState->GetWorld();
+	FPlayerData* const PlayerData = MyGameState->GetPlayerData(EStrategyTeam::Player);
+
+	// actors are looked up by name in the level, iterating them would be too slow here
+	bool bDone = false;
+	if (Action.Name == TEXT("SpawnDwarf"))
+	{
+		if (PlayerData->Brewery.IsValid())
+		{
+			PlayerData->Brewery->SpawnDwarf();
+			bDone = true;
+		}
+	}
+	else if (Action.Name == TEXT("Upgrade") && Action.Args.Num() >= 2)
+	{
+		AStrategyBuilding* const Building = FindObject<AStrategyBuilding>(World->PersistentLevel, *Action.Args[0]);
+		UClass* const NewClass = LoadClass<AStrategyBuilding>(nullptr, *Action.Args[1]);
+		if (Building != nullptr && NewClass != nullptr)
+		{
+			bDone = Building->RequestUpgrade(NewClass);
+		}
+	}
+	else if (Action.Name == TEXT("Tap") && Action.Args.Num() >= 1)
+	{
+		AStrategyResourceNode* const Node = FindObject<AStrategyResourceNode>(World->PersistentLevel, *Action.Args[0]);
+		if (Node != nullptr)
+		{
+			IStrategyInputInterface::Execute_OnInputTap(Node);
+			bDone = true;
+		}
+	}
+	else if (Action.Name == TEXT("AddGold") && Action.Args.Num() >= 1)
+	{
+		const int32 NewGold = FCString::Atoi(*Action.Args[0]);
+		PlayerData->ResourcesAvailable += NewGold;
+		PlayerData->ResourcesGathered += NewGold;
+		MyGameState->NotifyResourcesChanged(EStrategyTeam::Player);
+		bDone = true;
+	}
+
+	if (!bDone)
+	{
+		UE_LOG(LogGame, Warning, TEXT("Simulation: action %s %s at %.2f failed"), *Action.Name, *FString::Join(Action.Args, TEXT(" ")), Action.Time);
+	}
+}
+
+void FStrategyMatchSimulation::WriteSummary(const TCHAR* Event)
+{
+	AStrategyGameState* const MyGameState = GameState.Get();
+
+	FString Alive, DamageDone, ResourcesGathered, ResourcesAvailable;
+	for (uint8 Team = 0; Team < EStrategyTeam::MAX; Team++)
+	{
+		const FPlayerData* const TeamData = MyGameState->GetPlayerData(Team);
+		const TCHAR* const Separator = Team > 0 ? TEXT(",") : TEXT("");
+		Alive += FString::Printf(TEXT("%s%d"), Separator, MyGameState->GetNumberOfLivePawns((EStrategyTeam::Type)Team));
+		DamageDone += FString::Printf(TEXT("%s%u"), Separator, TeamData ? TeamData->DamageDone : 0);
+		ResourcesGathered += FString::Printf(TEXT("%s%u"), Separator, TeamData ? TeamData->ResourcesGathered : 0);
+		ResourcesAvailable += FString::Printf(TEXT("%s%u"), Separator, TeamData ? TeamData->ResourcesAvailable : 0);
+	}
+
+	const double FramesDiv = FMath::Max(NumFrames, 1);
+	WriteLine(FString::Printf(TEXT("{\"event\":\"%s\",\"time\":%.2f,\"frames\":%d,\"alive\":[%s],\"damage_done\":[%s],\"resources_gathered\":[%s],\"resources_available\":[%s],")
+		TEXT("\"frame_ms\":%.3f,\"frame_max_ms\":%.3f,\"game_thread_ms\":%.3f,\"systems_ms\":%.3f}"),
+		Event, MyGameState->GetSimulationTime(), NumFrames, *Alive, *DamageDone, *ResourcesGathered, *ResourcesAvailable,
+		FrameSeconds * 1000.0 / FramesDiv, MaxFrameSeconds * 1000.0, GameThreadSeconds * 1000.0 / FramesDiv, SystemsSeconds * 1000.0 / FramesDiv));
+
+	NumFrames = 0;
+	FrameSeconds = 0.0;
+	MaxFrameSeconds = 0.0;
+	GameThreadSeconds = 0.0;
+	SystemsSeconds = 0.0;
+}
+
+void FStrategyMatchSimulation::WriteLine(const FString& Line)
+{
+	UE_LOG(LogGame, Log, TEXT("Simulation: %s"), *Line);
+
+	if (Output != nullptr)
+	{
+		FTCHARToUTF8 Utf8Line(*(Line + TEXT("\n")));
+		Output->Serialize((void*)Utf8Line.Get(), Utf8Line.Length());
+		Output->Flush();
+	}
+}
+
+void FStrategyMatchSimulation::OnGameFinished(EStrategyTeam::Type WinningTeam)
+{
+	AStrategyGameState* const MyGameState = GameState.Get();
+	if (bFinished || MyGameState == nullptr)
+	{
+		return;
+	}
+	bFinished = true;
+
+	WriteSummary(TEXT("finished"));
+	WriteLine(FString::Printf(TEXT("{\"event\":\"result\",\"time\":%.2f,\"winner\":%d,\"seed\":%d}"), MyGameState->GetSimulationTime(), int32(WinningTeam), MyGameState->GetSimulationClock().GetSeed()));
+
+	delete Output;
+	Output = nullptr;
+
+	FPlatformMisc::RequestExit(false);
+}
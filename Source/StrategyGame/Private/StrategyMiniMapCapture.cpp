@@ -2,11 +2,13 @@
 
 #include "StrategyGame.h"
 #include "StrategyMiniMapCapture.h"
+#include "StrategyBuilding.h"
 
 
 AStrategyMiniMapCapture::AStrategyMiniMapCapture (const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	GetCaptureComponent2D()->bCaptureEveryFrame = false;
+	GetCaptureComponent2D()->bCaptureOnMovement = false;
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.bStartWithTickEnabled = true;
 	MiniMapWidth = 256;
@@ -15,6 +17,7 @@ AStrategyMiniMapCapture::AStrategyMiniMapCapture (const FObjectInitializer& Obje
 	AudioListenerGroundLevel = 500.0f;
 	bUseAudioListenerOrientation = false;
 	bTextureChanged = true;
+	BakedTerrain = nullptr;
 }
 
 void AStrategyMiniMapCapture::BeginPlay()
@@ -22,8 +25,8 @@ void AStrategyMiniMapCapture::BeginPlay()
 	// @todo clean up
 	Super::BeginPlay();
 
-	if (!GetCaptureComponent2D()->TextureTarget || MiniMapWidth != GetCaptureComponent2D()->TextureTarget->GetSurfaceWidth()
-		|| MiniMapHeight != GetCaptureComponent2D()->TextureTarget->GetSurfaceHeight())
+	if (BakedTerrain == nullptr && (!GetCaptureComponent2D()->TextureTarget || MiniMapWidth != GetCaptureComponent2D()->TextureTarget->GetSurfaceWidth()
+		|| MiniMapHeight != GetCaptureComponent2D()->TextureTarget->GetSurfaceHeight()))
 	{
 		MiniMapView = NewObject<UTextureRenderTarget2D>();
 		MiniMapView->InitAutoFormat(MiniMapWidth,MiniMapHeight);
@@ -58,10 +61,43 @@ void AStrategyMiniMapCapture::UpdateWorldBounds()
 		Points.Add(FVector(CamLocation.X-MaxVisibleDistance,CamLocation.Y-MaxVisibleDistance,GroundLevel));
 
 		MyGameState->WorldBounds = FBox(Points);
-		GetCaptureComponent2D()->UpdateContent();
+		if (BakedTerrain == nullptr)
+		{
+			CaptureTerrain();
+		}
 	}
 }
 
+void AStrategyMiniMapCapture::CaptureTerrain()
+{
+	USceneCaptureComponent2D* const CaptureComponent = GetCaptureComponent2D();
+	if (CaptureComponent->TextureTarget == nullptr)
+	{
+		return;
+	}
+
+	// buildings and units are drawn over the terrain by the HUD
+	CaptureComponent->HiddenActors.Reset();
+	for (AActor* const TestActor : FStrategyUnitRegistry::SlowActorRange<AActor>(GetWorld()))
+	{
+		if (TestActor->IsA(AStrategyBuilding::StaticClass()) || TestActor->IsA(AStrategyChar::StaticClass()))
+		{
+			CaptureComponent->HiddenActors.Add(TestActor);
+		}
+	}
+	CaptureComponent->CaptureScene();
+	CaptureComponent->HiddenActors.Reset();
+}
+
+UTexture* AStrategyMiniMapCapture::GetTerrainTexture() const
+{
+	if (BakedTerrain != nullptr)
+	{
+		return BakedTerrain;
+	}
+	return GetCaptureComponent2D()->TextureTarget;
+}
+
 void AStrategyMiniMapCapture::Tick(float DeltaSeconds)
 {
 	if (CachedFOV != GetCaptureComponent2D()->FOVAngle || CachedLocation != RootComponent->GetComponentLocation() || bTextureChanged)
@@ -87,6 +123,23 @@ void AStrategyMiniMapCapture::PostEditChangeProperty(FPropertyChangedEvent& Prop
 	}
 }
 
+void AStrategyMiniMapCapture::BakeTerrain()
+{
+	UTextureRenderTarget2D* const RenderTarget = NewObject<UTextureRenderTarget2D>();
+	RenderTarget->InitAutoFormat(MiniMapWidth, MiniMapHeight);
+	RenderTarget->UpdateResourceImmediate(true);
+
+	UTextureRenderTarget2D* const PrevTarget = GetCaptureComponent2D()->TextureTarget;
+	GetCaptureComponent2D()->TextureTarget = RenderTarget;
+	CaptureTerrain();
+	GetCaptureComponent2D()->TextureTarget = PrevTarget;
+
+	// texture lives in the map package, so it's cooked along with the map
+	Modify();
+	BakedTerrain = RenderTarget->ConstructTexture2D(this, TEXT("MiniMapTerrain"), RF_NoFlags);
+	UE_LOG(LogGame, Log, TEXT("Baked mini map terrain for %s, %dx%d"), *GetName(), MiniMapWidth, MiniMapHeight);
+}
+
 void AStrategyMiniMapCapture::EditorApplyRotation(const FRotator& DeltaRotation, bool bAltDown, bool bShiftDown, bool bCtrlDown)
 {
 	FRotator FiltredRotation(0, DeltaRotation.Yaw, 0);
@@ -0,0 +1,188 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyPreloader.h"
+#include "StrategyGameLoadingScreen.h"
+
+namespace
+{
+	/** async load priorities of batches, map first since travel waits on it */
+	const TAsyncLoadPriority MapPriority = FStreamableManager::AsyncLoadHighPriority;
+	const TAsyncLoadPriority HUDAssetsPriority = FStreamableManager::AsyncLoadHighPriority / 2;
+	const TAsyncLoadPriority GameplayClassesPriority = FStreamableManager::DefaultAsyncLoadPriority;
+
+	UStrategyPreloader* PreloaderInstance = nullptr;
+}
+
+UStrategyPreloader::UStrategyPreloader(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, bStarted(false)
+{
+}
+
+UStrategyPreloader* UStrategyPreloader::Get()
+{
+	if (PreloaderInstance == nullptr)
+	{
+		PreloaderInstance = NewObject<UStrategyPreloader>(GetTransientPackage());
+		PreloaderInstance->AddToRoot();
+	}
+	return PreloaderInstance;
+}
+
+void UStrategyPreloader::StartPreload()
+{
+	if (bStarted)
+	{
+		return;
+	}
+	bStarted = true;
+
+	for (const FString& PackageName : MapPackages)
+	{
+		UPackage* const Package = FindPackage(nullptr, *PackageName);
+		if (Package != nullptr)
+		{
+			AddLoadedMapPackage(Package);
+		}
+		else
+		{
+			PendingMapPackages.Add(FName(*PackageName));
+			LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateUObject(this, &UStrategyPreloader::OnMapPackageLoaded), MapPriority);
+		}
+	}
+
+	TArray<FSoftObjectPath> HUDAssets;
+	AStrategyHUD::GetPreloadAssets(HUDAssets);
+	if (HUDAssets.Num() > 0)
+	{
+		HUDAssetsHandle = StreamableManager.RequestAsyncLoad(HUDAssets, FStreamableDelegate(), HUDAssetsPriority);
+	}
+
+	if (GameplayClasses.Num() > 0)
+	{
+		GameplayClassesHandle = StreamableManager.RequestAsyncLoad(GameplayClasses, FStreamableDelegate(), GameplayClassesPriority);
+	}
+
+	UE_LOG(LogGame, Log, TEXT("Preloading %d map packages, %d HUD assets and %d gameplay classes"), PendingMapPackages.Num(), HUDAssets.Num(), GameplayClasses.Num());
+}
+
+void UStrategyPreloader::ReportProgressToLoadingScreen()
+{
+	if (!FlushUpdateHandle.IsValid())
+	{
+		FlushUpdateHandle = FCoreDelegates::OnAsyncLoadingFlushUpdate.AddUObject(this, &UStrategyPreloader::OnAsyncLoadingFlushUpdate);
+	}
+	OnAsyncLoadingFlushUpdate();
+}
+
+void UStrategyPreloader::Release()
+{
+	if (FlushUpdateHandle.IsValid())
+	{
+		FCoreDelegates::OnAsyncLoadingFlushUpdate.Remove(FlushUpdateHandle);
+		FlushUpdateHandle.Reset();
+	}
+
+	IStrategyGameLoadingScreenModule* const LoadingScreenModule = FModuleManager::GetModulePtr<IStrategyGameLoadingScreenModule>("StrategyGameLoadingScreen");
+	if (LoadingScreenModule != nullptr)
+	{
+		LoadingScreenModule->SetLoadingProgress(-1.0f);
+	}
+
+	if (HUDAssetsHandle.IsValid())
+	{
+		HUDAssetsHandle->ReleaseHandle();
+		HUDAssetsHandle.Reset();
+	}
+	if (GameplayClassesHandle.IsValid())
+	{
+		GameplayClassesHandle->ReleaseHandle();
+		GameplayClassesHandle.Reset();
+	}
+
+	// packages still loading finish on their own, they are just not kept anymore
+	LoadedMapPackages.Reset();
+	LoadedMapWorlds.Reset();
+	PendingMapPackages.Reset();
+	bStarted = false;
+}
+
+float UStrategyPreloader::GetProgress() const
+{
+	if (!bStarted)
+	{
+		return 0.0f;
+	}
+
+	// weight batches by number of items, map packages by their own async progress
+	float Loaded = LoadedMapPackages.Num();
+	for (const FName& PackageName : PendingMapPackages)
+	{
+		Loaded += FMath::Max(GetAsyncLoadPercentage(PackageName), 0.0f) / 100.0f;
+	}
+	int32 Total = LoadedMapPackages.Num() + PendingMapPackages.Num();
+
+	const TSharedPtr<FStreamableHandle> Handles[] = { HUDAssetsHandle, GameplayClassesHandle };
+	for (const TSharedPtr<FStreamableHandle>& Handle : Handles)
+	{
+		if (Handle.IsValid())
+		{
+			TArray<FSoftObjectPath> Requested;
+			Handle->GetRequestedAssets(Requested);
+			Loaded += Handle->GetProgress() * Requested.Num();
+			Total += Requested.Num();
+		}
+	}
+
+	return Total > 0 ? Loaded / Total : 1.0f;
+}
+
+bool UStrategyPreloader::IsComplete() const
+{
+	return bStarted && PendingMapPackages.Num() == 0
+		&& (!HUDAssetsHandle.IsValid() || HUDAssetsHandle->HasLoadCompleted())
+		&& (!GameplayClassesHandle.IsValid() || GameplayClassesHandle->HasLoadCompleted());
+}
+
+void UStrategyPreloader::OnMapPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+	if (PendingMapPackages.Remove(PackageName) == 0)
+	{
+		// released meanwhile
+		return;
+	}
+
+	if (Result == EAsyncLoadingResult::Succeeded && LoadedPackage != nullptr)
+	{
+		AddLoadedMapPackage(LoadedPackage);
+	}
+	else
+	{
+		UE_LOG(LogGame, Warning, TEXT("Preloading map package %s failed"), *PackageName.ToString());
+	}
+}
+
+void UStrategyPreloader::AddLoadedMapPackage(UPackage* Package)
+{
+	LoadedMapPackages.AddUnique(Package->GetFName());
+
+	UWorld* const World = UWorld::FindWorldInPackage(Package);
+	if (World != nullptr)
+	{
+		LoadedMapWorlds.AddUnique(World);
+	}
+	else
+	{
+		UE_LOG(LogGame, Warning, TEXT("Preloaded map package %s holds no world"), *Package->GetName());
+	}
+}
+
+void UStrategyPreloader::OnAsyncLoadingFlushUpdate()
+{
+	IStrategyGameLoadingScreenModule* const LoadingScreenModule = FModuleManager::GetModulePtr<IStrategyGameLoadingScreenModule>("StrategyGameLoadingScreen");
+	if (LoadingScreenModule != nullptr)
+	{
+		LoadingScreenModule->SetLoadingProgress(GetProgress());
+	}
+}
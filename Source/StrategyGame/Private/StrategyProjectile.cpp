@@ -2,6 +2,7 @@
 
 #include "StrategyGame.h"
 #include "StrategyProjectile.h"
+#include "StrategyTeamTable.h"
 
 AStrategyProjectile::AStrategyProjectile(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -39,6 +40,7 @@ void AStrategyProjectile::InitProjectile(const FVector& Direction, uint8 InTeamN
 	MovementComp->Velocity = MovementComp->InitialSpeed * Direction;
 
 	MyTeamNum = InTeamNum;
+	FStrategyTeamTable::SetTeam(this, MyTeamNum);
 	RemainingDamage = ImpactDamage;
 	SetLifeSpan( InLifeSpan );
 
@@ -88,14 +90,20 @@ void AStrategyProjectile::OnHit(FHitResult const& HitResult)
 
 void AStrategyProjectile::DealDamage(FHitResult const& HitResult)
 {
-	const AStrategyChar* HitChar = Cast<AStrategyChar>(HitResult.Actor.Get());
-	const float PrevHealth = HitChar ? HitChar->Health : 0.0f;
+	AStrategyGameState* const GameState = GetWorld()->GetGameState<AStrategyGameState>();
+	if (GameState == nullptr)
+	{
+		return;
+	}
 
-	UGameplayStatics::ApplyPointDamage(HitResult.Actor.Get(), RemainingDamage, -HitResult.ImpactNormal, HitResult, NULL, this, UDamageType::StaticClass());
+	// damage is applied at the end of frame, so use the health it will take to reduce remaining damage
+	FStrategyDamageQueue& DamageQueue = GameState->GetDamageQueue();
+	const float DamageDealt = DamageQueue.PredictDamage(HitResult.Actor.Get(), RemainingDamage, GetTeamNum());
+	DamageQueue.QueuePointDamage(HitResult.Actor.Get(), RemainingDamage, GetTeamNum(), -HitResult.ImpactNormal, HitResult, NULL, this);
 
-	if (HitChar && !ConstantDamage)
+	if (Cast<AStrategyChar>(HitResult.Actor.Get()) && !ConstantDamage)
 	{
-		RemainingDamage -= FMath::TruncToInt(PrevHealth - HitChar->Health);
+		RemainingDamage -= FMath::TruncToInt(DamageDealt);
 	}
 }
 
@@ -106,6 +114,13 @@ void AStrategyProjectile::LifeSpanExpired()
 	Super::LifeSpanExpired();
 }
 
+void AStrategyProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FStrategyTeamTable::ClearTeam(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 uint8 AStrategyProjectile::GetTeamNum() const
 {
 	return MyTeamNum;
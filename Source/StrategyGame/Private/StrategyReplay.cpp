@@ -0,0 +1,445 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyReplay.h"
+#include "StrategyBuilding.h"
+#include "StrategyBuilding_Brewery.h"
+#include "StrategyInputInterface.h"
+
+/** unit locations are hashed on a coarse grid, so tiny float noise doesn't count as divergence */
+static const float ChecksumLocationGrid = 8.0f;
+
+/** how far a replaced building may be from the recorded location */
+static const float MaxTargetDistance = 100.0f;
+
+static void WriteVarint(TArray<uint8>& Data, uint64 Value)
+{
+	while (Value >= 0x80)
+	{
+		Data.Add(uint8(Value) | 0x80);
+		Value >>= 7;
+	}
+	Data.Add(uint8(Value));
+}
+
+static void WriteZigZag(TArray<uint8>& Data, int64 Value)
+{
+	WriteVarint(Data, (uint64(Value) << 1) ^ uint64(Value >> 63));
+}
+
+static void WriteRaw(TArray<uint8>& Data, const void* Value, int32 Size)
+{
+	Data.Append(static_cast<const uint8*>(Value), Size);
+}
+
+uint32 FStrategyReplay::ComputeChecksum(const AStrategyGameState* GameState)
+{
+	uint32 Crc = 0;
+	for (uint8 Team = 0; Team < EStrategyTeam::MAX; Team++)
+	{
+		const FPlayerData* const TeamData = GameState->GetPlayerData(Team);
+		if (TeamData != nullptr)
+		{
+			const uint32 Values[] = { TeamData->ResourcesAvailable, TeamData->ResourcesGathered, TeamData->DamageDone };
+			Crc = FCrc::MemCrc32(Values, sizeof(Values), Crc);
+		}
+	}
+
+	// registry may have been published earlier this frame, so only its list of chars is used
+	const FStrategyUnitRegistry& Registry = GameState->GetUnitRegistry();
+	const TArray<AStrategyChar*>& Chars = Registry.GetChars();
+	const TArray<uint8>& Teams = Registry.GetTeams();
+	for (int32 i = 0; i < Chars.Num(); i++)
+	{
+		const AStrategyChar* const Char = Chars[i];
+		if (Char != nullptr)
+		{
+			const FVector Location = Char->GetActorLocation() / ChecksumLocationGrid;
+			const int32 Values[] = { Teams[i], Char->GetHealth(), FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y) };
+			Crc = FCrc::MemCrc32(Values, sizeof(Values), Crc);
+		}
+	}
+
+	return Crc;
+}
+
+FStrategyReplayRecorder::FStrategyReplayRecorder()
+	: LastStep(0)
+	, RealTimeOrigin(0.0)
+	, bFinished(false)
+{
+}
+
+void FStrategyReplayRecorder::Start(const FString& InPath, const AStrategyGameState* GameState)
+{
+	const FStrategySimulationClock& Clock = GameState->GetSimulationClock();
+	check(Clock.IsFixedStep());
+
+	Path = InPath;
+	LastStep = Clock.GetStepCount();
+	RealTimeOrigin = FPlatformTime::Seconds() - Clock.GetTime();
+
+	const uint32 Magic = FStrategyReplay::Magic;
+	const uint16 Version = FStrategyReplay::Version;
+	const int32 Seed = Clock.GetSeed();
+	const uint8 bFixedStep = Clock.IsFixedStep() ? 1 : 0;
+	const float Step = Clock.GetStepDelta();
+	WriteRaw(Data, &Magic, sizeof(Magic));
+	WriteRaw(Data, &Version, sizeof(Version));
+	WriteRaw(Data, &Seed, sizeof(Seed));
+	WriteRaw(Data, &bFixedStep, sizeof(bFixedStep));
+	WriteRaw(Data, &Step, sizeof(Step));
+	WriteVarint(Data, FStrategyReplay::ChecksumInterval);
+	WriteString(GameState->GetWorld()->GetOutermost()->GetName());
+
+	UE_LOG(LogGame, Log, TEXT("Recording replay to %s"), *Path);
+}
+
+void FStrategyReplayRecorder::BeginRecord(const AStrategyGameState* GameState, uint8 Type)
+{
+	const int64 CurrentStep = GameState->GetSimulationClock().GetStepCount();
+	Data.Add(Type);
+	WriteVarint(Data, uint64(CurrentStep - LastStep));
+	LastStep = CurrentStep;
+}
+
+void FStrategyReplayRecorder::WriteTarget(const AActor* Target)
+{
+	const FVector Location = Target->GetActorLocation();
+	WriteString(Target->GetName());
+	WriteZigZag(Data, FMath::RoundToInt(Location.X));
+	WriteZigZag(Data, FMath::RoundToInt(Location.Y));
+	WriteZigZag(Data, FMath::RoundToInt(Location.Z));
+}
+
+void FStrategyReplayRecorder::WriteString(const FString& String)
+{
+	const int32* const Index = Strings.Find(String);
+	if (Index != nullptr)
+	{
+		WriteVarint(Data, *Index);
+		return;
+	}
+
+	// index one past the last known string means a new one follows
+	const int32 NewIndex = Strings.Num();
+	Strings.Add(String, NewIndex);
+	WriteVarint(Data, NewIndex);
+
+	FTCHARToUTF8 Utf8String(*String);
+	WriteVarint(Data, Utf8String.Length());
+	WriteRaw(Data, Utf8String.Get(), Utf8String.Length());
+}
+
+void FStrategyReplayRecorder::RecordTap(const AStrategyGameState* GameState, const AActor* Target)
+{
+	if (!bFinished && Target != nullptr)
+	{
+		BeginRecord(GameState, FStrategyReplay::Record_Tap);
+		WriteTarget(Target);
+	}
+}
+
+void FStrategyReplayRecorder::RecordUpgrade(const AStrategyGameState* GameState, const AStrategyBuilding* Target, const UClass* NewBuildingClass)
+{
+	if (!bFinished && Target != nullptr && NewBuildingClass != nullptr)
+	{
+		BeginRecord(GameState, FStrategyReplay::Record_Upgrade);
+		WriteTarget(Target);
+		WriteString(NewBuildingClass->GetPathName());
+	}
+}
+
+void FStrategyReplayRecorder::RecordSpawnDwarf(const AStrategyGameState* GameState)
+{
+	if (!bFinished)
+	{
+		BeginRecord(GameState, FStrategyReplay::Record_SpawnDwarf);
+	}
+}
+
+void FStrategyReplayRecorder::OnStep(const AStrategyGameState* GameState)
+{
+	if (!bFinished && GameState->GetSimulationClock().GetStepCount() % FStrategyReplay::ChecksumInterval == 0)
+	{
+		const uint32 Checksum = FStrategyReplay::ComputeChecksum(GameState);
+		BeginRecord(GameState, FStrategyReplay::Record_Checksum);
+		WriteRaw(Data, &Checksum, sizeof(Checksum));
+	}
+}
+
+void FStrategyReplayRecorder::WaitForRealTime(const AStrategyGameState* GameState)
+{
+	// unattended recordings run as fast as they can
+	if (FApp::IsUnattended())
+	{
+		return;
+	}
+
+	const FStrategySimulationClock& Clock = GameState->GetSimulationClock();
+	const double Ahead = Clock.GetTime() - (FPlatformTime::Seconds() - RealTimeOrigin);
+	if (Ahead > 0.0)
+	{
+		FPlatformProcess::Sleep(float(Ahead));
+	}
+	else if (Ahead < -Clock.GetStepDelta())
+	{
+		// fell behind (e.g. paused or hitched), don't rush to catch up
+		RealTimeOrigin = FPlatformTime::Seconds() - Clock.GetTime();
+	}
+}
+
+void FStrategyReplayRecorder::Finish(const AStrategyGameState* GameState)
+{
+	if (bFinished)
+	{
+		return;
+	}
+	bFinished = true;
+
+	BeginRecord(GameState, FStrategyReplay::Record_End);
+	if (FFileHelper::SaveArrayToFile(Data, *Path))
+	{
+		UE_LOG(LogGame, Log, TEXT("Replay saved to %s, %d bytes"), *Path, Data.Num());
+	}
+	else
+	{
+		UE_LOG(LogGame, Error, TEXT("Can't write replay %s"), *Path);
+	}
+}
+
+FStrategyReplayPlayer::FStrategyReplayPlayer()
+	: Offset(0)
+	, NextRecordStep(0)
+	, NextRecordType(FStrategyReplay::Record_End)
+	, Seed(0)
+	, Step(0.0f)
+	, bFixedStep(false)
+	, bFinished(true)
+	, bDiverged(false)
+{
+}
+
+bool FStrategyReplayPlayer::Load(const FString& Path)
+{
+	if (!FFileHelper::LoadFileToArray(Data, *Path))
+	{
+		return false;
+	}
+
+	Offset = 0;
+	if (ReadUInt32() != FStrategyReplay::Magic)
+	{
+		return false;
+	}
+
+	const uint16 Version = uint16(ReadByte()) | (uint16(ReadByte()) << 8);
+	if (Version != FStrategyReplay::Version)
+	{
+		UE_LOG(LogGame, Error, TEXT("Replay %s has version %d, expected %d"), *Path, Version, FStrategyReplay::Version);
+		return false;
+	}
+
+	Seed = int32(ReadUInt32());
+	bFixedStep = ReadByte() != 0;
+	const uint32 StepBits = ReadUInt32();
+	FMemory::Memcpy(&Step, &StepBits, sizeof(Step));
+	if (ReadVarint() != FStrategyReplay::ChecksumInterval)
+	{
+		return false;
+	}
+	MapName = ReadString();
+
+	bFinished = false;
+	bDiverged = false;
+	NextRecordStep = 0;
+	ReadRecordHeader();
+
+	UE_LOG(LogGame, Log, TEXT("Playing replay %s, %d bytes, map %s, seed %d"), *Path, Data.Num(), *MapName, Seed);
+	return true;
+}
+
+void FStrategyReplayPlayer::OnPreStep(AStrategyGameState* GameState)
+{
+	const int64 CurrentStep = GameState->GetSimulationClock().GetStepCount();
+	while (!bFinished && NextRecordStep <= CurrentStep && NextRecordType != FStrategyReplay::Record_Checksum)
+	{
+		RunRecord(GameState);
+	}
+}
+
+void FStrategyReplayPlayer::OnPostStep(AStrategyGameState* GameState)
+{
+	const int64 CurrentStep = GameState->GetSimulationClock().GetStepCount();
+	while (!bFinished && NextRecordStep <= CurrentStep && NextRecordType == FStrategyReplay::Record_Checksum)
+	{
+		RunRecord(GameState);
+	}
+}
+
+void FStrategyReplayPlayer::RunRecord(AStrategyGameState* GameState)
+{
+	switch (NextRecordType)
+	{
+		case FStrategyReplay::Record_Tap:
+		{
+			AActor* const Target = ReadTarget(GameState);
+			if (Target != nullptr && Target->GetClass()->ImplementsInterface(UStrategyInputInterface::StaticClass()))
+			{
+				IStrategyInputInterface::Execute_OnInputTap(Target);
+			}
+			else
+			{
+				UE_LOG(LogGame, Warning, TEXT("Replay: tap target missing at step %lld"), NextRecordStep);
+			}
+			break;
+		}
+		case FStrategyReplay::Record_Upgrade:
+		{
+			AStrategyBuilding* const Target = Cast<AStrategyBuilding>(ReadTarget(GameState));
+			const FString ClassPath = ReadString();
+			UClass* const NewBuildingClass = LoadClass<AStrategyBuilding>(nullptr, *ClassPath);
+			if (Target == nullptr || NewBuildingClass == nullptr || !Target->RequestUpgrade(NewBuildingClass))
+			{
+				UE_LOG(LogGame, Warning, TEXT("Replay: upgrade to %s failed at step %lld"), *ClassPath, NextRecordStep);
+			}
+			break;
+		}
+		case FStrategyReplay::Record_SpawnDwarf:
+		{
+			FPlayerData* const PlayerData = GameState->GetPlayerData(EStrategyTeam::Player);
+			if (PlayerData != nullptr && PlayerData->Brewery.IsValid())
+			{
+				PlayerData->Brewery->SpawnDwarf();
+			}
+			break;
+		}
+		case FStrategyReplay::Record_Checksum:
+		{
+			const uint32 Recorded = ReadUInt32();
+			const uint32 Checksum = FStrategyReplay::ComputeChecksum(GameState);
+			if (Checksum != Recorded && !bDiverged)
+			{
+				bDiverged = true;
+				UE_LOG(LogGame, Error, TEXT("Replay diverged at step %lld (%.2f s): checksum %08x, recorded %08x"),
+					NextRecordStep, GameState->GetSimulationTime(), Checksum, Recorded);
+			}
+			break;
+		}
+		default:
+		{
+			bFinished = true;
+			return;
+		}
+	}
+
+	ReadRecordHeader();
+}
+
+void FStrategyReplayPlayer::ReadRecordHeader()
+{
+	if (Offset >= Data.Num())
+	{
+		bFinished = true;
+		return;
+	}
+
+	NextRecordType = ReadByte();
+	NextRecordStep += int64(ReadVarint());
+}
+
+AActor* FStrategyReplayPlayer::ReadTarget(AStrategyGameState* GameState)
+{
+	const FString Name = ReadString();
+	FVector Location;
+	Location.X = ReadZigZag();
+	Location.Y = ReadZigZag();
+	Location.Z = ReadZigZag();
+
+	// actors placed in the level keep their names
+	AActor* const Actor = FindObject<AActor>(GameState->GetWorld()->PersistentLevel, *Name);
+	if (Actor != nullptr && !Actor->IsPendingKill())
+	{
+		return Actor;
+	}
+
+	// spawned buildings are named differently on each run, but replacements take the same spot
+	AActor* BestActor = nullptr;
+	float BestDistSq = FMath::Square(MaxTargetDistance);
+	for (uint8 Team = 0; Team < EStrategyTeam::MAX; Team++)
+	{
+		const FPlayerData* const TeamData = GameState->GetPlayerData(Team);
+		if (TeamData == nullptr)
+		{
+			continue;
+		}
+
+		for (const TWeakObjectPtr<AActor>& Building : TeamData->BuildingsList)
+		{
+			if (Building.IsValid() && !Building->IsPendingKill())
+			{
+				const float DistSq = FVector::DistSquared(Building->GetActorLocation(), Location);
+				if (DistSq < BestDistSq)
+				{
+					BestDistSq = DistSq;
+					BestActor = Building.Get();
+				}
+			}
+		}
+	}
+
+	return BestActor;
+}
+
+uint8 FStrategyReplayPlayer::ReadByte()
+{
+	// truncated file reads as zeroes, which is the end record
+	return Offset < Data.Num() ? Data[Offset++] : 0;
+}
+
+uint64 FStrategyReplayPlayer::ReadVarint()
+{
+	uint64 Value = 0;
+	for (int32 Shift = 0; Shift < 64; Shift += 7)
+	{
+		const uint8 Byte = ReadByte();
+		Value |= uint64(Byte & 0x7f) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			break;
+		}
+	}
+	return Value;
+}
+
+int64 FStrategyReplayPlayer::ReadZigZag()
+{
+	const uint64 Value = ReadVarint();
+	return int64(Value >> 1) ^ -int64(Value & 1);
+}
+
+uint32 FStrategyReplayPlayer::ReadUInt32()
+{
+	uint32 Value = 0;
+	for (int32 Shift = 0; Shift < 32; Shift += 8)
+	{
+		Value |= uint32(ReadByte()) << Shift;
+	}
+	return Value;
+}
+
+FString FStrategyReplayPlayer::ReadString()
+{
+	const int32 Index = int32(ReadVarint());
+	if (Strings.IsValidIndex(Index))
+	{
+		return Strings[Index];
+	}
+
+	const int32 Length = FMath::Min(int32(ReadVarint()), Data.Num() - Offset);
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Data.GetData() + Offset), Length);
+	Offset += Length;
+
+	Strings.Add(FString(Converted.Length(), Converted.Get()));
+	return Strings.Last();
+}
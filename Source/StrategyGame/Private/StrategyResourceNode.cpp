@@ -2,11 +2,13 @@
 
 #include "StrategyGame.h"
 #include "StrategyResourceNode.h"
+#include "StrategyClassStatTable.h"
 
 
 AStrategyResourceNode::AStrategyResourceNode(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, NumResources(100)
+	, ClassStatsIndex(INDEX_NONE)
 {
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.bStartWithTickEnabled = true;
@@ -23,6 +25,7 @@ void AStrategyResourceNode::OnInputTap_Implementation()
 		{
 			TeamData->ResourcesAvailable += NumResources;
 			TeamData->ResourcesGathered += NumResources;
+			MyGameState->NotifyResourcesChanged(EStrategyTeam::Player);
 		}
 
 		NumResources = 0;
@@ -32,7 +35,7 @@ void AStrategyResourceNode::OnInputTap_Implementation()
 
 void AStrategyResourceNode::ResetResource(bool UnhideInGame)
 {
-	NumResources = GetClass()->GetDefaultObject<AStrategyResourceNode>()->NumResources;
+	NumResources = FStrategyClassStatTable::GetStats(this, ClassStatsIndex).Resources;
 	if (UnhideInGame)
 	{
 		SetActorHiddenInGame(false);
@@ -47,5 +50,5 @@ int32 AStrategyResourceNode::GetAvailableResources() const
 
 int32 AStrategyResourceNode::GetInitialResources() const
 {
-	return GetClass()->GetDefaultObject<AStrategyResourceNode>()->GetAvailableResources();
+	return FStrategyClassStatTable::GetStats(this, ClassStatsIndex).Resources;
 }
@@ -0,0 +1,66 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategySimulationClock.h"
+
+/** a hitch shouldn't make the simulation spiral trying to catch up */
+static const int32 MaxStepsPerFrame = 8;
+
+FStrategySimulationClock::FStrategySimulationClock()
+{
+	Reset(false, 1.0f / 30.0f, 0);
+}
+
+void FStrategySimulationClock::Reset(bool bInFixedStep, float InStep, int32 InSeed)
+{
+	bFixedStep = bInFixedStep && InStep > 0.0f;
+	Step = FMath::Max(InStep, KINDA_SMALL_NUMBER);
+	StepDelta = bFixedStep ? Step : 0.0f;
+	Time = 0.0;
+	Accumulator = 0.0;
+	StepCount = 0;
+	Seed = InSeed;
+	Random.Initialize(InSeed);
+}
+
+void FStrategySimulationClock::Restore(double InTime, int64 InStepCount, int32 InRandomState)
+{
+	Time = InTime;
+	Accumulator = 0.0;
+	StepCount = InStepCount;
+	Random.Initialize(InRandomState);
+}
+
+int32 FStrategySimulationClock::Advance(float DeltaSeconds)
+{
+	if (!bFixedStep)
+	{
+		StepDelta = DeltaSeconds;
+		Time += DeltaSeconds;
+		StepCount++;
+		return 1;
+	}
+
+	Accumulator += DeltaSeconds;
+	int32 NumSteps = FMath::FloorToInt(Accumulator / Step);
+	if (NumSteps > MaxStepsPerFrame)
+	{
+		NumSteps = MaxStepsPerFrame;
+		Accumulator = NumSteps * Step;
+	}
+
+	Accumulator -= NumSteps * Step;
+	StepCount += NumSteps;
+	Time = StepCount * double(Step);
+	return NumSteps;
+}
+
+float FStrategySimulationClock::GetAlpha() const
+{
+	return bFixedStep ? FMath::Clamp(float(Accumulator / Step), 0.0f, 1.0f) : 0.0f;
+}
+
+float FStrategySimulationClock::GetInterpolatedTime() const
+{
+	return float(Time + (bFixedStep ? Accumulator : 0.0));
+}
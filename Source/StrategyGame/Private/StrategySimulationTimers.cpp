@@ -0,0 +1,101 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategySimulationTimers.h"
+
+FStrategySimulationTimers::FStrategySimulationTimers()
+	: NextId(1)
+	, NextSequence(0)
+{
+}
+
+void FStrategySimulationTimers::SetTimer(FStrategySimulationTimerHandle& InOutHandle, const FTimerDelegate& Delegate, float FirstDueTime, float Rate, bool bLoop)
+{
+	ClearTimer(InOutHandle);
+
+	FTimer Timer;
+	Timer.Delegate = Delegate;
+	Timer.Rate = (bLoop && Rate > 0.0f) ? Rate : 0.0f;
+
+	// 0 means unset
+	const uint32 Id = NextId++;
+	if (NextId == 0)
+	{
+		NextId = 1;
+	}
+	Timers.Add(Id, Timer);
+
+	FEntry Entry;
+	Entry.DueTime = FirstDueTime;
+	Entry.Sequence = NextSequence++;
+	Entry.Id = Id;
+	Heap.HeapPush(Entry);
+
+	InOutHandle.Id = Id;
+}
+
+void FStrategySimulationTimers::ClearTimer(FStrategySimulationTimerHandle& InOutHandle)
+{
+	// pending call stays in the heap and is skipped once due
+	if (InOutHandle.IsValid())
+	{
+		Timers.Remove(InOutHandle.Id);
+		InOutHandle.Invalidate();
+	}
+}
+
+bool FStrategySimulationTimers::IsTimerActive(const FStrategySimulationTimerHandle& Handle) const
+{
+	return Handle.IsValid() && Timers.Contains(Handle.Id);
+}
+
+void FStrategySimulationTimers::Tick(float CurrentTime)
+{
+	while (Heap.Num() > 0 && Heap.HeapTop().DueTime <= CurrentTime)
+	{
+		FEntry Entry;
+		Heap.HeapPop(Entry, /*bAllowShrinking=*/false);
+
+		const FTimer* const Timer = Timers.Find(Entry.Id);
+		if (Timer == nullptr)
+		{
+			continue;
+		}
+
+		if (!Timer->Delegate.IsBound())
+		{
+			Timers.Remove(Entry.Id);
+			continue;
+		}
+
+		// copied, the call may set or clear timers
+		const FTimerDelegate Delegate = Timer->Delegate;
+		if (Timer->Rate > 0.0f)
+		{
+			Entry.DueTime += Timer->Rate;
+			Entry.Sequence = NextSequence++;
+			Heap.HeapPush(Entry);
+		}
+		else
+		{
+			Timers.Remove(Entry.Id);
+		}
+
+		Delegate.Execute();
+	}
+}
+
+void FStrategySimulationTimers::ShiftTimes(float Delta)
+{
+	// same shift for all keeps heap order
+	for (FEntry& Entry : Heap)
+	{
+		Entry.DueTime += Delta;
+	}
+}
+
+void FStrategySimulationTimers::Reset()
+{
+	Heap.Reset();
+	Timers.Reset();
+}
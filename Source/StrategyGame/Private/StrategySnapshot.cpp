@@ -0,0 +1,712 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategySnapshot.h"
+#include "StrategyBuilding.h"
+#include "StrategyBuilding_Brewery.h"
+#include "StrategyAIDirector.h"
+#include "StrategyAIController.h"
+#include "StrategyAIAction.h"
+#include "StrategyAttachment.h"
+#include "StrategyProjectile.h"
+#include "StrategyGameBlueprintLibrary.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+
+/** sections start at this alignment, so records can be read straight from the mapped file */
+static const int32 SectionAlignment = 16;
+
+/** how far a building in the level may be from the saved location */
+static const float MaxBuildingDistance = 100.0f;
+
+struct FSnapshotSection
+{
+	uint32 Offset;
+	uint32 Count;
+	uint32 Stride;
+	uint32 Reserved;
+};
+
+struct FSnapshotHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 TotalSize;
+	uint32 NumSections;
+	FSnapshotSection Sections[FStrategySnapshot::Section_MAX];
+};
+
+struct FSnapshotMatch
+{
+	double SimulationTime;
+	int64 StepCount;
+	int32 RandomState;
+	float WarmupRemaining;
+	uint8 GameplayState;
+	uint8 WinningTeam;
+	uint8 Difficulty;
+	uint8 Reserved;
+};
+
+/** FPawnData without the reflection data, so the file doesn't change with the struct */
+struct FSnapshotPawnData
+{
+	int32 AttackMin;
+	int32 AttackMax;
+	int32 AttackDistance;
+	int32 DamageReduction;
+	int32 MaxHealthBonus;
+	int32 HealthRegen;
+	float Speed;
+
+	void From(const FPawnData& Data)
+	{
+		AttackMin = Data.AttackMin;
+		AttackMax = Data.AttackMax;
+		AttackDistance = Data.AttackDistance;
+		DamageReduction = Data.DamageReduction;
+		MaxHealthBonus = Data.MaxHealthBonus;
+		HealthRegen = Data.HealthRegen;
+		Speed = Data.Speed;
+	}
+
+	void To(FPawnData& Data) const
+	{
+		Data.AttackMin = AttackMin;
+		Data.AttackMax = AttackMax;
+		Data.AttackDistance = AttackDistance;
+		Data.DamageReduction = DamageReduction;
+		Data.MaxHealthBonus = MaxHealthBonus;
+		Data.HealthRegen = HealthRegen;
+		Data.Speed = Speed;
+	}
+};
+
+/** one per team, index is the team number */
+struct FSnapshotTeam
+{
+	uint32 ResourcesAvailable;
+	uint32 ResourcesGathered;
+	uint32 DamageDone;
+	int32 WaveSize;
+	float NextSpawnRemaining;
+	int32 SpawnOffsetIndex;
+	uint8 NumberOfLives;
+	uint8 bHasBrewery;
+	uint8 Reserved[2];
+};
+
+struct FSnapshotBuilding
+{
+	FVector Location;
+	int32 Class;
+	int32 Health;
+	float InitialBuildTime;
+	float RemainingBuildTime;
+	uint8 Team;
+	uint8 bIsBeingBuild;
+	uint8 bIsContructionFinished;
+	uint8 Reserved;
+};
+
+struct FSnapshotChar
+{
+	FVector Location;
+	FVector Velocity;
+	FVector CapsuleScale;
+	float Yaw;
+	float CapsuleRadius;
+	float CapsuleHalfHeight;
+	float AnimRate;
+	float Health;
+	int32 Class;
+	int32 WeaponClass;
+	int32 ArmorClass;
+	int32 ActionClass;
+	FSnapshotPawnData BuffDelta;
+	uint32 FirstBuff;
+	uint32 NumBuffs;
+	uint8 Team;
+	uint8 bLogicEnabled;
+	uint8 Reserved[2];
+};
+
+/** time limited buff, infinite ones are only part of the char's BuffDelta */
+struct FSnapshotBuff
+{
+	FSnapshotPawnData Data;
+	float Remaining;
+};
+
+struct FSnapshotProjectile
+{
+	FVector Location;
+	FVector Velocity;
+	int32 Class;
+	int32 RemainingDamage;
+	float LifeSpan;
+	uint8 Team;
+	uint8 Reserved[3];
+};
+
+/** size of a record in each section */
+static const uint32 SectionStrides[FStrategySnapshot::Section_MAX] =
+{
+	sizeof(FSnapshotMatch),
+	sizeof(FSnapshotTeam),
+	sizeof(FSnapshotBuilding),
+	sizeof(FSnapshotChar),
+	sizeof(FSnapshotBuff),
+	sizeof(FSnapshotProjectile),
+	sizeof(uint32),
+	sizeof(ANSICHAR),
+};
+
+/** builds the file in memory, sections are appended in order */
+struct FSnapshotWriter
+{
+	FSnapshotWriter()
+	{
+		Data.AddZeroed(sizeof(FSnapshotHeader));
+		FMemory::Memzero(Header);
+		Header.Magic = FStrategySnapshot::Magic;
+		Header.Version = FStrategySnapshot::Version;
+		Header.NumSections = FStrategySnapshot::Section_MAX;
+	}
+
+	/** @returns index of class in class table, INDEX_NONE for null */
+	int32 GetClassIndex(const UClass* Class)
+	{
+		if (Class == nullptr)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32* const Existing = ClassIndices.Find(Class);
+		if (Existing != nullptr)
+		{
+			return *Existing;
+		}
+
+		const int32 Index = ClassOffsets.Add(ClassNames.Num());
+		FTCHARToUTF8 PathName(*Class->GetPathName());
+		ClassNames.Append(PathName.Get(), PathName.Length());
+		ClassNames.Add('\0');
+		ClassIndices.Add(Class, Index);
+		return Index;
+	}
+
+	template<typename T>
+	void WriteSection(FStrategySnapshot::ESection Section, const TArray<T>& Records)
+	{
+		check(SectionStrides[Section] == sizeof(T));
+
+		const int32 Offset = Align(Data.Num(), SectionAlignment);
+		const int32 Size = Records.Num() * sizeof(T);
+		Data.AddZeroed(Offset + Size - Data.Num());
+		FMemory::Memcpy(Data.GetData() + Offset, Records.GetData(), Size);
+
+		FSnapshotSection& Entry = Header.Sections[Section];
+		Entry.Offset = Offset;
+		Entry.Count = Records.Num();
+		Entry.Stride = sizeof(T);
+	}
+
+	/** write class table and header */
+	void Finish()
+	{
+		WriteSection(FStrategySnapshot::Section_ClassOffsets, ClassOffsets);
+		WriteSection(FStrategySnapshot::Section_ClassNames, ClassNames);
+
+		Header.TotalSize = Data.Num();
+		FMemory::Memcpy(Data.GetData(), &Header, sizeof(Header));
+	}
+
+	TArray<uint8> Data;
+	FSnapshotHeader Header;
+	TMap<const UClass*, int32> ClassIndices;
+	TArray<uint32> ClassOffsets;
+	TArray<ANSICHAR> ClassNames;
+};
+
+/** validated view of a snapshot in memory */
+struct FSnapshotReader
+{
+	FSnapshotReader(const uint8* InData, int64 InSize)
+		: Data(InData)
+		, Size(InSize)
+		, Header(reinterpret_cast<const FSnapshotHeader*>(InData))
+	{
+	}
+
+	/** check header and that every section is inside the file, records themselves are trusted */
+	bool IsValid() const
+	{
+		if (Data == nullptr || Size < int64(sizeof(FSnapshotHeader)) || Header->Magic != FStrategySnapshot::Magic
+			|| Header->Version != FStrategySnapshot::Version || Header->TotalSize != Size || Header->NumSections != FStrategySnapshot::Section_MAX)
+		{
+			return false;
+		}
+
+		for (int32 i = 0; i < FStrategySnapshot::Section_MAX; i++)
+		{
+			const FSnapshotSection& Entry = Header->Sections[i];
+			if (Entry.Stride != SectionStrides[i] || Entry.Offset % SectionAlignment != 0
+				|| int64(Entry.Offset) + int64(Entry.Count) * Entry.Stride > Size)
+			{
+				return false;
+			}
+		}
+
+		const TArrayView<const ANSICHAR> ClassNames = GetSection<ANSICHAR>(FStrategySnapshot::Section_ClassNames);
+		for (uint32 ClassOffset : GetSection<uint32>(FStrategySnapshot::Section_ClassOffsets))
+		{
+			if (ClassOffset >= uint32(ClassNames.Num()))
+			{
+				return false;
+			}
+		}
+		return ClassNames.Num() == 0 || ClassNames[ClassNames.Num() - 1] == '\0';
+	}
+
+	template<typename T>
+	TArrayView<const T> GetSection(FStrategySnapshot::ESection Section) const
+	{
+		const FSnapshotSection& Entry = Header->Sections[Section];
+		return TArrayView<const T>(reinterpret_cast<const T*>(Data + Entry.Offset), Entry.Count);
+	}
+
+	/** load every class in the table, unknown ones are null */
+	void ResolveClasses(TArray<UClass*>& OutClasses) const
+	{
+		const TArrayView<const ANSICHAR> ClassNames = GetSection<ANSICHAR>(FStrategySnapshot::Section_ClassNames);
+		for (uint32 ClassOffset : GetSection<uint32>(FStrategySnapshot::Section_ClassOffsets))
+		{
+			const FString PathName = UTF8_TO_TCHAR(ClassNames.GetData() + ClassOffset);
+			UClass* const Class = LoadObject<UClass>(nullptr, *PathName);
+			UE_CLOG(Class == nullptr, LogGame, Warning, TEXT("Snapshot class %s not found"), *PathName);
+			OutClasses.Add(Class);
+		}
+	}
+
+	const uint8* Data;
+	int64 Size;
+	const FSnapshotHeader* Header;
+};
+
+/** @returns class from resolved class table, null if missing or not derived from BaseClass */
+static UClass* GetSnapshotClass(const TArray<UClass*>& Classes, int32 Index, const UClass* BaseClass)
+{
+	return Classes.IsValidIndex(Index) && Classes[Index] && Classes[Index]->IsChildOf(BaseClass) ? Classes[Index] : nullptr;
+}
+
+/** buildings the player sees, ones being replaced are skipped */
+static void GetLevelBuildings(UWorld* World, TArray<AStrategyBuilding*>& OutBuildings)
+{
+	for (AStrategyBuilding* const Building : FStrategyUnitRegistry::SlowActorRange<AStrategyBuilding>(World))
+	{
+		if (!Building->IsPendingKill() && Building->GetLifeSpan() <= 0.0f)
+		{
+			OutBuildings.Add(Building);
+		}
+	}
+}
+
+bool FStrategySnapshot::Save(AStrategyGameState* GameState, const FString& Path)
+{
+	UWorld* const World = GameState ? GameState->GetWorld() : nullptr;
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const float SimulationTime = GameState->GetSimulationTime();
+	FSnapshotWriter Writer;
+
+	TArray<FSnapshotMatch> Match;
+	FSnapshotMatch& MatchRecord = Match[Match.AddZeroed()];
+	MatchRecord.SimulationTime = SimulationTime;
+	MatchRecord.StepCount = GameState->SimulationClock.GetStepCount();
+	MatchRecord.RandomState = GameState->GetRandomStream().GetCurrentSeed();
+	MatchRecord.WarmupRemaining = GameState->GetRemainingWaitTime();
+	MatchRecord.GameplayState = GameState->GameplayState;
+	MatchRecord.WinningTeam = GameState->WinningTeam;
+	MatchRecord.Difficulty = GameState->GameDifficulty;
+	Writer.WriteSection(Section_Match, Match);
+
+	TArray<FSnapshotTeam> Teams;
+	Teams.AddZeroed(GameState->PlayersData.Num());
+	for (int32 TeamNum = 0; TeamNum < Teams.Num(); TeamNum++)
+	{
+		const FPlayerData& TeamData = GameState->PlayersData[TeamNum];
+		FSnapshotTeam& Team = Teams[TeamNum];
+		Team.ResourcesAvailable = TeamData.ResourcesAvailable;
+		Team.ResourcesGathered = TeamData.ResourcesGathered;
+		Team.DamageDone = TeamData.DamageDone;
+
+		const AStrategyBuilding_Brewery* const Brewery = TeamData.Brewery.Get();
+		const UStrategyAIDirector* const Director = Brewery ? Brewery->GetAIDirector() : nullptr;
+		if (Director != nullptr)
+		{
+			Team.bHasBrewery = true;
+			Team.NumberOfLives = Brewery->GetNumberOfLives();
+			Team.WaveSize = Director->WaveSize;
+			Team.NextSpawnRemaining = Director->NextSpawnTime - SimulationTime;
+			Team.SpawnOffsetIndex = Director->SpawnOffsetIndex;
+		}
+	}
+	Writer.WriteSection(Section_Teams, Teams);
+
+	TArray<AStrategyBuilding*> LevelBuildings;
+	GetLevelBuildings(World, LevelBuildings);
+
+	TArray<FSnapshotBuilding> Buildings;
+	Buildings.AddZeroed(LevelBuildings.Num());
+	for (int32 i = 0; i < LevelBuildings.Num(); i++)
+	{
+		const AStrategyBuilding* const Building = LevelBuildings[i];
+		FSnapshotBuilding& Record = Buildings[i];
+		Record.Location = Building->GetActorLocation();
+		Record.Class = Writer.GetClassIndex(Building->GetClass());
+		Record.Health = Building->Health;
+		Record.InitialBuildTime = Building->InitialBuildTime;
+		Record.RemainingBuildTime = Building->GetRemainingBuildTime();
+		Record.Team = Building->MyTeamNum;
+		Record.bIsBeingBuild = Building->bIsBeingBuild;
+		Record.bIsContructionFinished = Building->bIsContructionFinished;
+	}
+	Writer.WriteSection(Section_Buildings, Buildings);
+
+	TArray<FSnapshotChar> Chars;
+	TArray<FSnapshotBuff> Buffs;
+	for (AStrategyChar* const Char : GameState->GetUnitRegistry().GetChars())
+	{
+		if (Char == nullptr || Char->bIsDying || Char->IsPendingKill())
+		{
+			continue;
+		}
+
+		FSnapshotChar& Record = Chars[Chars.AddZeroed()];
+		Record.Location = Char->GetActorLocation();
+		Record.Velocity = Char->GetVelocity();
+		Record.CapsuleScale = Char->GetCapsuleComponent()->GetRelativeScale3D();
+		Record.Yaw = Char->GetActorRotation().Yaw;
+		Record.CapsuleRadius = Char->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+		Record.CapsuleHalfHeight = Char->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+		Record.AnimRate = Char->GetMesh()->GlobalAnimRateScale;
+		Record.Health = Char->Health;
+		Record.Class = Writer.GetClassIndex(Char->GetClass());
+		Record.WeaponClass = Writer.GetClassIndex(Char->WeaponSlot ? Char->WeaponSlot->GetClass() : nullptr);
+		Record.ArmorClass = Writer.GetClassIndex(Char->ArmorSlot ? Char->ArmorSlot->GetClass() : nullptr);
+		Record.ActionClass = INDEX_NONE;
+		Record.BuffDelta.From(Char->BuffDelta);
+		Record.Team = Char->MyTeamNum;
+
+		const AStrategyAIController* const AIController = Cast<AStrategyAIController>(Char->GetController());
+		if (AIController != nullptr)
+		{
+			Record.bLogicEnabled = AIController->IsLogicEnabled();
+			Record.ActionClass = Writer.GetClassIndex(AIController->CurrentAction ? AIController->CurrentAction->GetClass() : nullptr);
+		}
+
+		Record.FirstBuff = Buffs.Num();
+		Record.NumBuffs = Char->ActiveBuffs.Num();
+		for (const FBuffData& ActiveBuff : Char->ActiveBuffs)
+		{
+			FSnapshotBuff& Buff = Buffs[Buffs.AddZeroed()];
+			Buff.Data.From(ActiveBuff.BuffData);
+			Buff.Remaining = ActiveBuff.EndTime - SimulationTime;
+		}
+	}
+	Writer.WriteSection(Section_Chars, Chars);
+	Writer.WriteSection(Section_Buffs, Buffs);
+
+	TArray<FSnapshotProjectile> Projectiles;
+	for (AStrategyProjectile* const Projectile : FStrategyUnitRegistry::SlowActorRange<AStrategyProjectile>(World))
+	{
+		if (Projectile->IsPendingKill() || !Projectile->bInitialized)
+		{
+			continue;
+		}
+
+		FSnapshotProjectile& Record = Projectiles[Projectiles.AddZeroed()];
+		Record.Location = Projectile->GetActorLocation();
+		Record.Velocity = Projectile->GetMovementComp()->Velocity;
+		Record.Class = Writer.GetClassIndex(Projectile->GetClass());
+		Record.RemainingDamage = Projectile->RemainingDamage;
+		Record.LifeSpan = Projectile->GetLifeSpan();
+		Record.Team = Projectile->MyTeamNum;
+	}
+	Writer.WriteSection(Section_Projectiles, Projectiles);
+
+	Writer.Finish();
+	if (!FFileHelper::SaveArrayToFile(Writer.Data, *Path))
+	{
+		UE_LOG(LogGame, Error, TEXT("Can't write snapshot %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogGame, Log, TEXT("Snapshot saved to %s: %d buildings, %d chars, %d projectiles, %d bytes in %.2f ms"),
+		*Path, Buildings.Num(), Chars.Num(), Projectiles.Num(), Writer.Data.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+bool FStrategySnapshot::Restore(AStrategyGameState* GameState, const FString& Path)
+{
+	UWorld* const World = GameState ? GameState->GetWorld() : nullptr;
+	if (World == nullptr)
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// map the file and read records in place, whole file is read only if mapping isn't supported
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*Path));
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile.IsValid() ? MappedFile->MapRegion() : nullptr);
+	TArray<uint8> FileData;
+	if (!MappedRegion.IsValid() && !FFileHelper::LoadFileToArray(FileData, *Path))
+	{
+		UE_LOG(LogGame, Error, TEXT("Can't read snapshot %s"), *Path);
+		return false;
+	}
+
+	const FSnapshotReader Reader(MappedRegion.IsValid() ? MappedRegion->GetMappedPtr() : FileData.GetData(),
+		MappedRegion.IsValid() ? MappedRegion->GetMappedSize() : FileData.Num());
+	if (!Reader.IsValid())
+	{
+		UE_LOG(LogGame, Error, TEXT("%s is not a snapshot of version %u"), *Path, Version);
+		return false;
+	}
+
+	const TArrayView<const FSnapshotMatch> Match = Reader.GetSection<FSnapshotMatch>(Section_Match);
+	const TArrayView<const FSnapshotTeam> Teams = Reader.GetSection<FSnapshotTeam>(Section_Teams);
+	const TArrayView<const FSnapshotBuilding> Buildings = Reader.GetSection<FSnapshotBuilding>(Section_Buildings);
+	const TArrayView<const FSnapshotChar> Chars = Reader.GetSection<FSnapshotChar>(Section_Chars);
+	const TArrayView<const FSnapshotBuff> Buffs = Reader.GetSection<FSnapshotBuff>(Section_Buffs);
+	const TArrayView<const FSnapshotProjectile> Projectiles = Reader.GetSection<FSnapshotProjectile>(Section_Projectiles);
+	if (Match.Num() != 1 || Teams.Num() != GameState->PlayersData.Num())
+	{
+		UE_LOG(LogGame, Error, TEXT("Snapshot %s doesn't match this game"), *Path);
+		return false;
+	}
+
+	TArray<UClass*> Classes;
+	Reader.ResolveClasses(Classes);
+
+	// everything that moves is spawned again
+	for (AStrategyChar* const Char : FStrategyUnitRegistry::SlowActorRange<AStrategyChar>(World))
+	{
+		if (Char->Controller != nullptr && !Char->IsPlayerControlled())
+		{
+			Char->Controller->Destroy();
+		}
+		Char->Destroy();
+	}
+	for (AStrategyProjectile* const Projectile : FStrategyUnitRegistry::SlowActorRange<AStrategyProjectile>(World))
+	{
+		Projectile->Destroy();
+	}
+
+	// state change notifies the breweries and draws from the random stream, so it goes before the clock
+	const FSnapshotMatch& MatchRecord = Match[0];
+	World->GetTimerManager().ClearTimer(GameState->TimerHandle_OnGameStart);
+	GameState->WinningTeam = EStrategyTeam::Type(MatchRecord.WinningTeam);
+	GameState->SetGameplayState(EGameplayState::Type(MatchRecord.GameplayState));
+	GameState->GameDifficulty = EGameDifficulty::Type(MatchRecord.Difficulty);
+	const float TimeBeforeRestore = GameState->GetSimulationTime();
+	GameState->SimulationClock.Restore(MatchRecord.SimulationTime, MatchRecord.StepCount, MatchRecord.RandomState);
+	GameState->SimulationTimers.ShiftTimes(GameState->GetSimulationTime() - TimeBeforeRestore);
+	if (GameState->GameplayState == EGameplayState::Waiting)
+	{
+		World->GetTimerManager().SetTimer(GameState->TimerHandle_OnGameStart, GameState, &AStrategyGameState::OnGameStart, FMath::Max(MatchRecord.WarmupRemaining, KINDA_SMALL_NUMBER), false);
+	}
+
+	const float SimulationTime = GameState->GetSimulationTime();
+	for (int32 TeamNum = 0; TeamNum < Teams.Num(); TeamNum++)
+	{
+		const FSnapshotTeam& Team = Teams[TeamNum];
+		FPlayerData& TeamData = GameState->PlayersData[TeamNum];
+		TeamData.ResourcesAvailable = Team.ResourcesAvailable;
+		TeamData.ResourcesGathered = Team.ResourcesGathered;
+		TeamData.DamageDone = Team.DamageDone;
+		GameState->NotifyResourcesChanged(TeamNum);
+
+		AStrategyBuilding_Brewery* const Brewery = TeamData.Brewery.Get();
+		UStrategyAIDirector* const Director = Brewery ? Brewery->GetAIDirector() : nullptr;
+		if (Team.bHasBrewery && Director != nullptr)
+		{
+			Brewery->SetNumberOfLives(Team.NumberOfLives);
+			Director->WaveSize = Team.WaveSize;
+			Director->NextSpawnTime = SimulationTime + Team.NextSpawnRemaining;
+			Director->SpawnOffsetIndex = Team.SpawnOffsetIndex;
+			Brewery->NotifySpawnQueueChanged();
+		}
+	}
+
+	// buildings stay in the level, only their class and construction state change
+	GameState->ConstructionScheduler.Reset();
+	TArray<AStrategyBuilding*> LevelBuildings;
+	GetLevelBuildings(World, LevelBuildings);
+	for (const FSnapshotBuilding& Record : Buildings)
+	{
+		int32 BestIndex = INDEX_NONE;
+		float BestDistSq = FMath::Square(MaxBuildingDistance);
+		for (int32 i = 0; i < LevelBuildings.Num(); i++)
+		{
+			const float DistSq = FVector::DistSquared(LevelBuildings[i]->GetActorLocation(), Record.Location);
+			if (DistSq <= BestDistSq)
+			{
+				BestIndex = i;
+				BestDistSq = DistSq;
+			}
+		}
+
+		UClass* const BuildingClass = GetSnapshotClass(Classes, Record.Class, AStrategyBuilding::StaticClass());
+		if (BestIndex == INDEX_NONE || BuildingClass == nullptr)
+		{
+			UE_LOG(LogGame, Warning, TEXT("Snapshot building at %s has no match in the level"), *Record.Location.ToString());
+			continue;
+		}
+
+		AStrategyBuilding* Building = LevelBuildings[BestIndex];
+		LevelBuildings.RemoveAtSwap(BestIndex);
+
+		if (Building->GetClass() != BuildingClass)
+		{
+			AStrategyBuilding* const OldBuilding = Building;
+			Building = World->SpawnActorDeferred<AStrategyBuilding>(BuildingClass, OldBuilding->GetTransform(), nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+			if (Building == nullptr)
+			{
+				continue;
+			}
+			Building->SetTeamNum(Record.Team);
+			UGameplayStatics::FinishSpawningActor(Building, OldBuilding->GetTransform());
+
+			// keep brewery upgrade slots pointing at what's in them now
+			for (FPlayerData& TeamData : GameState->PlayersData)
+			{
+				AStrategyBuilding_Brewery* const Brewery = TeamData.Brewery.Get();
+				if (Brewery != nullptr && Brewery->LeftSlot == OldBuilding)
+				{
+					Brewery->LeftSlot = Building;
+				}
+				if (Brewery != nullptr && Brewery->RightSlot == OldBuilding)
+				{
+					Brewery->RightSlot = Building;
+				}
+			}
+			OldBuilding->Destroy();
+		}
+		else if (Building->MyTeamNum != Record.Team)
+		{
+			FPlayerData* const OldTeamData = Building->GetTeamData();
+			if (OldTeamData != nullptr)
+			{
+				OldTeamData->BuildingsList.Remove(Building);
+			}
+			Building->SetTeamNum(Record.Team);
+		}
+
+		Building->Health = Record.Health;
+		Building->InitialBuildTime = Record.InitialBuildTime;
+		Building->bIsBeingBuild = Record.bIsBeingBuild;
+		Building->bIsContructionFinished = Record.bIsContructionFinished;
+		Building->BuildFinishTime = SimulationTime + Record.RemainingBuildTime;
+		if (Building->bIsBeingBuild)
+		{
+			GameState->OnBuildStarted(Building, Building->BuildFinishTime);
+		}
+		GameState->OnBuildingChanged();
+	}
+
+	int32 NumSpawnedChars = 0;
+	for (const FSnapshotChar& Record : Chars)
+	{
+		UClass* const CharClass = GetSnapshotClass(Classes, Record.Class, AStrategyChar::StaticClass());
+		if (CharClass == nullptr)
+		{
+			continue;
+		}
+
+		FActorSpawnParameters SpawnInfo;
+		SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		AStrategyChar* const Char = World->SpawnActor<AStrategyChar>(CharClass, Record.Location, FRotator(0.0f, Record.Yaw, 0.0f), SpawnInfo);
+		if (Char == nullptr || Char->bIsDying)
+		{
+			continue;
+		}
+
+		Char->SetTeamNum(Record.Team);
+		Char->SpawnDefaultController();
+		Char->GetCapsuleComponent()->SetRelativeScale3D(Record.CapsuleScale);
+		Char->GetCapsuleComponent()->SetCapsuleSize(Record.CapsuleRadius, Record.CapsuleHalfHeight);
+		Char->GetMesh()->GlobalAnimRateScale = Record.AnimRate;
+
+		UStrategyGameBlueprintLibrary::GiveWeaponFromClass(Char, GetSnapshotClass(Classes, Record.WeaponClass, UStrategyAttachment::StaticClass()));
+		UStrategyGameBlueprintLibrary::GiveArmorFromClass(Char, GetSnapshotClass(Classes, Record.ArmorClass, UStrategyAttachment::StaticClass()));
+
+		// buffs go straight into the heap, ApplyBuff would restart their duration
+		Record.BuffDelta.To(Char->BuffDelta);
+		Char->ActiveBuffs.Reset(Record.NumBuffs);
+		for (uint32 i = Record.FirstBuff; i < Record.FirstBuff + Record.NumBuffs && i < uint32(Buffs.Num()); i++)
+		{
+			FBuffData& Buff = Char->ActiveBuffs[Char->ActiveBuffs.AddDefaulted()];
+			Buffs[i].Data.To(Buff.BuffData);
+			Buff.Duration = Buffs[i].Remaining;
+			Buff.EndTime = SimulationTime + Buffs[i].Remaining;
+		}
+		Char->ActiveBuffs.Heapify();
+		Char->UpdatePawnData();
+		Char->ScheduleBuffExpiry();
+
+		// pawn data update tops up health, so saved health goes last
+		Char->Health = Record.Health;
+		Char->UpdateHealth();
+		Char->GetCharacterMovement()->Velocity = Record.Velocity;
+
+		AStrategyAIController* const AIController = Cast<AStrategyAIController>(Char->GetController());
+		if (AIController != nullptr)
+		{
+			AIController->EnableLogic(Record.bLogicEnabled != 0);
+
+			// action state is rebuilt from scratch, the action picks its target again when activated
+			UClass* const ActionClass = GetSnapshotClass(Classes, Record.ActionClass, UStrategyAIAction::StaticClass());
+			UStrategyAIAction* const Action = ActionClass ? AIController->GetInstanceOfAction(ActionClass) : nullptr;
+			if (Action != nullptr && Action->ShouldActivate())
+			{
+				AIController->CurrentAction = Action;
+				Action->Activate();
+			}
+		}
+		NumSpawnedChars++;
+	}
+
+	int32 NumSpawnedProjectiles = 0;
+	for (const FSnapshotProjectile& Record : Projectiles)
+	{
+		UClass* const ProjectileClass = GetSnapshotClass(Classes, Record.Class, AStrategyProjectile::StaticClass());
+		if (ProjectileClass == nullptr || Record.LifeSpan <= 0.0f)
+		{
+			continue;
+		}
+
+		const FTransform SpawnTransform(Record.Velocity.Rotation(), Record.Location);
+		AStrategyProjectile* const Projectile = World->SpawnActorDeferred<AStrategyProjectile>(ProjectileClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Projectile != nullptr)
+		{
+			// BeginPlay resets life span, so init goes after it
+			UGameplayStatics::FinishSpawningActor(Projectile, SpawnTransform);
+			Projectile->InitProjectile(Record.Velocity.GetSafeNormal(), Record.Team, Record.RemainingDamage, Record.LifeSpan);
+			Projectile->GetMovementComp()->Velocity = Record.Velocity;
+			NumSpawnedProjectiles++;
+		}
+	}
+
+	UE_LOG(LogGame, Log, TEXT("Snapshot %s restored%s: %d buildings, %d/%d chars, %d/%d projectiles in %.2f ms"),
+		*Path, MappedRegion.IsValid() ? TEXT(" from mapped file") : TEXT(""), Buildings.Num(), NumSpawnedChars, Chars.Num(),
+		NumSpawnedProjectiles, Projectiles.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
@@ -0,0 +1,103 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyStartupBenchmarkCommandlet.h"
+
+UStrategyStartupBenchmarkCommandlet::UStrategyStartupBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Map(TEXT("/Game/Maps/TowerDefenseMap"))
+	, NumRuns(5)
+	, MaxP90Seconds(0.0f)
+	, RunTimeoutSeconds(300.0f)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UStrategyStartupBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 Runs = NumRuns;
+	float MaxP90 = MaxP90Seconds;
+	FParse::Value(*Params, TEXT("Runs="), Runs);
+	FParse::Value(*Params, TEXT("MaxP90="), MaxP90);
+	FParse::Value(*Params, TEXT("Map="), Map);
+	Runs = FMath::Max(Runs, 1);
+
+	TArray<double> Times;
+	for (int32 RunIndex = 0; RunIndex < Runs; RunIndex++)
+	{
+		double Seconds = 0.0;
+		if (LaunchOnce(RunIndex, Seconds))
+		{
+			UE_LOG(LogGame, Display, TEXT("Startup benchmark: run %d/%d %.3f s"), RunIndex + 1, Runs, Seconds);
+			Times.Add(Seconds);
+		}
+		else
+		{
+			UE_LOG(LogGame, Error, TEXT("Startup benchmark: run %d/%d didn't reach first playable frame"), RunIndex + 1, Runs);
+		}
+	}
+
+	if (Times.Num() < Runs)
+	{
+		return 1;
+	}
+
+	Times.Sort();
+	const double P90 = GetPercentile(Times, 0.9f);
+	UE_LOG(LogGame, Display, TEXT("Startup benchmark: %s, %d runs, min %.3f s, p50 %.3f s, p90 %.3f s, p99 %.3f s, max %.3f s"),
+		*Map, Times.Num(), Times[0], GetPercentile(Times, 0.5f), P90, GetPercentile(Times, 0.99f), Times.Last());
+
+	if (MaxP90 > 0.0f && P90 > MaxP90)
+	{
+		UE_LOG(LogGame, Error, TEXT("Startup benchmark: p90 %.3f s is above threshold %.3f s"), P90, MaxP90);
+		return 1;
+	}
+
+	return 0;
+}
+
+bool UStrategyStartupBenchmarkCommandlet::LaunchOnce(int32 RunIndex, double& OutSeconds) const
+{
+	const FString ResultPath = FPaths::ConvertRelativePathToFull(FPaths::ProfilingDir() / FString::Printf(TEXT("StartupBenchmark_%d.txt"), RunIndex));
+	IFileManager::Get().Delete(*ResultPath, false, true, true);
+
+	const FString Args = FString::Printf(TEXT("\"%s\" %s -game -nullrhi -nosound -unattended -nosplash -StartupBenchmarkResult=\"%s\""),
+		*FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()), *Map, *ResultPath);
+
+	FProcHandle Proc = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Args, false, true, true, nullptr, 0, nullptr, nullptr);
+	if (!Proc.IsValid())
+	{
+		UE_LOG(LogGame, Error, TEXT("Startup benchmark: failed to launch %s"), FPlatformProcess::ExecutablePath());
+		return false;
+	}
+
+	const double Deadline = FPlatformTime::Seconds() + RunTimeoutSeconds;
+	while (FPlatformProcess::IsProcRunning(Proc))
+	{
+		if (FPlatformTime::Seconds() > Deadline)
+		{
+			FPlatformProcess::TerminateProc(Proc, true);
+			break;
+		}
+		FPlatformProcess::Sleep(0.1f);
+	}
+	FPlatformProcess::CloseProc(Proc);
+
+	FString Result;
+	if (!FFileHelper::LoadFileToString(Result, *ResultPath) || !Result.IsNumeric())
+	{
+		return false;
+	}
+
+	OutSeconds = FCString::Atod(*Result);
+	return true;
+}
+
+double UStrategyStartupBenchmarkCommandlet::GetPercentile(const TArray<double>& SortedTimes, float Percentile)
+{
+	const int32 Rank = FMath::CeilToInt(Percentile * SortedTimes.Num());
+	return SortedTimes[FMath::Clamp(Rank - 1, 0, SortedTimes.Num() - 1)];
+}
@@ -0,0 +1,145 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyStartupTrace.h"
+
+namespace
+{
+	/** single recorded phase */
+	struct FStartupPhase
+	{
+		FString Name;
+		double StartTime;
+		double EndTime;
+	};
+
+	/** phases in start order, end time is negative while open */
+	TArray<FStartupPhase>& GetPhases()
+	{
+		static TArray<FStartupPhase> Phases;
+		return Phases;
+	}
+
+	/** phase of the map being loaded */
+	FString LoadMapPhase;
+
+	/** map load delegate handles */
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+
+	/** @returns microseconds since process start, as used by trace viewers */
+	int64 ToTraceTime(double Time)
+	{
+		return (int64)((Time - GStartTime) * 1000000.0);
+	}
+}
+
+bool FStrategyStartupTrace::bFinished = false;
+
+void FStrategyStartupTrace::Initialize()
+{
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddStatic(&FStrategyStartupTrace::OnPreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddStatic(&FStrategyStartupTrace::OnPostLoadMap);
+}
+
+void FStrategyStartupTrace::Shutdown()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+}
+
+void FStrategyStartupTrace::BeginPhase(const FString& Name)
+{
+	if (!bFinished)
+	{
+		FStartupPhase& Phase = GetPhases().AddDefaulted_GetRef();
+		Phase.Name = Name;
+		Phase.StartTime = FPlatformTime::Seconds();
+		Phase.EndTime = -1.0;
+	}
+}
+
+void FStrategyStartupTrace::EndPhase(const FString& Name)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	TArray<FStartupPhase>& Phases = GetPhases();
+	for (int32 Index = Phases.Num() - 1; Index >= 0; Index--)
+	{
+		if (Phases[Index].EndTime < 0.0 && Phases[Index].Name == Name)
+		{
+			Phases[Index].EndTime = FPlatformTime::Seconds();
+			break;
+		}
+	}
+}
+
+void FStrategyStartupTrace::AddPhase(const FString& Name, double StartTime, double EndTime)
+{
+	if (!bFinished && EndTime >= StartTime)
+	{
+		FStartupPhase& Phase = GetPhases().AddDefaulted_GetRef();
+		Phase.Name = Name;
+		Phase.StartTime = StartTime;
+		Phase.EndTime = EndTime;
+	}
+}
+
+void FStrategyStartupTrace::MarkFirstPlayableFrame()
+{
+	if (!bFinished)
+	{
+		bFinished = true;
+		Write(FPlatformTime::Seconds());
+	}
+}
+
+void FStrategyStartupTrace::Write(double FirstPlayableTime)
+{
+	const double StartupSeconds = FirstPlayableTime - GStartTime;
+	UE_LOG(LogGame, Log, TEXT("Startup: first playable frame after %.3f s"), StartupSeconds);
+
+	// phases still open (e.g. travel that never got its map loaded) are cut at the first playable frame
+	FString Json = TEXT("{\"traceEvents\":[\n");
+	for (const FStartupPhase& Phase : GetPhases())
+	{
+		const double EndTime = Phase.EndTime < 0.0 ? FirstPlayableTime : Phase.EndTime;
+		Json += FString::Printf(TEXT("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%lld,\"dur\":%lld},\n"),
+			*Phase.Name.ReplaceCharWithEscapedChar(), ToTraceTime(Phase.StartTime), ToTraceTime(EndTime) - ToTraceTime(Phase.StartTime));
+		UE_LOG(LogGame, Log, TEXT("Startup: %s %.1f ms"), *Phase.Name, (EndTime - Phase.StartTime) * 1000.0);
+	}
+	Json += FString::Printf(TEXT("{\"name\":\"FirstPlayableFrame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":1,\"ts\":%lld}\n]}\n"),
+		ToTraceTime(FirstPlayableTime));
+
+	const FString TracePath = FPaths::ProfilingDir() / TEXT("StartupTrace.json");
+	if (!FFileHelper::SaveStringToFile(Json, *TracePath))
+	{
+		UE_LOG(LogGame, Warning, TEXT("Startup: failed to write %s"), *TracePath);
+	}
+
+	FString ResultPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("StartupBenchmarkResult="), ResultPath))
+	{
+		FFileHelper::SaveStringToFile(FString::Printf(TEXT("%.6f"), StartupSeconds), *ResultPath);
+		FPlatformMisc::RequestExit(false);
+	}
+
+	GetPhases().Empty();
+}
+
+void FStrategyStartupTrace::OnPreLoadMap(const FString& MapName)
+{
+	EndPhase(LoadMapPhase);
+	LoadMapPhase = FString(TEXT("LoadMap ")) + FPackageName::GetShortName(MapName);
+	BeginPhase(LoadMapPhase);
+}
+
+void FStrategyStartupTrace::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	EndPhase(LoadMapPhase);
+	EndPhase(TEXT("Travel"));
+	LoadMapPhase.Reset();
+}
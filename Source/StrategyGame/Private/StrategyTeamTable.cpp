@@ -0,0 +1,49 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyTeamTable.h"
+#include "StrategyTeamInterface.h"
+
+constexpr bool FStrategyTeamTable::FriendlyMatrix[EStrategyTeam::MAX + 1][EStrategyTeam::MAX + 1];
+constexpr bool FStrategyTeamTable::EnemyMatrix[EStrategyTeam::MAX + 1][EStrategyTeam::MAX + 1];
+TArray<uint8> FStrategyTeamTable::TeamByObjectIndex;
+
+void FStrategyTeamTable::SetTeam(const UObject* InObject, uint8 TeamNum)
+{
+	check(InObject);
+	check(TeamNum < EStrategyTeam::MAX);
+
+	const int32 Index = InObject->GetUniqueID();
+	if (!TeamByObjectIndex.IsValidIndex(Index))
+	{
+		TeamByObjectIndex.AddZeroed(Index + 1 - TeamByObjectIndex.Num());
+	}
+	TeamByObjectIndex[Index] = TeamNum + 1;
+}
+
+void FStrategyTeamTable::ClearTeam(const UObject* InObject)
+{
+	const int32 Index = InObject ? (int32)InObject->GetUniqueID() : INDEX_NONE;
+	if (TeamByObjectIndex.IsValidIndex(Index))
+	{
+		TeamByObjectIndex[Index] = 0;
+	}
+}
+
+uint8 FStrategyTeamTable::GetTeam(const UObject* InObject)
+{
+	if (InObject == nullptr)
+	{
+		return NoTeam;
+	}
+
+	const int32 Index = InObject->GetUniqueID();
+	if (TeamByObjectIndex.IsValidIndex(Index) && TeamByObjectIndex[Index] != 0)
+	{
+		return TeamByObjectIndex[Index] - 1;
+	}
+
+	// not registered, could be an object that never had its team set
+	const IStrategyTeamInterface* const TeamInterface = Cast<const IStrategyTeamInterface>(InObject);
+	return TeamInterface ? TeamInterface->GetTeamNum() : NoTeam;
+}
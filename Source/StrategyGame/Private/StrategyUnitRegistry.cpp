@@ -0,0 +1,161 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyUnitRegistry.h"
+#include "StrategyAIController.h"
+
+int32 FStrategyPerFrameScope::Depth = 0;
+
+FStrategyPerFrameScope::FStrategyPerFrameScope()
+{
+	check(IsInGameThread());
+	Depth++;
+}
+
+FStrategyPerFrameScope::~FStrategyPerFrameScope()
+{
+	Depth--;
+}
+
+bool FStrategyPerFrameScope::IsActive()
+{
+	return Depth > 0;
+}
+
+FStrategyUnitRegistry::FStrategyUnitRegistry()
+	: PublishedFrame(MAX_uint64)
+{
+	FMemory::Memzero(NumLive);
+}
+
+void FStrategyUnitRegistry::AddChar(AStrategyChar* InChar)
+{
+	if (InChar == nullptr || RegisteredIndices.Contains(InChar))
+	{
+		return;
+	}
+
+	const uint8 TeamNum = FMath::Min<uint8>(InChar->GetTeamNum(), EStrategyTeam::MAX - 1);
+	RegisteredIndices.Add(InChar, Registered.Num());
+	Registered.Add(InChar);
+	RegisteredTeams.Add(TeamNum);
+	NumLive[TeamNum]++;
+}
+
+void FStrategyUnitRegistry::RemoveChar(AStrategyChar* InChar)
+{
+	int32 Index = INDEX_NONE;
+	if (!RegisteredIndices.RemoveAndCopyValue(InChar, Index))
+	{
+		return;
+	}
+
+	NumLive[RegisteredTeams[Index]]--;
+
+	// move last entry into freed slot
+	const int32 LastIndex = Registered.Num() - 1;
+	if (Index != LastIndex)
+	{
+		RegisteredIndices[Registered[LastIndex]] = Index;
+	}
+	Registered.RemoveAtSwap(Index, 1, false);
+	RegisteredTeams.RemoveAtSwap(Index, 1, false);
+
+	const int32 PublishedIndex = InChar->UnitRegistryIndex;
+	if (Chars.IsValidIndex(PublishedIndex) && Chars[PublishedIndex] == InChar)
+	{
+		Chars[PublishedIndex] = nullptr;
+		Health[PublishedIndex] = 0.0f;
+		LogicEnabled[PublishedIndex] = false;
+	}
+	InChar->UnitRegistryIndex = INDEX_NONE;
+}
+
+void FStrategyUnitRegistry::RefreshChar(AStrategyChar* InChar)
+{
+	const int32* const Index = InChar ? RegisteredIndices.Find(InChar) : nullptr;
+	if (Index == nullptr)
+	{
+		return;
+	}
+
+	// team is usually set right after spawn, move the char to its new team's count
+	const uint8 TeamNum = FMath::Min<uint8>(InChar->GetTeamNum(), EStrategyTeam::MAX - 1);
+	NumLive[RegisteredTeams[*Index]]--;
+	NumLive[TeamNum]++;
+	RegisteredTeams[*Index] = TeamNum;
+
+	const int32 PublishedIndex = InChar->UnitRegistryIndex;
+	if (Chars.IsValidIndex(PublishedIndex) && Chars[PublishedIndex] == InChar)
+	{
+		Teams[PublishedIndex] = TeamNum;
+		DamageReduction[PublishedIndex] = InChar->GetPawnData()->DamageReduction;
+	}
+}
+
+void FStrategyUnitRegistry::Publish(uint64 FrameNumber)
+{
+	if (PublishedFrame == FrameNumber)
+	{
+		return;
+	}
+	PublishedFrame = FrameNumber;
+
+	const int32 NumChars = Registered.Num();
+	Chars.Reset(NumChars);
+	Locations.Reset(NumChars);
+	CapsuleSizes.Reset(NumChars);
+	Teams.Reset(NumChars);
+	Health.Reset(NumChars);
+	MaxHealth.Reset(NumChars);
+	DamageReduction.Reset(NumChars);
+	LogicEnabled.Reset(NumChars);
+
+	for (int32 Index = 0; Index < NumChars; Index++)
+	{
+		AStrategyChar* const Char = Registered[Index];
+		const AStrategyAIController* const AIController = Cast<AStrategyAIController>(Char->Controller);
+		const uint8 TeamNum = RegisteredTeams[Index];
+
+		Char->UnitRegistryIndex = Chars.Add(Char);
+		Locations.Add(Char->GetActorLocation());
+		CapsuleSizes.Add(FVector2D(Char->GetCapsuleComponent()->GetScaledCapsuleRadius(), Char->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+		Teams.Add(TeamNum);
+		Health.Add(Char->GetHealth());
+		MaxHealth.Add(Char->GetMaxHealth());
+		DamageReduction.Add(Char->GetPawnData()->DamageReduction);
+		LogicEnabled.Add(AIController != nullptr && AIController->IsLogicEnabled());
+	}
+}
+
+void FStrategyUnitRegistry::Reset()
+{
+	for (AStrategyChar* const Char : Registered)
+	{
+		Char->UnitRegistryIndex = INDEX_NONE;
+	}
+
+	Registered.Reset();
+	RegisteredTeams.Reset();
+	RegisteredIndices.Reset();
+	Chars.Reset();
+	Locations.Reset();
+	CapsuleSizes.Reset();
+	Teams.Reset();
+	Health.Reset();
+	MaxHealth.Reset();
+	DamageReduction.Reset();
+	LogicEnabled.Reset();
+	FMemory::Memzero(NumLive);
+	PublishedFrame = MAX_uint64;
+}
+
+int32 FStrategyUnitRegistry::Num() const
+{
+	return Chars.Num();
+}
+
+int32 FStrategyUnitRegistry::GetNumLive(uint8 TeamNum) const
+{
+	return TeamNum < EStrategyTeam::MAX ? NumLive[TeamNum] : 0;
+}
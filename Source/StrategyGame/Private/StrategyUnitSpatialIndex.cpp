@@ -0,0 +1,102 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyUnitSpatialIndex.h"
+#include "StrategyTeamTable.h"
+
+FStrategyUnitSpatialIndex::FStrategyUnitSpatialIndex()
+	: CellSize(512.0f)
+	, NumUnits(0)
+	, MaxUnitRadius(0.0f)
+{
+}
+
+void FStrategyUnitSpatialIndex::Reset(float InCellSize)
+{
+	for (int32 TeamNum = 0; TeamNum < EStrategyTeam::MAX; TeamNum++)
+	{
+		for (TPair<FIntPoint, TArray<FEntry>>& Cell : Cells[TeamNum])
+		{
+			Cell.Value.Reset();
+		}
+	}
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	NumUnits = 0;
+	MaxUnitRadius = 0.0f;
+}
+
+void FStrategyUnitSpatialIndex::AddUnit(AStrategyChar* InChar, const FVector& Location, uint8 TeamNum, float Radius)
+{
+	check(TeamNum < EStrategyTeam::MAX);
+
+	FEntry Entry;
+	Entry.Char = InChar;
+	Entry.Location = FVector2D(Location);
+
+	Cells[TeamNum].FindOrAdd(GetCell(Location.X, Location.Y)).Add(Entry);
+	NumUnits++;
+	MaxUnitRadius = FMath::Max(MaxUnitRadius, Radius);
+}
+
+void FStrategyUnitSpatialIndex::QueryRadius(const FVector& Origin, float Radius, FCharArray& OutChars, uint8 TeamNum) const
+{
+	if (TeamNum < EStrategyTeam::MAX)
+	{
+		QueryTeam(Origin, Radius, TeamNum, OutChars);
+		return;
+	}
+
+	for (int32 TestTeam = 0; TestTeam < EStrategyTeam::MAX; TestTeam++)
+	{
+		QueryTeam(Origin, Radius, TestTeam, OutChars);
+	}
+}
+
+void FStrategyUnitSpatialIndex::QueryEnemies(const FVector& Origin, float Radius, uint8 MyTeamNum, FCharArray& OutChars) const
+{
+	for (int32 TestTeam = 0; TestTeam < EStrategyTeam::MAX; TestTeam++)
+	{
+		if (FStrategyTeamTable::IsEnemy(MyTeamNum, TestTeam))
+		{
+			QueryTeam(Origin, Radius, TestTeam, OutChars);
+		}
+	}
+}
+
+void FStrategyUnitSpatialIndex::QueryTeam(const FVector& Origin, float Radius, uint8 TeamNum, FCharArray& OutChars) const
+{
+	const FIntPoint MinCell = GetCell(Origin.X - Radius, Origin.Y - Radius);
+	const FIntPoint MaxCell = GetCell(Origin.X + Radius, Origin.Y + Radius);
+	const FVector2D Origin2D(Origin);
+	const float RadiusSq = FMath::Square(Radius);
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			const TArray<FEntry>* Cell = Cells[TeamNum].Find(FIntPoint(X, Y));
+			if (Cell == nullptr)
+			{
+				continue;
+			}
+
+			for (const FEntry& Entry : *Cell)
+			{
+				if (FVector2D::DistSquared(Entry.Location, Origin2D) <= RadiusSq)
+				{
+					OutChars.Add(Entry.Char);
+				}
+			}
+		}
+	}
+}
+
+int32 FStrategyUnitSpatialIndex::Num() const
+{
+	return NumUnits;
+}
+
+FIntPoint FStrategyUnitSpatialIndex::GetCell(float X, float Y) const
+{
+	return FIntPoint(FMath::FloorToInt(X / CellSize), FMath::FloorToInt(Y / CellSize));
+}
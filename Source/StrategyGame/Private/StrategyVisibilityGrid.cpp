@@ -0,0 +1,248 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyVisibilityGrid.h"
+
+namespace
+{
+	/** upper limit of cells along one axis, keeps a misconfigured cell size from eating memory */
+	const int32 MaxCellsPerAxis = 4096;
+}
+
+FStrategyVisibilityGrid::FStrategyVisibilityGrid()
+	: Bounds(ForceInit)
+	, CellSize(256.0f)
+	, NumCellsX(0)
+	, NumCellsY(0)
+	, WordsPerRow(0)
+	, StaticRevision(0)
+	, bHasStaticViewers(false)
+	, NumStamps(0)
+{
+	FMemory::Memzero(bStaticDirty, sizeof(bStaticDirty));
+}
+
+void FStrategyVisibilityGrid::Reset(const FBox& InBounds, float InCellSize)
+{
+	Bounds = InBounds;
+	CellSize = FMath::Max(InCellSize, 1.0f);
+
+	const FVector Size = InBounds.GetSize();
+	NumCellsX = FMath::Clamp(FMath::CeilToInt(Size.X / CellSize), 1, MaxCellsPerAxis);
+	NumCellsY = FMath::Clamp(FMath::CeilToInt(Size.Y / CellSize), 1, MaxCellsPerAxis);
+	WordsPerRow = (NumCellsX + 63) / 64;
+
+	for (int32 TeamNum = 0; TeamNum < EStrategyTeam::MAX; TeamNum++)
+	{
+		Bits[TeamNum].Reset();
+		Bits[TeamNum].SetNumZeroed(WordsPerRow * NumCellsY);
+		ViewerCounts[TeamNum].Reset();
+		ViewerCounts[TeamNum].SetNumZeroed(NumCellsX * NumCellsY);
+		Viewers[TeamNum].Reset();
+		BuiltViewers[TeamNum].Reset();
+		StaticViewers[TeamNum].Reset();
+		BuiltStaticViewers[TeamNum].Reset();
+		bStaticDirty[TeamNum] = true;
+	}
+
+	Masks.Reset();
+	MaskRadii.Reset();
+	bHasStaticViewers = false;
+	NumStamps = 0;
+}
+
+void FStrategyVisibilityGrid::ResetStaticViewers(uint32 Revision)
+{
+	for (int32 TeamNum = 0; TeamNum < EStrategyTeam::MAX; TeamNum++)
+	{
+		StaticViewers[TeamNum].Reset();
+		bStaticDirty[TeamNum] = true;
+	}
+	StaticRevision = Revision;
+	bHasStaticViewers = true;
+}
+
+void FStrategyVisibilityGrid::AddStaticViewer(uint8 TeamNum, const FVector& Location, float Radius)
+{
+	if (IsInitialized() && TeamNum < EStrategyTeam::MAX)
+	{
+		StaticViewers[TeamNum].Add(MakeViewer(Location, Radius));
+	}
+}
+
+void FStrategyVisibilityGrid::BeginUpdate()
+{
+	for (int32 TeamNum = 0; TeamNum < EStrategyTeam::MAX; TeamNum++)
+	{
+		Viewers[TeamNum].Reset();
+	}
+}
+
+void FStrategyVisibilityGrid::AddViewer(uint8 TeamNum, const FVector& Location, float Radius)
+{
+	if (IsInitialized() && TeamNum < EStrategyTeam::MAX)
+	{
+		Viewers[TeamNum].Add(MakeViewer(Location, Radius));
+	}
+}
+
+void FStrategyVisibilityGrid::EndUpdate()
+{
+	if (!IsInitialized())
+	{
+		return;
+	}
+
+	for (int32 TeamNum = 0; TeamNum < EStrategyTeam::MAX; TeamNum++)
+	{
+		if (bStaticDirty[TeamNum])
+		{
+			SortUnique(StaticViewers[TeamNum]);
+			StampChanges(TeamNum, BuiltStaticViewers[TeamNum], StaticViewers[TeamNum]);
+			BuiltStaticViewers[TeamNum] = StaticViewers[TeamNum];
+			bStaticDirty[TeamNum] = false;
+		}
+
+		SortUnique(Viewers[TeamNum]);
+		StampChanges(TeamNum, BuiltViewers[TeamNum], Viewers[TeamNum]);
+		Swap(Viewers[TeamNum], BuiltViewers[TeamNum]);
+	}
+}
+
+bool FStrategyVisibilityGrid::IsVisible(uint8 TeamNum, const FVector& Location) const
+{
+	if (!IsInitialized() || TeamNum >= EStrategyTeam::MAX)
+	{
+		return true;
+	}
+
+	const int32 CellX = FMath::FloorToInt((Location.X - Bounds.Min.X) / CellSize);
+	const int32 CellY = FMath::FloorToInt((Location.Y - Bounds.Min.Y) / CellSize);
+	if (CellX < 0 || CellY < 0 || CellX >= NumCellsX || CellY >= NumCellsY)
+	{
+		return true;
+	}
+
+	return IsCellVisible(TeamNum, CellX, CellY);
+}
+
+int32 FStrategyVisibilityGrid::CountVisibleCells(uint8 TeamNum) const
+{
+	int32 Count = 0;
+	if (TeamNum < EStrategyTeam::MAX)
+	{
+		for (uint64 Word : Bits[TeamNum])
+		{
+			Count += (int32)FPlatformMath::CountBits(Word);
+		}
+	}
+	return Count;
+}
+
+FStrategyVisibilityGrid::FViewer FStrategyVisibilityGrid::MakeViewer(const FVector& Location, float Radius)
+{
+	FViewer Viewer;
+	Viewer.CellX = FMath::FloorToInt((Location.X - Bounds.Min.X) / CellSize);
+	Viewer.CellY = FMath::FloorToInt((Location.Y - Bounds.Min.Y) / CellSize);
+	Viewer.MaskIndex = GetMaskIndex(Radius);
+	return Viewer;
+}
+
+int32 FStrategyVisibilityGrid::GetMaskIndex(float Radius)
+{
+	const int32 Existing = MaskRadii.Find(Radius);
+	if (Existing != INDEX_NONE)
+	{
+		return Existing;
+	}
+
+	// viewer and target can be anywhere in their cells, so reach is extended by two half diagonals
+	const float ReachCells = FMath::Max(Radius, 0.0f) / CellSize + 1.41421356f;
+	const int32 RowRadius = FMath::FloorToInt(ReachCells);
+
+	TArray<int32>& HalfWidths = Masks.AddDefaulted_GetRef();
+	HalfWidths.SetNumUninitialized(RowRadius * 2 + 1);
+	for (int32 DY = -RowRadius; DY <= RowRadius; DY++)
+	{
+		HalfWidths[DY + RowRadius] = FMath::FloorToInt(FMath::Sqrt(FMath::Square(ReachCells) - FMath::Square((float)DY)));
+	}
+
+	return MaskRadii.Add(Radius);
+}
+
+void FStrategyVisibilityGrid::Stamp(uint8 TeamNum, const FViewer& Viewer, bool bAdd)
+{
+	const TArray<int32>& HalfWidths = Masks[Viewer.MaskIndex];
+	const int32 RowRadius = HalfWidths.Num() / 2;
+
+	const int32 FirstY = FMath::Max(Viewer.CellY - RowRadius, 0);
+	const int32 LastY = FMath::Min(Viewer.CellY + RowRadius, NumCellsY - 1);
+	for (int32 Y = FirstY; Y <= LastY; Y++)
+	{
+		const int32 HalfWidth = HalfWidths[Y - Viewer.CellY + RowRadius];
+		const int32 FirstX = FMath::Max(Viewer.CellX - HalfWidth, 0);
+		const int32 LastX = FMath::Min(Viewer.CellX + HalfWidth, NumCellsX - 1);
+
+		uint16* const Counts = &ViewerCounts[TeamNum][Y * NumCellsX];
+		uint64* const Row = &Bits[TeamNum][Y * WordsPerRow];
+		for (int32 X = FirstX; X <= LastX; X++)
+		{
+			if (bAdd)
+			{
+				checkSlow(Counts[X] < MAX_uint16);
+				if (Counts[X]++ == 0)
+				{
+					Row[X >> 6] |= 1ull << (X & 63);
+				}
+			}
+			else
+			{
+				checkSlow(Counts[X] > 0);
+				if (--Counts[X] == 0)
+				{
+					Row[X >> 6] &= ~(1ull << (X & 63));
+				}
+			}
+		}
+	}
+
+	NumStamps++;
+}
+
+void FStrategyVisibilityGrid::StampChanges(uint8 TeamNum, const TArray<FViewer>& Old, const TArray<FViewer>& New)
+{
+	// both lists are sorted, walk them together and skip viewers that didn't change
+	int32 OldIndex = 0;
+	int32 NewIndex = 0;
+	while (OldIndex < Old.Num() || NewIndex < New.Num())
+	{
+		if (NewIndex >= New.Num() || (OldIndex < Old.Num() && Old[OldIndex] < New[NewIndex]))
+		{
+			Stamp(TeamNum, Old[OldIndex++], false);
+		}
+		else if (OldIndex >= Old.Num() || New[NewIndex] < Old[OldIndex])
+		{
+			Stamp(TeamNum, New[NewIndex++], true);
+		}
+		else
+		{
+			OldIndex++;
+			NewIndex++;
+		}
+	}
+}
+
+void FStrategyVisibilityGrid::SortUnique(TArray<FViewer>& InViewers)
+{
+	InViewers.Sort();
+
+	int32 NumUnique = 0;
+	for (int32 Index = 0; Index < InViewers.Num(); Index++)
+	{
+		if (NumUnique == 0 || !(InViewers[Index] == InViewers[NumUnique - 1]))
+		{
+			InViewers[NumUnique++] = InViewers[Index];
+		}
+	}
+	InViewers.SetNum(NumUnique, false);
+}
@@ -9,6 +9,8 @@
 #include "StrategyHelpers.h"
 #include "StrategyGameLoadingScreen.h"
 #include "StrategyHUDSoundsWidgetStyle.h"
+#include "StrategyPreloader.h"
+#include "StrategyStartupTrace.h"
 
 
 #define LOCTEXT_NAMESPACE "StrategyGame.HUD.Menu"
@@ -49,6 +51,13 @@ void AStrategyMenuHUD::PostInitializeComponents()
 	
 	//Now that we are here, build our menu widget
 	RebuildWidgets();
+
+	// the game map is the only place to go from here, start loading it while the player picks difficulty
+	// (not in PIE, where the map packages may be the ones open in the editor)
+	if (!GetWorld()->IsPlayInEditor())
+	{
+		UStrategyPreloader::Get()->StartPreload();
+	}
 }
 
 void AStrategyMenuHUD::ExecuteQuitAction()
@@ -92,6 +101,15 @@ void AStrategyMenuHUD::ExecuteSelectMapAction(int32 index)
 
 void AStrategyMenuHUD::LaunchGame()
 {
+	// whatever preload didn't finish yet is completed while travel flushes async loading
+	if (!GetWorld()->IsPlayInEditor())
+	{
+		UStrategyPreloader::Get()->StartPreload();
+	}
+
+	// ended when the map is loaded
+	FStrategyStartupTrace::BeginPhase(TEXT("Travel"));
+
 	FString StartStr = FString::Printf(TEXT("/Game/Maps/TowerDefenseMap?%s=%d"), *AStrategyGameMode::DifficultyOptionName, (uint8) Difficulty);
 	GetWorld()->ServerTravel(StartStr);
 	ShowLoadingScreen();
@@ -121,6 +139,7 @@ void AStrategyMenuHUD::ShowLoadingScreen()
 	if( LoadingScreenModule != nullptr )
 	{
 		LoadingScreenModule->StartInGameLoadingScreen();
+		UStrategyPreloader::Get()->ReportProgressToLoadingScreen();
 	}
 }
 
@@ -0,0 +1,128 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyButtonImageCache.h"
+#include "StrategyHelpers.h"
+#include "SlateBasics.h"
+#include "SlateExtras.h"
+
+FStrategyHitMask::FStrategyHitMask()
+	: SizeX(0)
+	, SizeY(0)
+{
+}
+
+bool FStrategyHitMask::IsHit(const FVector2D& UV) const
+{
+	if (Bits.Num() == 0)
+	{
+		return true;
+	}
+
+	const int32 X = FMath::Clamp(FMath::FloorToInt(UV.X * SizeX), 0, SizeX - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt(UV.Y * SizeY), 0, SizeY - 1);
+	const int32 WordsPerRow = (SizeX + 31) / 32;
+	return (Bits[Y * WordsPerRow + X / 32] >> (X % 32)) & 1;
+}
+
+void FStrategyHitMask::Build(const uint32* Pixels, int32 InSizeX, int32 InSizeY)
+{
+	// whole number of texels per mask texel, so each texel maps to exactly one bit
+	const int32 Reduction = FMath::DivideAndRoundUp(FMath::Max(InSizeX, InSizeY), MaxSize);
+	SizeX = FMath::DivideAndRoundUp(InSizeX, Reduction);
+	SizeY = FMath::DivideAndRoundUp(InSizeY, Reduction);
+
+	const int32 WordsPerRow = (SizeX + 31) / 32;
+	Bits.Reset();
+	Bits.AddZeroed(WordsPerRow * SizeY);
+
+	// alpha is the top byte of each B8G8R8A8 texel, so at 128 the threshold is just its top bit,
+	// which VectorMaskBits gathers for four texels at once
+	static_assert(AlphaThreshold == 128, "Vector threshold tests the top bit of alpha only");
+	const int32 NumVectorTexels = InSizeX & ~3;
+	for (int32 Y = 0; Y < InSizeY; Y++)
+	{
+		const uint32* const Row = Pixels + Y * InSizeX;
+		uint32* const MaskRow = &Bits[(Y / Reduction) * WordsPerRow];
+
+		int32 X = 0;
+		for (; X < NumVectorTexels; X += 4)
+		{
+			const uint32 Hits = VectorMaskBits(VectorLoad((const float*)(Row + X)));
+			if (Hits == 0)
+			{
+				continue;
+			}
+
+			if (Reduction == 1)
+			{
+				// four texels starting at a multiple of 4 never straddle a word
+				MaskRow[X >> 5] |= Hits << (X & 31);
+			}
+			else
+			{
+				for (uint32 Lane = 0; Lane < 4; Lane++)
+				{
+					const uint32 MaskX = (X + Lane) / Reduction;
+					MaskRow[MaskX >> 5] |= ((Hits >> Lane) & 1) << (MaskX & 31);
+				}
+			}
+		}
+
+		for (; X < InSizeX; X++)
+		{
+			const uint32 MaskX = X / Reduction;
+			MaskRow[MaskX >> 5] |= (Row[X] >> 31) << (MaskX & 31);
+		}
+	}
+}
+
+#if WITH_EDITORONLY_DATA
+bool FStrategyHitMask::BuildFromSource(UTexture2D* Texture, FStrategyHitMask& OutMask)
+{
+	FTextureSource& Source = Texture->Source;
+	if (!Source.IsValid() || Source.GetFormat() != TSF_BGRA8)
+	{
+		return false;
+	}
+
+	const uint8* const MipData = Source.LockMip(0);
+	if (MipData == nullptr)
+	{
+		return false;
+	}
+
+	OutMask.Build((const uint32*)MipData, Source.GetSizeX(), Source.GetSizeY());
+	Source.UnlockMip(0);
+	return true;
+}
+#endif
+
+const FStrategyButtonImage& FStrategyButtonImageCache::FindOrAdd(UTexture2D* Texture)
+{
+	check(Texture);
+
+	FStrategyButtonImage* Image = Images.Find(Texture);
+	if (Image == nullptr)
+	{
+		// textures unloaded since, their images are not needed anymore
+		for (auto It = Images.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		Image = &Images.Add(Texture);
+		Image->Brush = FDeferredCleanupSlateBrush::CreateBrush(Texture, FVector2D(Texture->GetSizeX(), Texture->GetSizeY()));
+		Image->HitMask = FStrategyHelpers::CreateHitMaskFromTexture(Texture);
+	}
+
+	return *Image;
+}
+
+void FStrategyButtonImageCache::Empty()
+{
+	Images.Empty();
+}
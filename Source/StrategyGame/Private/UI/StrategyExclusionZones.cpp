@@ -0,0 +1,116 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyExclusionZones.h"
+
+namespace
+{
+	/** upper limit of cells along one axis, keeps a bogus rect from eating memory */
+	const int32 MaxCellsPerAxis = 512;
+}
+
+FStrategyExclusionZones::FStrategyExclusionZones()
+	: GridBounds(ForceInit)
+	, NumCellsX(0)
+	, NumCellsY(0)
+	, NumRebuilds(0)
+{
+	for (int32 Zone = 0; Zone < Zone_MAX; Zone++)
+	{
+		Zones[Zone] = FBox2D(ForceInit);
+		StampedZones[Zone] = FBox2D(ForceInit);
+	}
+}
+
+void FStrategyExclusionZones::SetZone(EZone Zone, const FBox2D& Rect)
+{
+	if (!Rect.bIsValid)
+	{
+		if (Zones[Zone].bIsValid)
+		{
+			Zones[Zone] = FBox2D(ForceInit);
+			Rebuild();
+		}
+		return;
+	}
+
+	// cells stay conservative while the zone fits in its stamped area, queries test the exact rect
+	const bool bFitsStamp = Zones[Zone].bIsValid && StampedZones[Zone].IsInside(Rect);
+	Zones[Zone] = Rect;
+	if (!bFitsStamp)
+	{
+		Rebuild();
+	}
+}
+
+bool FStrategyExclusionZones::IsExcluded(const FVector2D& Position) const
+{
+	if (NumCellsX == 0)
+	{
+		return false;
+	}
+
+	const int32 CellX = FMath::FloorToInt((Position.X - GridBounds.Min.X) / CellSize);
+	const int32 CellY = FMath::FloorToInt((Position.Y - GridBounds.Min.Y) / CellSize);
+	if (CellX < 0 || CellY < 0 || CellX >= NumCellsX || CellY >= NumCellsY)
+	{
+		return false;
+	}
+
+	for (uint32 Mask = CellMasks[CellY * NumCellsX + CellX]; Mask != 0; Mask &= Mask - 1)
+	{
+		if (Zones[FMath::CountTrailingZeros(Mask)].IsInside(Position))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FStrategyExclusionZones::Rebuild()
+{
+	NumRebuilds++;
+
+	GridBounds = FBox2D(ForceInit);
+	for (int32 Zone = 0; Zone < Zone_MAX; Zone++)
+	{
+		StampedZones[Zone] = Zones[Zone].bIsValid ? Zones[Zone].ExpandBy(MoveTolerance) : FBox2D(ForceInit);
+		if (StampedZones[Zone].bIsValid)
+		{
+			GridBounds += StampedZones[Zone];
+		}
+	}
+
+	CellMasks.Reset();
+	NumCellsX = NumCellsY = 0;
+	if (!GridBounds.bIsValid)
+	{
+		return;
+	}
+
+	const FVector2D Size = GridBounds.GetSize();
+	NumCellsX = FMath::Clamp(FMath::CeilToInt(Size.X / CellSize), 1, MaxCellsPerAxis);
+	NumCellsY = FMath::Clamp(FMath::CeilToInt(Size.Y / CellSize), 1, MaxCellsPerAxis);
+	CellMasks.SetNumZeroed(NumCellsX * NumCellsY);
+
+	for (int32 Zone = 0; Zone < Zone_MAX; Zone++)
+	{
+		const FBox2D& Rect = StampedZones[Zone];
+		if (!Rect.bIsValid)
+		{
+			continue;
+		}
+
+		const int32 FirstX = FMath::Clamp(FMath::FloorToInt((Rect.Min.X - GridBounds.Min.X) / CellSize), 0, NumCellsX - 1);
+		const int32 FirstY = FMath::Clamp(FMath::FloorToInt((Rect.Min.Y - GridBounds.Min.Y) / CellSize), 0, NumCellsY - 1);
+		const int32 LastX = FMath::Clamp(FMath::FloorToInt((Rect.Max.X - GridBounds.Min.X) / CellSize), 0, NumCellsX - 1);
+		const int32 LastY = FMath::Clamp(FMath::FloorToInt((Rect.Max.Y - GridBounds.Min.Y) / CellSize), 0, NumCellsY - 1);
+		for (int32 Y = FirstY; Y <= LastY; Y++)
+		{
+			for (int32 X = FirstX; X <= LastX; X++)
+			{
+				CellMasks[Y * NumCellsX + X] |= (uint8)(1 << Zone);
+			}
+		}
+	}
+}
@@ -8,50 +8,91 @@
 #include "StrategyAIController.h"
 #include "StrategyBuilding.h"
 #include "StrategyBuilding_Brewery.h"
+#include "StrategyStartupTrace.h"
+
+/** @returns soft asset loaded if needed, warns when it's missing */
+template<typename T>
+static T* ResolveHUDAsset(const TSoftObjectPtr<T>& Asset)
+{
+	T* const Result = Asset.LoadSynchronous();
+	if (Result == nullptr)
+	{
+		UE_LOG(LogGame, Warning, TEXT("HUD asset %s can't be loaded"), *Asset.ToString());
+	}
+	return Result;
+}
 
 AStrategyHUD::AStrategyHUD(const FObjectInitializer& ObjectInitializer) :
 	Super(ObjectInitializer)
 {
-	static ConstructorHelpers::FObjectFinder<UTexture2D> BarFillObj(TEXT("/Game/UI/HUD/BarFill"));
-	static ConstructorHelpers::FObjectFinder<UTexture2D> PlayerTeamHPObj(TEXT("/Game/UI/HUD/PlayerTeamHealthBar"));
-	static ConstructorHelpers::FObjectFinder<UTexture2D> EnemyTeamHPObj(TEXT("/Game/UI/HUD/EnemyTeamHealthBar"));
-
-	static ConstructorHelpers::FObjectFinder<UTexture2D> DefaultActionObj(TEXT("/Game/UI/HUD/Actions/DefaultAction"));
-	static ConstructorHelpers::FObjectFinder<UTexture2D> DefaultCenterActionObj(TEXT("/Game/UI/HUD/Actions/DefaultActionBig"));
-	static ConstructorHelpers::FObjectFinder<UTexture2D> ActionPauseObj(TEXT("/Game/UI/HUD/Actions/ActionPause"));
-	static ConstructorHelpers::FObjectFinder<UTexture2D> MenuButtonObj(TEXT("/Game/UI/MainMenu/MenuButton"));
-	static ConstructorHelpers::FObjectFinder<UTexture2D> ResourceObj(TEXT("/Game/UI/HUD/Coin"));
-	static ConstructorHelpers::FObjectFinder<UTexture2D> LivesObj(TEXT("/Game/UI/HUD/Actions/Barrel"));
-	
-
-	static ConstructorHelpers::FObjectFinder<UMaterial> HUDMousePointerNeutralObj(TEXT("/Game/UI/Pointers/Neutral"));
-	static ConstructorHelpers::FObjectFinder<UMaterial> HUDMousePointerAttackObj(TEXT("/Game/UI/Pointers/Enemy"));
-
-	BarFillTexture = BarFillObj.Object;
-	PlayerTeamHPTexture = PlayerTeamHPObj.Object;
-	EnemyTeamHPTexture = EnemyTeamHPObj.Object;
-	LivesTexture = LivesObj.Object;
-
-	DefaultActionTexture = DefaultActionObj.Object;
-	DefaultCenterActionTexture = DefaultCenterActionObj.Object;
-	ActionPauseTexture = ActionPauseObj.Object;
-	MenuButtonTexture = MenuButtonObj.Object;
-	ResourceTexture =  ResourceObj.Object;
-
-	MousePointerNeutral = HUDMousePointerNeutralObj.Object;
-	MousePointerAttack = HUDMousePointerAttackObj.Object;
+	// resolved when HUD is spawned instead of when class default object is built
+	BarFillAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/BarFill.BarFill"));
+	PlayerTeamHPAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/PlayerTeamHealthBar.PlayerTeamHealthBar"));
+	EnemyTeamHPAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/EnemyTeamHealthBar.EnemyTeamHealthBar"));
+	DefaultActionAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/Actions/DefaultAction.DefaultAction"));
+	DefaultCenterActionAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/Actions/DefaultActionBig.DefaultActionBig"));
+	ActionPauseAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/Actions/ActionPause.ActionPause"));
+	MenuButtonAsset = FSoftObjectPath(TEXT("/Game/UI/MainMenu/MenuButton.MenuButton"));
+	ResourceAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/Coin.Coin"));
+	LivesAsset = FSoftObjectPath(TEXT("/Game/UI/HUD/Actions/Barrel.Barrel"));
+	MousePointerNeutralAsset = FSoftObjectPath(TEXT("/Game/UI/Pointers/Neutral.Neutral"));
+	MousePointerAttackAsset = FSoftObjectPath(TEXT("/Game/UI/Pointers/Enemy.Enemy"));
 
 	MiniMapMargin = 40;
+	MiniMapUnitUpdateRate = 10.0f;
+	NextMiniMapUnitUpdateTime = 0.0f;
+	MiniMapBuildingsRevision = 0;
+	MiniMapBuildingRect = FBox2D(ForceInit);
+	MiniMapUnitRect = FBox2D(ForceInit);
+	MiniMapViewRevision = 0;
 	bBlackScreenActive = false;
 }
 
 
+void AStrategyHUD::GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets)
+{
+	const AStrategyHUD* const DefaultHUD = GetDefault<AStrategyHUD>();
+	OutAssets.Add(DefaultHUD->BarFillAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->PlayerTeamHPAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->EnemyTeamHPAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->DefaultActionAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->DefaultCenterActionAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->ActionPauseAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->MenuButtonAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->ResourceAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->LivesAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->MousePointerNeutralAsset.ToSoftObjectPath());
+	OutAssets.Add(DefaultHUD->MousePointerAttackAsset.ToSoftObjectPath());
+}
+
+void AStrategyHUD::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// already in memory when preloaded by main menu, loaded here otherwise
+	BarFillTexture = ResolveHUDAsset(BarFillAsset);
+	PlayerTeamHPTexture = ResolveHUDAsset(PlayerTeamHPAsset);
+	EnemyTeamHPTexture = ResolveHUDAsset(EnemyTeamHPAsset);
+	LivesTexture = ResolveHUDAsset(LivesAsset);
+
+	DefaultActionTexture = ResolveHUDAsset(DefaultActionAsset);
+	DefaultCenterActionTexture = ResolveHUDAsset(DefaultCenterActionAsset);
+	ActionPauseTexture = ResolveHUDAsset(ActionPauseAsset);
+	MenuButtonTexture = ResolveHUDAsset(MenuButtonAsset);
+	ResourceTexture = ResolveHUDAsset(ResourceAsset);
+
+	MousePointerNeutral = ResolveHUDAsset(MousePointerNeutralAsset);
+	MousePointerAttack = ResolveHUDAsset(MousePointerAttackAsset);
+}
+
 /**
  * This is the main drawing pump.  It will determine which hud we need to draw (Game or PostGame).  Any drawing that should occur
  * regardless of the game state should go here.
  */
 void AStrategyHUD::DrawHUD()
 {
+	FStrategyPerFrameScope PerFrameScope;
+
 	if (bBlackScreenActive)
 	{
 		FCanvasTileItem TileItem( FVector2D( 0.0f, 0.0f ), FVector2D( Canvas->ClipX,Canvas->ClipY ), FLinearColor( 0.0f, 0.0f, 0.0f, 1.0f ) );
@@ -76,6 +117,9 @@ void AStrategyHUD::DrawHUD()
 		//Builds the widgets if they are not yet built
 		BuildMenuWidgets();
 
+		// first frame drawn with the match HUD is as far as startup goes, the main menu has its own HUD
+		FStrategyStartupTrace::MarkFirstPlayableFrame();
+
 		if (MyGameState->IsGameActive())
 		{
 			DrawActorsHealth();
@@ -93,6 +137,7 @@ void AStrategyHUD::DrawHUD()
 		if (SelectedActor.IsValid())
 		{
 			ActionGridPos = FVector2D(Canvas->Project(SelectedActor->GetActorLocation())) / UIScale - (MyHUDMenuWidget->ActionButtonsWidget->GetDesiredSize())/2;
+			MyHUDMenuWidget->SetActionsWidgetPos(ActionGridPos);
 		}
 	}
 }
@@ -106,35 +151,48 @@ void AStrategyHUD::ShowBlackScreen()
 
 void AStrategyHUD::DrawActorsHealth()
 {
-	for (AStrategyChar* TestChar : TActorRange<AStrategyChar>(GetWorld()))
+	AStrategyGameState* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
+	const AStrategyPlayerController* const MyPC = GetPlayerController();
+	if (MyGameState)
 	{
-		if (TestChar->GetHealth() > 0)
+		const uint8 PlayerTeam = MyPC ? MyPC->GetTeamNum() : EStrategyTeam::Unknown;
+		const FStrategyVisibilityGrid& VisibilityGrid = MyGameState->GetVisibilityGrid();
+		const bool bUseVisibility = PlayerTeam != EStrategyTeam::Unknown;
+		const FStrategyUnitRegistry& Registry = MyGameState->GetUnitRegistry();
+		const TArray<AStrategyChar*>& Chars = Registry.GetChars();
+		const TArray<FVector>& Locations = Registry.GetLocations();
+		const TArray<FVector2D>& CapsuleSizes = Registry.GetCapsuleSizes();
+		const TArray<uint8>& Teams = Registry.GetTeams();
+		const TArray<float>& Health = Registry.GetHealth();
+		const TArray<int32>& MaxHealth = Registry.GetMaxHealth();
+		const TArray<bool>& LogicEnabled = Registry.GetLogicEnabled();
+		for (int32 i = 0; i < Chars.Num(); i++)
 		{
-			AStrategyAIController* AIController = Cast<AStrategyAIController>(TestChar->Controller);
-			if (AIController != NULL && AIController->IsLogicEnabled())
+			if (Chars[i] != nullptr && Health[i] > 0 && LogicEnabled[i] &&
+				(!bUseVisibility || Teams[i] == PlayerTeam || VisibilityGrid.IsVisible(PlayerTeam, Locations[i])))
 			{
-				DrawHealthBar(TestChar,TestChar->GetHealth()/(float)TestChar->GetMaxHealth(),18*UIScale);
+				// bar sits on top of the capsule and is twice as wide
+				const FVector Top = Locations[i] + FVector(0.0f, 0.0f, CapsuleSizes[i].Y);
+				AddHealthBar(Top, CapsuleSizes[i].X * 2, Health[i]/(float)MaxHealth[i], 18*UIScale, Teams[i] == PlayerTeam);
 			}
 		}
-	}
-	AStrategyGameState* const MyGameState = GetWorld()->GetGameState<AStrategyGameState>();
-	if (MyGameState)
-	{
-		// 0 - unknown/neutral team, two teams in total
-		for (int8 Team = 1; Team < EStrategyTeam::MAX; Team++)
+
+		// only buildings under construction show health, finished ones are never looked at
+		const FStrategyConstructionScheduler& Constructions = MyGameState->GetConstructionScheduler();
+		for (int32 i = 0; i < Constructions.Num(); i++)
 		{
-			for (int32 i = 0; i < MyGameState->GetPlayerData(Team)->BuildingsList.Num(); i++) 
+			const AStrategyBuilding* const TestBuilding = Constructions.GetBuilding(i);
+			if (TestBuilding != nullptr && !TestBuilding->IsPendingKill() && TestBuilding->GetTeamNum() != EStrategyTeam::Unknown)
 			{
-				if (MyGameState->GetPlayerData(Team)->BuildingsList[i].IsValid())
+				const int32 BuildingHealth = TestBuilding->GetDisplayHealth();
+				if (BuildingHealth > 0)
 				{
-					AStrategyBuilding* const TestBuilding = Cast<AStrategyBuilding>(MyGameState->GetPlayerData(Team)->BuildingsList[i].Get());
-					if (TestBuilding != NULL && TestBuilding->GetHealth() > 0 && !TestBuilding->IsBuildFinished())
-					{
-						DrawHealthBar(TestBuilding, TestBuilding->GetHealth()/(float)TestBuilding->GetMaxHealth(), 30*UIScale);
-					}
+					AddHealthBar(TestBuilding->GetActorLocation(), 120.0f, BuildingHealth/(float)TestBuilding->GetMaxHealth(), 30*UIScale, TestBuilding->GetTeamNum() == PlayerTeam);
 				}
 			}
 		}
+
+		FlushHealthBars();
 	}
 
 }
@@ -147,14 +205,10 @@ void AStrategyHUD::DrawMiniMap()
 	// @todo, clean this up
 	if (PC && MyGameState && MyGameState->MiniMapCamera.IsValid())
 	{
-		UTexture* MiniMapTexture = Cast<UTexture>(MyGameState->MiniMapCamera->GetCaptureComponent2D()->TextureTarget);
+		UTexture* MiniMapTexture = MyGameState->MiniMapCamera->GetTerrainTexture();
 		const float MapWidth = (MyGameState->MiniMapCamera->MiniMapWidth - MiniMapMargin) * UIScale;
 		const float MapHeight = (MyGameState->MiniMapCamera->MiniMapHeight - MiniMapMargin) * UIScale;
-		const FVector WorldCenter = MyGameState->WorldBounds.GetCenter();
-		const FVector WorldExtent = MyGameState->WorldBounds.GetExtent();
-		// Use a fixed yaw of 270.0f here instead of calculating (270.0f + MyGameState->MiniMapCamera->GetRootComponent()->GetComponentRotation().Roll).
-		const FRotationMatrix RotationMatrix(FRotator(0.0f, 270.0f, 0.0f));
-		const FVector2D Offset(MiniMapMargin * UIScale + (MapWidth/2.0f), Canvas->ClipY - (MapHeight/2.0f) - MiniMapMargin * UIScale );
+		const FVector2D MapPosition(MiniMapMargin * UIScale, Canvas->ClipY - MapHeight - MiniMapMargin * UIScale);
 
 		if (MiniMapTexture)
 		{
@@ -162,47 +216,173 @@ void AStrategyHUD::DrawMiniMap()
 			MapTileItem.Texture = MiniMapTexture->Resource;
 			MapTileItem.Size = FVector2D( MapWidth, MapHeight );
 			MapTileItem.BlendMode = SE_BLEND_Opaque;
-			Canvas->DrawItem( MapTileItem, FVector2D( MiniMapMargin * UIScale, Canvas->ClipY - MapHeight - MiniMapMargin * UIScale ) );
+			Canvas->DrawItem( MapTileItem, MapPosition );
 		}
-		FCanvasTileItem TileItem( FVector2D( 0.0f, 0.0f), FVector2D( 0.0f, 0.0f ), FLinearColor::White );
-		TileItem.Size = FVector2D( 6 * UIScale, 6 * UIScale );
-		for (AStrategyChar* TestChar : TActorRange<AStrategyChar>(GetWorld()))
+
+		// buildings only change on construction, units move slowly on mini map scale so a few updates per second are enough
+		const FBox2D MapRect(MapPosition, MapPosition + FVector2D(MapWidth, MapHeight));
+		if (MyGameState->GetBuildingsRevision() != MiniMapBuildingsRevision || !(MapRect == MiniMapBuildingRect))
 		{
-			if (TestChar->GetHealth() > 0 )
+			UpdateMiniMapBuildings(MyGameState, PC->GetTeamNum(), MapRect);
+		}
+		if (MiniMapBuildingTris.Num() > 0)
+		{
+			FCanvasTriangleItem BuildingsItem(MiniMapBuildingTris, GWhiteTexture);
+			BuildingsItem.BlendMode = SE_BLEND_Translucent;
+			Canvas->DrawItem(BuildingsItem);
+		}
+
+		const float RealTime = GetWorld()->GetRealTimeSeconds();
+		if (RealTime >= NextMiniMapUnitUpdateTime || !(MapRect == MiniMapUnitRect))
+		{
+			NextMiniMapUnitUpdateTime = RealTime + 1.0f / FMath::Max(MiniMapUnitUpdateRate, 1.0f);
+			UpdateMiniMapUnits(MyGameState, PC->GetTeamNum(), MapRect);
+		}
+		if (MiniMapUnitTris.Num() > 0)
+		{
+			FCanvasTriangleItem UnitsItem(MiniMapUnitTris, GWhiteTexture);
+			Canvas->DrawItem(UnitsItem);
+		}
+
+		UpdateMiniMapView(MyGameState);
+	} 
+}
+
+/** @returns location on mini map, -1 to 1 across world bounds */
+static FVector2D WorldToMiniMap(const FBox& WorldBounds, const FVector& Location)
+{
+	// Use a fixed yaw of 270.0f here instead of calculating (270.0f + MyGameState->MiniMapCamera->GetRootComponent()->GetComponentRotation().Roll).
+	static const FRotationMatrix RotationMatrix(FRotator(0.0f, 270.0f, 0.0f));
+	const FVector WorldExtent = WorldBounds.GetExtent();
+	const FVector CenterRelativeLocation = RotationMatrix.TransformPosition(Location - WorldBounds.GetCenter());
+	return FVector2D(CenterRelativeLocation.X / WorldExtent.X, CenterRelativeLocation.Y / WorldExtent.Y);
+}
+
+/** add screen space square as two untextured triangles */
+static void AddMiniMapMarker(TArray<FCanvasUVTri>& Tris, const FVector2D& Position, float Size, const FLinearColor& Color)
+{
+	FCanvasUVTri Tri;
+	Tri.V0_Color = Tri.V1_Color = Tri.V2_Color = Color;
+	Tri.V0_Pos = Position;
+	Tri.V1_Pos = Position + FVector2D(Size, 0.0f);
+	Tri.V2_Pos = Position + FVector2D(Size, Size);
+	Tris.Add(Tri);
+	Tri.V1_Pos = Position + FVector2D(0.0f, Size);
+	Tris.Add(Tri);
+}
+
+void AStrategyHUD::UpdateMiniMapBuildings(const AStrategyGameState* GameState, uint8 PlayerTeam, const FBox2D& MapRect)
+{
+	MiniMapBuildingsRevision = GameState->GetBuildingsRevision();
+	MiniMapBuildingRect = MapRect;
+	MiniMapBuildingTris.Reset();
+
+	const AStrategyGameMode* const GameMode = GetWorld()->GetAuthGameMode<AStrategyGameMode>();
+	const UClass* const EmptySlotClass = GameMode ? *GameMode->EmptyWallSlotClass : nullptr;
+	const FVector2D MapHalfSize = MapRect.GetSize() * 0.5f;
+	const float MarkerSize = 10 * UIScale;
+
+	// 0 - unknown/neutral team, two teams in total
+	for (int8 Team = 1; Team < EStrategyTeam::MAX; Team++)
+	{
+		const FPlayerData* const TeamData = GameState->GetPlayerData(Team);
+		for (const TWeakObjectPtr<AActor>& BuildingPtr : TeamData->BuildingsList)
+		{
+			const AStrategyBuilding* const TestBuilding = Cast<AStrategyBuilding>(BuildingPtr.Get());
+
+			// skip empty slots and buildings that are being replaced
+			if (TestBuilding == nullptr || TestBuilding->GetClass() == EmptySlotClass || TestBuilding->GetLifeSpan() > 0.0f)
 			{
-				AStrategyAIController* AIController = Cast<AStrategyAIController>(TestChar->Controller);
-				if (AIController != NULL && AIController->IsLogicEnabled())
-				{
-					FLinearColor DrawColor;
-					if (PC != NULL && TestChar->GetTeamNum() == PC->GetTeamNum())
-					{
-						DrawColor = FColor( 49, 137, 253, 255);
-					} 
-					else
-					{
-						DrawColor = FColor( 242, 114, 16, 255);
-					}
-					const FVector CenterRelativeLocation = RotationMatrix.TransformPosition(TestChar->GetActorLocation() - WorldCenter);
-					const FVector2D MiniMapPoint = FVector2D(CenterRelativeLocation.X / WorldExtent.X, CenterRelativeLocation.Y / WorldExtent.Y);
-					TileItem.SetColor( DrawColor );
-					Canvas->DrawItem( TileItem, FVector2D( Offset.X + MiniMapPoint.X * (MapWidth/2.0f), Offset.Y + MiniMapPoint.Y * (MapHeight/2.0f) ) );
-				}
+				continue;
 			}
+
+			FLinearColor DrawColor = (Team == PlayerTeam) ? FLinearColor(FColor(49, 137, 253, 255)) : FLinearColor(FColor(242, 114, 16, 255));
+			if (!TestBuilding->IsBuildFinished())
+			{
+				DrawColor.A = 0.5f;
+			}
+			const FVector2D MiniMapPoint = WorldToMiniMap(GameState->WorldBounds, TestBuilding->GetActorLocation());
+			AddMiniMapMarker(MiniMapBuildingTris, MapRect.GetCenter() + MiniMapPoint * MapHalfSize - FVector2D(MarkerSize, MarkerSize) * 0.5f, MarkerSize, DrawColor);
 		}
+	}
+}
 
+void AStrategyHUD::UpdateMiniMapUnits(const AStrategyGameState* GameState, uint8 PlayerTeam, const FBox2D& MapRect)
+{
+	MiniMapUnitRect = MapRect;
+	MiniMapUnitTris.Reset();
+
+	const FVector2D MapSize = MapRect.GetSize();
+	const float DotSize = 6 * UIScale;
+	const int32 NumCellsX = FMath::CeilToInt(MapSize.X / DotSize);
+	const int32 NumCellsY = FMath::CeilToInt(MapSize.Y / DotSize);
+	if (NumCellsX <= 0 || NumCellsY <= 0)
+	{
+		return;
+	}
+	MiniMapUnitCells.Reset();
+	MiniMapUnitCells.AddZeroed(NumCellsX * NumCellsY);
+
+	// units crowding the same cell share a single dot, enemies are only shown where the player's team can see
+	const FStrategyVisibilityGrid& VisibilityGrid = GameState->GetVisibilityGrid();
+	const bool bUseVisibility = PlayerTeam != EStrategyTeam::Unknown;
+	const FStrategyUnitRegistry& Registry = GameState->GetUnitRegistry();
+	const TArray<FVector>& Locations = Registry.GetLocations();
+	const TArray<uint8>& Teams = Registry.GetTeams();
+	const TArray<float>& Health = Registry.GetHealth();
+	const TArray<bool>& LogicEnabled = Registry.GetLogicEnabled();
+	for (int32 i = 0; i < Registry.Num(); i++)
+	{
+		if (Health[i] > 0 && LogicEnabled[i] && (!bUseVisibility || Teams[i] == PlayerTeam || VisibilityGrid.IsVisible(PlayerTeam, Locations[i])))
+		{
+			const FVector2D MiniMapPoint = WorldToMiniMap(GameState->WorldBounds, Locations[i]);
+			const int32 CellX = FMath::FloorToInt((MiniMapPoint.X + 1.0f) * 0.5f * NumCellsX);
+			const int32 CellY = FMath::FloorToInt((MiniMapPoint.Y + 1.0f) * 0.5f * NumCellsY);
+			if (CellX >= 0 && CellX < NumCellsX && CellY >= 0 && CellY < NumCellsY)
+			{
+				MiniMapUnitCells[CellY * NumCellsX + CellX] |= (Teams[i] == PlayerTeam) ? 1 : 2;
+			}
+		}
+	}
 
-		ULocalPlayer* MyPlayer =  Cast<ULocalPlayer>(PC->Player);
-		FVector2D ScreenCorners[4] = { FVector2D(0, 0), FVector2D(Canvas->ClipX, 0), FVector2D(Canvas->ClipX, Canvas->ClipY), FVector2D(0, Canvas->ClipY) };
-		const FPlane GroundPlane = FPlane(FVector(0, 0, MyGameState->WorldBounds.Max.Z), FVector::UpVector);
-		for (int32 i = 0; i < 4; i++)
+	const FLinearColor TeamColors[] = { FColor( 49, 137, 253, 255), FColor( 242, 114, 16, 255) };
+	for (int32 CellIndex = 0; CellIndex < MiniMapUnitCells.Num(); CellIndex++)
+	{
+		const uint8 Cell = MiniMapUnitCells[CellIndex];
+		for (int32 TeamIndex = 0; TeamIndex < ARRAY_COUNT(TeamColors); TeamIndex++)
 		{
-			FVector RayOrigin, RayDirection;
-			FStrategyHelpers::DeprojectScreenToWorld(ScreenCorners[i], MyPlayer, RayOrigin, RayDirection);
-			const FVector GroundPoint = FStrategyHelpers::IntersectRayWithPlane(RayOrigin, RayDirection, GroundPlane);
-			const FVector CenterRelativeLocation = RotationMatrix.TransformPosition(GroundPoint - WorldCenter);
-			MiniMapPoints[i] = FVector2D(CenterRelativeLocation.X / WorldExtent.X, CenterRelativeLocation.Y / WorldExtent.Y);
+			if (Cell & (1 << TeamIndex))
+			{
+				const FVector2D Position = MapRect.Min + FVector2D(CellIndex % NumCellsX, CellIndex / NumCellsX) * DotSize;
+				AddMiniMapMarker(MiniMapUnitTris, Position, DotSize, TeamColors[TeamIndex]);
+			}
 		}
-	} 
+	}
+}
+
+void AStrategyHUD::UpdateMiniMapView(const AStrategyGameState* GameState)
+{
+	const AStrategyPlayerController* const PC = Cast<AStrategyPlayerController>(PlayerOwner);
+	if (PC == nullptr)
+	{
+		return;
+	}
+
+	const FStrategyViewProjection& ViewProjection = PC->GetViewProjection();
+	if (!ViewProjection.IsValid() || ViewProjection.GetRevision() == MiniMapViewRevision)
+	{
+		return;
+	}
+	MiniMapViewRevision = ViewProjection.GetRevision();
+
+	const FVector2D ScreenCorners[4] = { FVector2D(0, 0), FVector2D(Canvas->ClipX, 0), FVector2D(Canvas->ClipX, Canvas->ClipY), FVector2D(0, Canvas->ClipY) };
+	const FPlane GroundPlane = FPlane(FVector(0, 0, GameState->WorldBounds.Max.Z), FVector::UpVector);
+	FVector GroundPoints[4];
+	ViewProjection.DeprojectToPlane(ScreenCorners, 4, GroundPlane, GroundPoints);
+	for (int32 i = 0; i < 4; i++)
+	{
+		MiniMapPoints[i] = WorldToMiniMap(GameState->WorldBounds, GroundPoints[i]);
+	}
 }
 
 void AStrategyHUD::BuildMenuWidgets()
@@ -230,7 +410,7 @@ void AStrategyHUD::BuildMenuWidgets()
 				);
 
 				MyHUDMenuWidget->ActionButtonsWidget->SetVisibility(EVisibility::Visible);
-				MyHUDMenuWidget->ActionWidgetPosition.BindUObject(this,&AStrategyHUD::GetActionsWidgetPos);
+				MyHUDMenuWidget->SetActionsWidgetPos(ActionGridPos);
 
 				if (ActionPauseTexture != NULL)
 				{
@@ -304,6 +484,10 @@ void AStrategyHUD::DrawLives() const
 	AStrategyBuilding_Brewery const* const Brewery = MyGameState ? MyGameState->GetPlayerData(EStrategyTeam::Player)->Brewery.Get() : NULL;
 
 	uint8 const Lives = Brewery ? Brewery->GetNumberOfLives() : 0;
+	if (LivesTexture == NULL || Lives == 0)
+	{
+		return;
+	}
 
 	float const TextureDrawWidth = LivesTexture->GetSurfaceWidth() * UIScale;
 	float const TextureDrawHeight =  LivesTexture->GetSurfaceHeight() * UIScale;
@@ -318,55 +502,60 @@ void AStrategyHUD::DrawLives() const
 	}
 }
 
-void AStrategyHUD::DrawHealthBar(AActor* ForActor, float HealthPercentage, int32 BarHeight, int32 OffsetY) const
+/** add screen space rectangle as two triangles */
+static void AddCanvasQuad(TArray<FCanvasUVTri>& Tris, const FVector2D& Position, const FVector2D& Size, const FVector2D& UV1, const FLinearColor& Color)
 {
-	FBox BB = ForActor->GetComponentsBoundingBox();
-	FVector Center = BB.GetCenter();
-	FVector Extent = BB.GetExtent();
-	FVector2D Center2D = FVector2D(Canvas->Project(FVector(Center.X,Center.Y,Center.Z + Extent.Z)));
-	float ActorExtent = 40;
-	if (Cast<APawn>(ForActor) != NULL)
-	{
-		AStrategyChar* StrategyChar = Cast<AStrategyChar>(ForActor);
-		if( ( StrategyChar != NULL ) && ( StrategyChar->GetCapsuleComponent() != NULL ) )
-		{
-			ActorExtent = StrategyChar->GetCapsuleComponent()->GetScaledCapsuleRadius();
-		}
-	}
-	else if (Cast<AStrategyBuilding>(ForActor) != NULL)
+	FCanvasUVTri Tri;
+	Tri.V0_Color = Tri.V1_Color = Tri.V2_Color = Color;
+
+	Tri.V0_Pos = Position;
+	Tri.V0_UV = FVector2D(0.0f, 0.0f);
+	Tri.V1_Pos = FVector2D(Position.X + Size.X, Position.Y);
+	Tri.V1_UV = FVector2D(UV1.X, 0.0f);
+	Tri.V2_Pos = Position + Size;
+	Tri.V2_UV = UV1;
+	Tris.Add(Tri);
+
+	Tri.V1_Pos = FVector2D(Position.X, Position.Y + Size.Y);
+	Tri.V1_UV = FVector2D(0.0f, UV1.Y);
+	Tris.Add(Tri);
+}
+
+void AStrategyHUD::AddHealthBar(const FVector& Anchor, float HalfWidth, float HealthPercentage, float BarHeight, bool bPlayerTeam)
+{
+	// cull before paying for projection
+	if (Canvas->SceneView != nullptr && !Canvas->SceneView->ViewFrustum.IntersectSphere(Anchor, HalfWidth))
 	{
-		Center2D = FVector2D(Canvas->Project(ForActor->GetActorLocation()));
-		ActorExtent = 60;
+		return;
 	}
 
-	FVector Pos1 = Canvas->Project(FVector(Center.X,Center.Y - ActorExtent*2, Center.Z + Extent.Z));
-	FVector Pos2 = Canvas->Project(FVector(Center.X,Center.Y + ActorExtent*2, Center.Z + Extent.Z));
-	float HealthBarLength = (Pos2-Pos1).Size2D();
+	const FVector2D Pos1 = FVector2D(Canvas->Project(Anchor - FVector(0.0f, HalfWidth, 0.0f)));
+	const FVector2D Pos2 = FVector2D(Canvas->Project(Anchor + FVector(0.0f, HalfWidth, 0.0f)));
+	const FVector2D Center2D = (Pos1 + Pos2) * 0.5f;
+	const float HealthBarLength = (Pos2 - Pos1).Size();
+	const float FilledLength = HealthBarLength * HealthPercentage;
+	const float X = Center2D.X - HealthBarLength/2;
 
-	AStrategyPlayerController* MyPC = GetPlayerController();
-	IStrategyTeamInterface* ActorTeam = Cast<IStrategyTeamInterface>(ForActor);
-	UTexture2D* HealthBarTexture = EnemyTeamHPTexture;
+	AddCanvasQuad(bPlayerTeam ? PlayerHealthBarTris : EnemyHealthBarTris, FVector2D(X, Center2D.Y), FVector2D(FilledLength, BarHeight), FVector2D(HealthPercentage, 1.0f), FLinearColor::White);
 
-	if (ActorTeam != NULL && MyPC != NULL && ActorTeam->GetTeamNum() == MyPC->GetTeamNum())
-	{
-		HealthBarTexture = PlayerTeamHPTexture;
-	} 
-	float X = Center2D.X - HealthBarLength/2;
-	float Y = Center2D.Y + OffsetY;
-	FCanvasTileItem TileItem( FVector2D( X, Y ), HealthBarTexture->Resource, FVector2D( HealthBarLength * HealthPercentage,  BarHeight ), FLinearColor::White );
-	TileItem.BlendMode = SE_BLEND_Translucent;
-	TileItem.UV1 = FVector2D(HealthPercentage, 1.0f);
-
-	Canvas->DrawItem( TileItem );
 	//Fill the rest of health with gray gradient texture
-	X = Center2D.X-HealthBarLength/2 + HealthBarLength * HealthPercentage;
-	Y = Center2D.Y + OffsetY;
-	TileItem.Position = FVector2D( X, Y );
-	TileItem.Texture = BarFillTexture->Resource;
-	TileItem.UV1 = FVector2D(1.0f, 1.0f);
-	TileItem.Size = FVector2D( HealthBarLength * (1.0f - HealthPercentage), BarHeight );
-	TileItem.SetColor(FLinearColor(0.5f, 0.5f, 0.5f, 0.5f));
-	Canvas->DrawItem( TileItem );	
+	AddCanvasQuad(HealthBarFillTris, FVector2D(X + FilledLength, Center2D.Y), FVector2D(HealthBarLength - FilledLength, BarHeight), FVector2D(1.0f, 1.0f), FLinearColor(0.5f, 0.5f, 0.5f, 0.5f));
+}
+
+void AStrategyHUD::FlushHealthBars()
+{
+	TArray<FCanvasUVTri>* const Batches[] = { &PlayerHealthBarTris, &EnemyHealthBarTris, &HealthBarFillTris };
+	UTexture2D* const Textures[] = { PlayerTeamHPTexture, EnemyTeamHPTexture, BarFillTexture };
+	for (int32 i = 0; i < ARRAY_COUNT(Batches); i++)
+	{
+		if (Batches[i]->Num() > 0 && Textures[i] != nullptr)
+		{
+			FCanvasTriangleItem TriangleItem(*Batches[i], Textures[i]->Resource);
+			TriangleItem.BlendMode = SE_BLEND_Translucent;
+			Canvas->DrawItem(TriangleItem);
+		}
+		Batches[i]->Reset();
+	}
 }
 
 
@@ -0,0 +1,78 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyHitMaskCommandlet.h"
+#include "StrategyHitMaskUserData.h"
+#include "EngineUtils.h"
+
+UStrategyHitMaskCommandlet::UStrategyHitMaskCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UStrategyHitMaskCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Paths = TexturePaths;
+	FString Path;
+	if (FParse::Value(*Params, TEXT("Path="), Path))
+	{
+		Paths.Reset();
+		Paths.Add(Path);
+	}
+
+	int32 NumSaved = 0;
+	int32 NumFailed = 0;
+	for (const FString& TexturePath : Paths)
+	{
+		TArray<UObject*> Assets;
+		EngineUtils::FindOrLoadAssetsByPath(TexturePath, Assets, EngineUtils::ATL_Regular);
+
+		for (UObject* const Asset : Assets)
+		{
+			UTexture2D* const Texture = Cast<UTexture2D>(Asset);
+			if (Texture == nullptr)
+			{
+				continue;
+			}
+
+			UStrategyHitMaskUserData* Mask = Texture->GetAssetUserData<UStrategyHitMaskUserData>();
+			const TArray<uint32> OldBits = Mask ? Mask->Bits : TArray<uint32>();
+			if (Mask == nullptr)
+			{
+				Mask = NewObject<UStrategyHitMaskUserData>(Texture);
+				Texture->AddAssetUserData(Mask);
+			}
+
+			Mask->Rebuild();
+			if (Mask->Bits.Num() == 0 || Mask->Bits == OldBits)
+			{
+				continue;
+			}
+
+			UPackage* const Package = Texture->GetOutermost();
+			const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+			if (UPackage::SavePackage(Package, nullptr, RF_Standalone, *Filename))
+			{
+				UE_LOG(LogGame, Display, TEXT("Hit mask: saved %s (%dx%d)"), *Texture->GetPathName(), Mask->SizeX, Mask->SizeY);
+				NumSaved++;
+			}
+			else
+			{
+				UE_LOG(LogGame, Error, TEXT("Hit mask: failed to save %s"), *Filename);
+				NumFailed++;
+			}
+		}
+	}
+
+	UE_LOG(LogGame, Display, TEXT("Hit mask: %d textures saved, %d failed"), NumSaved, NumFailed);
+	return NumFailed > 0 ? 1 : 0;
+#else
+	UE_LOG(LogGame, Error, TEXT("Hit masks can only be built in the editor"));
+	return 1;
+#endif
+}
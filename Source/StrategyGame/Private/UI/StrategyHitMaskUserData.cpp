@@ -0,0 +1,34 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "StrategyGame.h"
+#include "StrategyHitMaskUserData.h"
+#include "StrategyButtonImageCache.h"
+
+UStrategyHitMaskUserData::UStrategyHitMaskUserData(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, SizeX(0)
+	, SizeY(0)
+{
+}
+
+void UStrategyHitMaskUserData::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	// texture might have been reimported since the mask was built
+	Rebuild();
+}
+
+void UStrategyHitMaskUserData::Rebuild()
+{
+#if WITH_EDITORONLY_DATA
+	UTexture2D* const Texture = Cast<UTexture2D>(GetOuter());
+	FStrategyHitMask Mask;
+	if (Texture != nullptr && FStrategyHitMask::BuildFromSource(Texture, Mask))
+	{
+		SizeX = Mask.SizeX;
+		SizeY = Mask.SizeY;
+		Bits = MoveTemp(Mask.Bits);
+	}
+#endif
+}
@@ -2,6 +2,7 @@
 
 #include "StrategyGame.h"
 #include "SlateGameResources.h"
+#include "StrategyStartupTrace.h"
 
 TSharedPtr< FSlateStyleSet > FStrategyStyle::StrategyStyleInstance = NULL;
 
@@ -9,6 +10,7 @@ void FStrategyStyle::Initialize()
 {
 	if ( !StrategyStyleInstance.IsValid() )
 	{
+		FStrategyStartupScope StartupScope(TEXT("HUDStyle"));
 		StrategyStyleInstance = Create();
 		FSlateStyleRegistry::RegisterSlateStyle( *StrategyStyleInstance );
 	}
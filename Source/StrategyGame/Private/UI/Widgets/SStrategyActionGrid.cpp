@@ -17,6 +17,8 @@ void SStrategyActionGrid::Construct(const FArguments& InArgs)
 	{
 		ActionButtons.Add(MakeShareable(new FActionButtonInfo()));
 	}
+	CachedTexts.Reset();
+	CachedTexts.AddDefaulted(GridRows*GridCols);
 
 	ChildSlot
 	.VAlign(VAlign_Fill)
@@ -53,6 +55,7 @@ void SStrategyActionGrid::Construct(const FArguments& InArgs)
 
 FMargin SStrategyActionGrid::GetActionPadding(int32 idx) const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	const float SmallMargin = 6;
 	const float LargeMargin = 60;
 	//this is difference in size from big action icon(which is used only in the center) to small action icon divided by 2
@@ -88,38 +91,65 @@ FReply SStrategyActionGrid::TriggerAction(int32 idx) const
 	return FReply::Handled();
 }
 
+void SStrategyActionGrid::InvalidateQueueTexts()
+{
+	for (FCachedActionTexts& Cached : CachedTexts)
+	{
+		Cached.bQueueDirty = true;
+	}
+}
+
 FText SStrategyActionGrid::GetActionCostText(int32 idx) const
 {
-	return ActionButtons[idx]->Data.ActionCost != 0 ? FText::AsNumber(ActionButtons[idx]->Data.ActionCost) : FText::GetEmpty();
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
+	FCachedActionTexts& Cached = CachedTexts[idx];
+	const int32 ActionCost = ActionButtons[idx]->Data.ActionCost;
+	if (Cached.ActionCost != ActionCost)
+	{
+		Cached.ActionCost = ActionCost;
+		INC_DWORD_STAT(STAT_StrategyHUDTextBuilds);
+		Cached.CostText = ActionCost != 0 ? FText::AsNumber(ActionCost) : FText::GetEmpty();
+	}
+	return Cached.CostText;
 }
 
 FText SStrategyActionGrid::GetActionText(int32 idx) const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	return ActionButtons[idx]->Data.StrButtonText;
 }
 
 FText SStrategyActionGrid::GetActionQueueText(int32 idx) const
 {
-	FText Result = FText::GetEmpty();
-	if (ActionButtons[idx]->Data.GetQueueLengthDelegate.IsBound())
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
+	// rebinding the delegate for another building gives it a new handle
+	FCachedActionTexts& Cached = CachedTexts[idx];
+	const FGetQueueLength& QueueDelegate = ActionButtons[idx]->Data.GetQueueLengthDelegate;
+	if (Cached.bQueueDirty || Cached.QueueHandle != QueueDelegate.GetHandle())
 	{
-		Result = ActionButtons[idx]->Data.GetQueueLengthDelegate.Execute();
+		Cached.bQueueDirty = false;
+		Cached.QueueHandle = QueueDelegate.GetHandle();
+		INC_DWORD_STAT(STAT_StrategyHUDTextBuilds);
+		Cached.QueueText = QueueDelegate.IsBound() ? QueueDelegate.Execute() : FText::GetEmpty();
 	}
-	return Result;
+	return Cached.QueueText;
 }
 
 TOptional<EVisibility> SStrategyActionGrid::GetCoinIconVisibility(int32 idx) const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	return ActionButtons[idx]->Data.ActionCost == 0 ? EVisibility::Collapsed : EVisibility::Visible;
 }
 
 FText SStrategyActionGrid::GetTooltip(int32 idx) const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	return ActionButtons[idx]->Data.StrTooltip;
 }
 
 bool SStrategyActionGrid::GetEnabled(int32 idx) const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	const AStrategyPlayerController* const PC = Cast<AStrategyPlayerController>(OwnerHUD->PlayerOwner);
 	AStrategyGameState* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
 	if (MyGameState && PC)
@@ -143,5 +173,6 @@ bool SStrategyActionGrid::GetEnabled(int32 idx) const
 
 EVisibility SStrategyActionGrid::GetActionVisibility(int32 idx) const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	return ActionButtons[idx]->Widget->IsAnimating() ? EVisibility::Visible : ActionButtons[idx]->Data.Visibility;
 }
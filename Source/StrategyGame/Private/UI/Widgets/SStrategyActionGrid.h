@@ -25,7 +25,25 @@ public:
 	/** 3 x 3 grid of action buttons */
 	TArray< TSharedPtr<FActionButtonInfo> > ActionButtons;
 
+	/** queue length of actions changed, refresh queue text on next paint */
+	void InvalidateQueueTexts();
+
 private:
+	/** texts built from action data, rebuilt only when the data they were built from changes */
+	struct FCachedActionTexts
+	{
+		/** cost the cost text was built for */
+		int32 ActionCost;
+		FText CostText;
+
+		/** queue length delegate the queue text was built with, and if it needs to be built again */
+		FDelegateHandle QueueHandle;
+		bool bQueueDirty;
+		FText QueueText;
+
+		FCachedActionTexts() : ActionCost(0), bQueueDirty(false) {}
+	};
+
 	/** says that we can support keyboard focus */
 	virtual bool SupportsKeyboardFocus() const override { return true; }
 
@@ -48,6 +66,9 @@ private:
 	/** gets enabled state of the action */
 	bool	GetEnabled(int32 idx) const;
 
+	/** cached texts of each action button */
+	mutable TArray<FCachedActionTexts> CachedTexts;
+
 	/** shared pointer to action grid panel */
 	TSharedPtr<SGridPanel> ActionGrid;
 	/** Pointer to our parent HUD */
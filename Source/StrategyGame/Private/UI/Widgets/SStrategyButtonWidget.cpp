@@ -147,12 +147,20 @@ const FSlateBrush*  SStrategyButtonWidget::GetButtonImage() const
 
 void SStrategyButtonWidget::SetImage(UTexture2D* Texture)
 {
-	if (Texture != NULL)
+	if (Texture != NULL && ButtonTexture != Texture)
 	{
-		ButtonImage.Reset();
-		ButtonImage = FDeferredCleanupSlateBrush::CreateBrush(Texture, FVector2D(Texture->GetSizeX(), Texture->GetSizeY()));
-		AlphaMap.Reset();
-		AlphaMap = FStrategyHelpers::CreateAlphaMapFromTexture(Texture);
+		ButtonTexture = Texture;
+		if (OwnerHUD.IsValid())
+		{
+			const FStrategyButtonImage& Image = OwnerHUD->GetButtonImageCache().FindOrAdd(Texture);
+			ButtonImage = Image.Brush;
+			HitMask = Image.HitMask;
+		}
+		else
+		{
+			ButtonImage = FDeferredCleanupSlateBrush::CreateBrush(Texture, FVector2D(Texture->GetSizeX(), Texture->GetSizeY()));
+			HitMask = FStrategyHelpers::CreateHitMaskFromTexture(Texture);
+		}
 	}
 }
 
@@ -209,10 +217,36 @@ FSlateColor SStrategyButtonWidget::GetTintColor() const
 
 FReply SStrategyButtonWidget::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
+	if (!IsImageHit(MyGeometry, MouseEvent.GetScreenSpacePosition()))
+	{
+		return FReply::Unhandled();
+	}
 	bIsMouseButtonDown = true;
 	return FReply::Handled();
 }
 
+bool SStrategyButtonWidget::IsImageHit(const FGeometry& MyGeometry, const FVector2D& ScreenPosition) const
+{
+	// no mask saved with the texture, the whole button can be clicked
+	if (!HitMask.IsValid() || HitMask->Bits.Num() == 0 || !ButtonImage.IsValid())
+	{
+		return true;
+	}
+
+	// image is centered in the button at its own size
+	const FVector2D ImageSize = ButtonImage->GetSlateBrush()->ImageSize;
+	if (ImageSize.X <= 0 || ImageSize.Y <= 0)
+	{
+		return true;
+	}
+	const FVector2D ImagePosition = MyGeometry.AbsoluteToLocal(ScreenPosition) - (MyGeometry.GetLocalSize() - ImageSize) * 0.5f;
+	if (ImagePosition.X < 0 || ImagePosition.Y < 0 || ImagePosition.X >= ImageSize.X || ImagePosition.Y >= ImageSize.Y)
+	{
+		return false;
+	}
+	return HitMask->IsHit(ImagePosition / ImageSize);
+}
+
 FReply SStrategyButtonWidget::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
 	// we handle this message so that the game doesn't get mouse moves without mouse downs/ups
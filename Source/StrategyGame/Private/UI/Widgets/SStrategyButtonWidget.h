@@ -5,6 +5,7 @@
 #include "SlateBasics.h"
 #include "SlateExtras.h"
 #include "StrategyTypes.h"
+#include "StrategyButtonImageCache.h"
 
 DECLARE_DELEGATE_TwoParams(FOnMouseEnter, const FGeometry&, const FPointerEvent&);
 DECLARE_DELEGATE_OneParam(FOnMouseLeave, const FPointerEvent&);
@@ -81,9 +82,12 @@ public:
 	void DeferredHide(bool bInstant = false);
 	bool IsAnimating() const;
 
-	/** brush resource that represents a button */
+	/** checks hit mask of the image under screen position, clicks on transparent parts go through the button */
+	bool IsImageHit(const FGeometry& MyGeometry, const FVector2D& ScreenPosition) const;
+
+	/** brush resource that represents a button, shared with other buttons showing the same texture */
 	TSharedPtr<ISlateBrushSource> ButtonImage;
-	TSharedPtr<TArray<uint8>> AlphaMap;
+	TSharedPtr<const FStrategyHitMask> HitMask;
 
 protected:
 	/** the delegate to execute when the button is clicked */
@@ -126,6 +130,9 @@ protected:
 	bool bIsUserActionRequired;
 	bool bMouseCursorVisible;
 
+	/** texture of ButtonImage */
+	TWeakObjectPtr<UTexture2D> ButtonTexture;
+
 	/** Pointer to our parent HUD */
 	TWeakObjectPtr<class AStrategyHUD> OwnerHUD;
 };
@@ -8,6 +8,7 @@
 #include "StrategyHUDSoundsWidgetStyle.h"
 #include "StrategyHUDWidgetStyle.h"
 #include "StrategyCheatManager.h"
+#include "StrategyBuilding_Brewery.h"
 
 #include "Engine/Console.h"
 
@@ -22,8 +23,11 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 	Visibility.Bind(this, &SStrategySlateHUDWidget::GetSlateVisibility);
 	UIScale.Bind(this, &SStrategySlateHUDWidget::GetUIScale);
 	MiniMapBorderMargin = 20;
+	ActionsSlot = nullptr;
+	ActionsWidgetPos = FVector2D::ZeroVector;
+	DisplayedWaitSeconds = 0;
+	DisplayedResultFontSize = 0;
 
-	TSharedPtr<SVerticalBox> MenuBox;
 	int32 ButtonIndex = 0;
 	ChildSlot
 	.VAlign(VAlign_Fill)
@@ -40,7 +44,8 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 			[
 				SNew(SCanvas)
 				+SCanvas::Slot()
-				.Position(TAttribute<FVector2D>(this,&SStrategySlateHUDWidget::GetActionsWidgetPos))
+				.Expose(ActionsSlot)
+				.Position(ActionsWidgetPos)
 				.Size(FVector2D(600,800))
 				[
 					SAssignNew(ActionButtonsWidget,SStrategyActionGrid)
@@ -52,7 +57,7 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 			.HAlign(HAlign_Left)
 			.Padding(FMargin(MiniMapBorderMargin,0,0,MiniMapBorderMargin))
 			[
-				SNew(SBorder)
+				SAssignNew(MiniMapFrame, SBorder)
 				.BorderImage(&HUDStyle->MinimapFrameBrush)
 				.Padding(FMargin(0))
 				[
@@ -80,14 +85,13 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 					.WidthOverride(200)
 					.HeightOverride(60)
 					[
-						SNew(SHorizontalBox)
-						.Visibility(this, &SStrategySlateHUDWidget::GetResourcesVisibility)
+						SAssignNew(ResourcesBox, SHorizontalBox)
+						.Visibility(EVisibility::Collapsed)
 						+SHorizontalBox::Slot()
 						.AutoWidth()
 						[
-							SNew(STextBlock)
+							SAssignNew(ResourcesText, STextBlock)
 							.TextStyle(FStrategyStyle::Get(), "StrategyGame.ResourcesTextStyle")
-							.Text(this, &SStrategySlateHUDWidget::GetResourcesAmount)
 						]
 						+SHorizontalBox::Slot()
 						.AutoWidth()
@@ -112,9 +116,8 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 			.VAlign(VAlign_Top)
 			.HAlign(HAlign_Left)
 			[
-				SNew(STextBlock)
+				SAssignNew(GameTimeText, STextBlock)
 				.TextStyle(FStrategyStyle::Get(), "StrategyGame.ResourcesTextStyle")
-				.Text(this, &SStrategySlateHUDWidget::GetGameTime)
 			]
 			/* Result screen { */
 			+SOverlay::Slot()
@@ -126,9 +129,9 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 				.VAlign(VAlign_Center)
 				.HAlign(HAlign_Center)
 				[
-					SNew(SImage)
-					.Image(this, &SStrategySlateHUDWidget::GetGameResultImage)
-					.Visibility(this, &SStrategySlateHUDWidget::GetResultScreenVisibility)
+					SAssignNew(GameResultImage, SImage)
+					.Image(&HUDStyle->DefeatImage)
+					.Visibility(EVisibility::Collapsed)
 				]
 
 				+SOverlay::Slot()
@@ -141,13 +144,12 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 					.WidthOverride(675)
 					.HeightOverride(310)
 					[
-						SNew(STextBlock)
-						.Visibility(this, &SStrategySlateHUDWidget::GetResultScreenVisibility)
+						SAssignNew(GameResultText, STextBlock)
+						.Visibility(EVisibility::Collapsed)
 						.ShadowColorAndOpacity(FLinearColor::Black)
-						.ColorAndOpacity(this, &SStrategySlateHUDWidget::GetGameResultColor)
+						.ColorAndOpacity(HUDStyle->DefeatTextColor)
 						.ShadowOffset(FIntPoint(-1,1))
-						.Font(this, &SStrategySlateHUDWidget::GetGameResultFont)
-						.Text(this, &SStrategySlateHUDWidget::GetGameResultText)
+						.Font(FCoreStyle::Get().GetFontStyle(TEXT("NormalFont")))
 					]
 				]
 			]
@@ -170,7 +172,7 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 					.VAlign(VAlign_Center)
 					.HAlign(HAlign_Center)
 					[
-						SAssignNew(MenuBox, SVerticalBox)
+						SAssignNew(PauseMenuBox, SVerticalBox)
 						+SVerticalBox::Slot()
 						[
 							SAssignNew(PauseMenuButtons[ButtonIndex++], SStrategyButtonWidget)
@@ -202,7 +204,7 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 
 	{
 		// Cheats
-		MenuBox->AddSlot()
+		PauseMenuBox->AddSlot()
 			[
 				SAssignNew(PauseMenuButtons[ButtonIndex++], SStrategyButtonWidget)
 				.OwnerHUD(OwnerHUD)
@@ -217,7 +219,7 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 
 	if (SupportsQuitButton)
 	{
-		MenuBox->AddSlot()
+		PauseMenuBox->AddSlot()
 		[
 			SAssignNew(PauseMenuButtons[ButtonIndex++], SStrategyButtonWidget)
 			.OwnerHUD(OwnerHUD)
@@ -233,6 +235,7 @@ void SStrategySlateHUDWidget::Construct(const FArguments& InArgs)
 
 FSlateColor SStrategySlateHUDWidget::GetOverlayColor() const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	const FStrategyHUDSoundsStyle& HUDSounds = FStrategyStyle::Get().GetWidgetStyle<FStrategyHUDSoundsStyle>("DefaultStrategyHUDSoundsStyle");
 
 	FLinearColor Result(0,0,0,0.3f);
@@ -253,6 +256,7 @@ FReply SStrategySlateHUDWidget::OnFocusReceived(const FGeometry& MyGeometry, con
 
 float SStrategySlateHUDWidget::GetUIScale() const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	float Result = 0.5f;
 	if ( GEngine && GEngine->GameViewport )
 	{
@@ -267,6 +271,13 @@ float SStrategySlateHUDWidget::GetUIScale() const
 void SStrategySlateHUDWidget::Tick( const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime )
 {
 	SCompoundWidget::Tick( AllottedGeometry, InCurrentTime, InDeltaTime );
+
+	// everything else shown is pushed to widgets by game events, only timers are checked here
+	BindGameEvents();
+	UpdateGameTimeText();
+	UpdateGameResultFont();
+	UpdateExclusionZones(AllottedGeometry);
+
 	//ugly code seeing if the console is open
 	UConsole* ViewportConsole = (GEngine !=NULL && GEngine->GameViewport != NULL) ? GEngine->GameViewport->ViewportConsole : NULL;
 	if (ViewportConsole != NULL && (ViewportConsole->ConsoleState == "Typing" || ViewportConsole->ConsoleState == "Open"))
@@ -289,11 +300,50 @@ void SStrategySlateHUDWidget::Tick( const FGeometry& AllottedGeometry, const dou
 
 EVisibility SStrategySlateHUDWidget::GetSlateVisibility() const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	return bConsoleVisible ? EVisibility::HitTestInvisible : EVisibility::Visible;
 }
 
+/** @returns rect of widget relative to the HUD widget in pixels, invalid if widget isn't visible */
+static FBox2D GetRectInHUD(const FGeometry& HUDGeometry, const SWidget& Widget)
+{
+	if (!Widget.GetVisibility().IsVisible())
+	{
+		return FBox2D(ForceInit);
+	}
+
+	const FGeometry& Geometry = Widget.GetTickSpaceGeometry();
+	const FVector2D Min = Geometry.GetAbsolutePosition() - HUDGeometry.GetAbsolutePosition();
+	return FBox2D(Min, Min + Geometry.GetAbsoluteSize());
+}
+
+void SStrategySlateHUDWidget::UpdateExclusionZones(const FGeometry& AllottedGeometry) const
+{
+	// the HUD widget covers the whole viewport, so rects relative to it are in the same pixels as mouse and touch positions
+	FStrategyExclusionZones& ExclusionZones = OwnerHUD->GetExclusionZones();
+
+	ExclusionZones.SetZone(FStrategyExclusionZones::Zone_MiniMap, GetRectInHUD(AllottedGeometry, *MiniMapFrame));
+
+	FBox2D ActionsRect(ForceInit);
+	for (const TSharedPtr<FActionButtonInfo>& Button : ActionButtonsWidget->ActionButtons)
+	{
+		const FBox2D ButtonRect = GetRectInHUD(AllottedGeometry, *Button->Widget);
+		if (ButtonRect.bIsValid)
+		{
+			ActionsRect += ButtonRect;
+		}
+	}
+	ExclusionZones.SetZone(FStrategyExclusionZones::Zone_ActionGrid, ActionsRect);
+
+	// only the menu buttons, the dimmed background still lets the camera scroll as before
+	ExclusionZones.SetZone(FStrategyExclusionZones::Zone_PauseMenu, bIsPauseMenuActive
+		? GetRectInHUD(AllottedGeometry, *PauseMenuBox)
+		: FBox2D(ForceInit));
+}
+
 FOptionalSize SStrategySlateHUDWidget::GetMiniMapWidth() const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	float Result = 0.0f;
 	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
 	if (MyGameState && MyGameState->MiniMapCamera.IsValid())
@@ -305,6 +355,7 @@ FOptionalSize SStrategySlateHUDWidget::GetMiniMapWidth() const
 
 FOptionalSize SStrategySlateHUDWidget::GetMiniMapHeight() const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	float Result = 0.0f;
 	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
 	if (MyGameState && MyGameState->MiniMapCamera.IsValid())
@@ -319,104 +370,127 @@ FCursorReply SStrategySlateHUDWidget::OnCursorQuery( const FGeometry& MyGeometry
 	return FCursorReply::Cursor(EMouseCursor::Default);
 }
 
-FText SStrategySlateHUDWidget::GetResourcesAmount() const
+void SStrategySlateHUDWidget::BindGameEvents()
 {
-	const AStrategyPlayerController* const PC = Cast<AStrategyPlayerController>(OwnerHUD->PlayerOwner);
 	AStrategyGameState* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	if (MyGameState && PC)
+	if (MyGameState == NULL)
 	{
-		FPlayerData* const PlayerData = MyGameState->GetPlayerData(PC->GetTeamNum());
-		if (PlayerData)
-		{
-			return FText::AsNumber(PlayerData->ResourcesAvailable);
-		}
+		return;
 	}
-	return FText::GetEmpty();
-}
 
-FText SStrategySlateHUDWidget::GetGameTime() const
-{
-	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	if (MyGameState != NULL)
+	if (BoundGameState != MyGameState)
 	{
-		if (MyGameState->GameplayState == EGameplayState::Waiting)
-		{
-			int32 const DisplaySecondsRemaining = FMath::CeilToInt(MyGameState->GetRemainingWaitTime());
-			return FText::Format( NSLOCTEXT("GameFlow", "GameStartsIn", "Game starts in {0}"), FText::AsNumber(DisplaySecondsRemaining) );
-		}
+		BoundGameState = MyGameState;
+		MyGameState->OnResourcesChanged.AddSP(this, &SStrategySlateHUDWidget::OnResourcesChanged);
+		MyGameState->OnGameplayStateChanged.AddSP(this, &SStrategySlateHUDWidget::OnGameplayStateChanged);
+		OnGameplayStateChanged(MyGameState->GameplayState);
 	}
-	return FText::GetEmpty();
-}
 
-FSlateFontInfo SStrategySlateHUDWidget::GetGameResultFont() const
-{
-	FSlateFontInfo ResultFont;
-	const float AnimTime = 1.0f;
-	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	const float GameFinishedTime = MyGameState ? MyGameState->GetGameFinishedTime() : 0.0f;
-	float AnimPercentage = FMath::Min(1.0f, (OwnerHUD->GetWorld()->GetRealTimeSeconds() - GameFinishedTime) / AnimTime);
-	if (GameFinishedTime > 0)
-	{
-		const int32 StartFontSize = 8;
-		const int32 AnimatedFontSize = 70;
-		ResultFont = FSlateFontInfo( FPaths::ProjectContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), FMath::TruncToInt(StartFontSize + AnimatedFontSize * AnimPercentage));
-	}
-	else
+	const AStrategyPlayerController* const PC = Cast<AStrategyPlayerController>(OwnerHUD->PlayerOwner);
+	const FPlayerData* const PlayerData = PC ? MyGameState->GetPlayerData(PC->GetTeamNum()) : NULL;
+	AStrategyBuilding_Brewery* const Brewery = PlayerData ? PlayerData->Brewery.Get() : NULL;
+	if (Brewery != NULL && BoundBrewery != Brewery)
 	{
-		ResultFont = FCoreStyle::Get().GetFontStyle(TEXT("NormalFont"));
+		BoundBrewery = Brewery;
+		Brewery->OnSpawnQueueChanged.AddSP(this, &SStrategySlateHUDWidget::OnSpawnQueueChanged);
+		OnSpawnQueueChanged();
 	}
-	return ResultFont;
 }
 
-FSlateColor SStrategySlateHUDWidget::GetGameResultColor() const
+void SStrategySlateHUDWidget::OnResourcesChanged(uint8 TeamNum)
 {
-	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	return (MyGameState && MyGameState->GetWinningTeam() == EStrategyTeam::Player) ? HUDStyle->VictoryTextColor : HUDStyle->DefeatTextColor;
+	const AStrategyPlayerController* const PC = Cast<AStrategyPlayerController>(OwnerHUD->PlayerOwner);
+	if (PC && PC->GetTeamNum() == TeamNum)
+	{
+		UpdateResourcesText();
+	}
 }
 
-FText SStrategySlateHUDWidget::GetGameResultText() const
+void SStrategySlateHUDWidget::OnGameplayStateChanged(EGameplayState::Type NewState)
 {
-	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	if (MyGameState != NULL)
+	AStrategyGameState const* const MyGameState = BoundGameState.Get();
+	const bool bVictory = (MyGameState && MyGameState->GetWinningTeam() == EStrategyTeam::Player);
+	const EVisibility ResultVisibility = (NewState == EGameplayState::Finished) ? EVisibility::Visible : EVisibility::Collapsed;
+
+	ResourcesBox->SetVisibility(NewState == EGameplayState::Playing ? EVisibility::Visible : EVisibility::Collapsed);
+	UpdateResourcesText();
+
+	GameResultImage->SetImage(bVictory ? &HUDStyle->VictoryImage : &HUDStyle->DefeatImage);
+	GameResultImage->SetVisibility(ResultVisibility);
+	INC_DWORD_STAT(STAT_StrategyHUDTextBuilds);
+	GameResultText->SetText(bVictory ? NSLOCTEXT("GameFlow", "GameWon", "VICTORY") : NSLOCTEXT("GameFlow", "GameLost", "DEFEAT"));
+	GameResultText->SetColorAndOpacity(bVictory ? HUDStyle->VictoryTextColor : HUDStyle->DefeatTextColor);
+	GameResultText->SetVisibility(ResultVisibility);
+
+	DisplayedResultFontSize = 0;
+	if (NewState != EGameplayState::Finished)
 	{
-		return MyGameState->GetWinningTeam() == EStrategyTeam::Player ? NSLOCTEXT("GameFlow", "GameWon", "VICTORY") : NSLOCTEXT("GameFlow", "GameLost", "DEFEAT");
+		GameResultText->SetFont(FCoreStyle::Get().GetFontStyle(TEXT("NormalFont")));
 	}
-	return FText::GetEmpty();
 }
 
-const FSlateBrush* SStrategySlateHUDWidget::GetGameResultImage() const
+void SStrategySlateHUDWidget::OnSpawnQueueChanged()
 {
-	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	bool const bVictory = (MyGameState && MyGameState->GetWinningTeam() == EStrategyTeam::Player);
-	return bVictory ?  &HUDStyle->VictoryImage : &HUDStyle->DefeatImage;
+	ActionButtonsWidget->InvalidateQueueTexts();
 }
 
-EVisibility SStrategySlateHUDWidget::GetResourcesVisibility() const
+void SStrategySlateHUDWidget::UpdateResourcesText()
 {
-	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	return MyGameState && MyGameState->IsGameActive() ? EVisibility::Visible : EVisibility::Collapsed;
+	const AStrategyPlayerController* const PC = Cast<AStrategyPlayerController>(OwnerHUD->PlayerOwner);
+	AStrategyGameState* const MyGameState = BoundGameState.Get();
+	FPlayerData* const PlayerData = (MyGameState && PC) ? MyGameState->GetPlayerData(PC->GetTeamNum()) : NULL;
+	INC_DWORD_STAT(STAT_StrategyHUDTextBuilds);
+	ResourcesText->SetText(PlayerData ? FText::AsNumber(PlayerData->ResourcesAvailable) : FText::GetEmpty());
 }
 
-EVisibility SStrategySlateHUDWidget::GetResultScreenVisibility() const
+void SStrategySlateHUDWidget::UpdateGameTimeText()
 {
-	EVisibility ResultVisibility = EVisibility::Collapsed;
-	AStrategyGameState const* const MyGameState = OwnerHUD->GetWorld()->GetGameState<AStrategyGameState>();
-	if ( MyGameState && (MyGameState->GameplayState == EGameplayState::Finished) )
+	AStrategyGameState const* const MyGameState = BoundGameState.Get();
+	const int32 DisplaySecondsRemaining = (MyGameState && MyGameState->GameplayState == EGameplayState::Waiting) ? FMath::CeilToInt(MyGameState->GetRemainingWaitTime()) : 0;
+	if (DisplaySecondsRemaining != DisplayedWaitSeconds)
+	{
+		DisplayedWaitSeconds = DisplaySecondsRemaining;
+		INC_DWORD_STAT(STAT_StrategyHUDTextBuilds);
+		GameTimeText->SetText(DisplaySecondsRemaining > 0
+			? FText::Format(NSLOCTEXT("GameFlow", "GameStartsIn", "Game starts in {0}"), FText::AsNumber(DisplaySecondsRemaining))
+			: FText::GetEmpty());
+	}
+}
+
+void SStrategySlateHUDWidget::UpdateGameResultFont()
+{
+	AStrategyGameState const* const MyGameState = BoundGameState.Get();
+	const float GameFinishedTime = MyGameState ? MyGameState->GetGameFinishedTime() : 0.0f;
+	if (GameFinishedTime <= 0 || MyGameState->GameplayState != EGameplayState::Finished)
 	{
-		ResultVisibility = EVisibility::Visible;
+		return;
 	}
 
-	return ResultVisibility;
+	const float AnimTime = 1.0f;
+	const int32 StartFontSize = 8;
+	const int32 AnimatedFontSize = 70;
+	const float AnimPercentage = FMath::Min(1.0f, (OwnerHUD->GetWorld()->GetRealTimeSeconds() - GameFinishedTime) / AnimTime);
+	const int32 FontSize = FMath::TruncToInt(StartFontSize + AnimatedFontSize * AnimPercentage);
+	if (FontSize != DisplayedResultFontSize)
+	{
+		DisplayedResultFontSize = FontSize;
+		GameResultText->SetFont(FSlateFontInfo(FPaths::ProjectContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), FontSize));
+	}
 }
 
 EVisibility SStrategySlateHUDWidget::GetPauseMenuBgVisibility() const
 {
+	INC_DWORD_STAT(STAT_StrategyHUDAttributeEvaluations);
 	return bIsPauseMenuActive ? EVisibility::Visible : EVisibility::Collapsed;
 }
 
-FVector2D SStrategySlateHUDWidget::GetActionsWidgetPos() const
+void SStrategySlateHUDWidget::SetActionsWidgetPos(const FVector2D& InPosition)
 {
-	return ActionWidgetPosition.Get();
+	if (ActionsSlot != nullptr && InPosition != ActionsWidgetPos)
+	{
+		ActionsWidgetPos = InPosition;
+		ActionsSlot->Position(ActionsWidgetPos);
+	}
 }
 
 FReply SStrategySlateHUDWidget::TogglePauseMenu()
@@ -10,6 +10,8 @@
 
 class SStrategyButtonWidget;
 class AStrategyHUD;
+class AStrategyGameState;
+class AStrategyBuilding_Brewery;
 
 //HUD widget base class
 class SStrategySlateHUDWidget : public SCompoundWidget
@@ -44,15 +46,15 @@ public:
 	/** callback function for toggling pause menu */
 	FReply TogglePauseMenu();
 
+	/** sets screen position of action grid widget */
+	void SetActionsWidgetPos(const FVector2D& InPosition);
+
 	/** action buttons widget */
 	TSharedPtr<SStrategyActionGrid> ActionButtonsWidget;
 
 	/** minimap widget */
 	TSharedPtr<SStrategyMiniMapWidget> MiniMapWidget;
 
-	/** screen position of action grid widget */
-	TAttribute<FVector2D> ActionWidgetPosition;
-
 	/** Button that toggles pause menu */
 	TSharedPtr<SStrategyButtonWidget> PauseButton;
 
@@ -68,9 +70,6 @@ protected:
 	/** gets current scale for drawing menu */
 	float GetUIScale() const;
 
-	/** returns screen position of action grid widget */
-	FVector2D GetActionsWidgetPos() const;
-
 	/** callback function for pause menu exit button */
 	FReply OnExitGame();
 
@@ -89,29 +88,29 @@ protected:
 	/** should we display pause menu? */
 	EVisibility GetPauseMenuBgVisibility() const;
 
-	/** should we display resource amount? */
-	EVisibility GetResourcesVisibility() const;
+	/** binds to events of game state and player's brewery when they change, and refreshes everything shown from them */
+	void BindGameEvents();
 
-	/** should we display game results? */
-	EVisibility GetResultScreenVisibility() const;
+	/** updates resources amount when player's resources changed */
+	void OnResourcesChanged(uint8 TeamNum);
 
-	/** returns resources amount to display */
-	FText GetResourcesAmount() const;
+	/** updates resources and result screen when game state changed */
+	void OnGameplayStateChanged(EGameplayState::Type NewState);
 
-	/** returns game timer information to display */
-	FText GetGameTime() const;
+	/** updates queue length of action buttons when player's spawn queue changed */
+	void OnSpawnQueueChanged();
 
-	/** returns game result font (used for animation) */
-	FSlateFontInfo GetGameResultFont() const;
+	/** updates resources amount to display */
+	void UpdateResourcesText();
 
-	/** returns game result string to display */
-	FText GetGameResultText() const;
+	/** updates game timer information to display, text is only rebuilt when displayed seconds change */
+	void UpdateGameTimeText();
 
-	/** returns game result text font color */
-	FSlateColor GetGameResultColor() const;
+	/** updates game result font (used for animation), font is only rebuilt when its size changes */
+	void UpdateGameResultFont();
 
-	/** displays win/lose logo */
-	const FSlateBrush* GetGameResultImage() const;
+	/** pushes screen areas of minimap, action buttons and pause menu to the HUD, to be excluded from camera scrolling */
+	void UpdateExclusionZones(const FGeometry& AllottedGeometry) const;
 
 	/** gets mini map width */
 	FOptionalSize GetMiniMapWidth() const;
@@ -140,6 +139,35 @@ protected:
 	/** style for this HUD */
 	const struct FStrategyHUDStyle* HUDStyle;
 
+	/** widgets updated on game events, instead of evaluating bound attributes every frame */
+	TSharedPtr<SWidget> ResourcesBox;
+	TSharedPtr<STextBlock> ResourcesText;
+	TSharedPtr<STextBlock> GameTimeText;
+	TSharedPtr<STextBlock> GameResultText;
+	TSharedPtr<SImage> GameResultImage;
+
+	/** frame around minimap widget */
+	TSharedPtr<SWidget> MiniMapFrame;
+
+	/** box holding pause menu buttons */
+	TSharedPtr<SVerticalBox> PauseMenuBox;
+
+	/** canvas slot of action grid widget */
+	SCanvas::FSlot* ActionsSlot;
+
+	/** current screen position of action grid widget */
+	FVector2D ActionsWidgetPos;
+
+	/** game state and brewery events are bound to */
+	TWeakObjectPtr<AStrategyGameState> BoundGameState;
+	TWeakObjectPtr<AStrategyBuilding_Brewery> BoundBrewery;
+
+	/** seconds until game starts, as displayed */
+	int32 DisplayedWaitSeconds;
+
+	/** size of game result font, as displayed */
+	int32 DisplayedResultFontSize;
+
 private:
 	/** Handles to various registered timers */
 	FTimerHandle ExitGameTimerHandle;
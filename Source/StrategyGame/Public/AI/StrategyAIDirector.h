@@ -14,6 +14,9 @@ class UStrategyAIDirector : public UActorComponent
 {
 	GENERATED_UCLASS_BODY()
 
+	/** snapshots save and restore protected state */
+	friend struct FStrategySnapshot;
+
 	/** set default armor for spawns */
 	UFUNCTION(BlueprintCallable, Category=Pawn, meta=(DeprecatedFunction, DeprecationMessage="Use SetDefaultArmorClass"))
 	void SetDefaultArmor(UBlueprint* InArmor);
@@ -59,10 +62,6 @@ public:
 	/** Override to return correct team number */
 	virtual void SetTeamNum(uint8 inTeamNum);
 
-	// Begin UActorComponent Interface
-	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction);
-	// End UActorComponent Interface
-
 	/** Getter for brewery of enemy side */
 	AStrategyBuilding_Brewery* GetEnemyBrewery() const;
 
@@ -71,9 +70,10 @@ public:
 
 	/** request spawn from AI Director */
 	void RequestSpawn();
-protected:
-	/** check conditions and spawn minions if possible */
+
+	/** check conditions and spawn minions if possible, called by game state once per simulation step while active */
 	void SpawnMinions();
+protected:
 
 	/** Custom scale for spawns */
 	float CustomScale;
@@ -81,9 +81,12 @@ protected:
 	/** Custom animation rate for spawns */
 	float AnimationRate;
 
-	/** next time to spawn minion */
+	/** next time to spawn minion, in gameplay time */
 	float NextSpawnTime;
 
+	/** last spot used to spawn minion */
+	int32 SpawnOffsetIndex;
+
 	/** team number */
 	uint8 MyTeamNum;
 
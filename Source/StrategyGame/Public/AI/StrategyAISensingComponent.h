@@ -36,6 +36,9 @@ class UStrategyAISensingComponent : public UPawnSensingComponent
 	virtual void InitializeComponent() override;
 	// End UActorComponent interface.
 
+	/** get sight distance from config */
+	float GetSightDistance() const { return SightDistance; }
+
 protected:
 	UPROPERTY(config)
 	float SightDistance;
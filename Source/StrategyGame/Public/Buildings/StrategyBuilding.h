@@ -19,6 +19,9 @@ class AStrategyBuilding : public AActor,
 {
 	GENERATED_UCLASS_BODY()
 
+	/** snapshots save and restore protected state */
+	friend struct FStrategySnapshot;
+
 	/** team */
 	UPROPERTY(EditInstanceOnly, Category=Building)
 	TEnumAsByte<EStrategyTeam::Type> SpawnTeamNum;
@@ -28,8 +31,8 @@ class AStrategyBuilding : public AActor,
 
 	// Begin Actor interface
 	virtual void PostInitializeComponents() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Destroyed() override;
-	virtual void Tick(float DeltaTime) override;
 	virtual void PostLoad() override;
 	// End Actor Interface
 
@@ -93,6 +96,9 @@ class AStrategyBuilding : public AActor,
 	/** replace building with other class, returns new building in second parameter. return true if this building should never be built again  */
 	virtual bool ReplaceBuilding(TSubclassOf<AStrategyBuilding> NewBuildingClass, AStrategyBuilding** OutNewBuilding);
 
+	/** upgrade picked by player from action menu, replaces building and records it in replay */
+	bool RequestUpgrade(TSubclassOf<AStrategyBuilding> NewBuildingClass);
+
 	/** Switch building into build state */
 	bool StartBuild();
 
@@ -100,7 +106,14 @@ class AStrategyBuilding : public AActor,
 	void FinishBuild();
 
 	/** Returns true if building process is finished, false otherwise. */
-	bool IsBuildFinished();
+	bool IsBuildFinished() const;
+
+	/**
+	 * Get remaining construction time in seconds.
+	 *
+	 * @param	bInterpolated	Use time between simulation steps, for rendering only.
+	 */
+	float GetRemainingBuildTime(bool bInterpolated = false) const;
 
 	//////////////////////////////////////////////////////////////////////////
 	// Reading data
@@ -109,6 +122,9 @@ class AStrategyBuilding : public AActor,
 	UFUNCTION(BlueprintCallable, Category=Health)
 	int32 GetHealth() const;
 
+	/** get health for display, construction progress is interpolated between simulation steps */
+	int32 GetDisplayHealth() const;
+
 	/** get max health */
 	UFUNCTION(BlueprintCallable, Category=Health)
 	int32 GetMaxHealth() const;
@@ -176,6 +192,10 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category=Touch)
 	uint8 bAffectEnemyMinion : 1;
 
+	/** generate overlap events from trigger box? disable for buildings using StrategyTowerTargetingComponent */
+	UPROPERTY(EditDefaultsOnly, Category=Touch)
+	uint8 bUseTouchEvents : 1;
+
 	/** if construction is finished, any build actions are repairs (cheaper) */
 	UPROPERTY(EditInstanceOnly, Category=Building)
 	uint8 bIsContructionFinished : 1;
@@ -199,12 +219,18 @@ protected:
 	/** Built time if building is not attacked in the meantime */
 	float InitialBuildTime;
 
-	/** remaining build time */
-	float RemainingBuildTime;
+	/** world time when construction finishes */
+	float BuildFinishTime;
+
+	/** Index of our class in FStrategyClassStatTable */
+	mutable int32 ClassStatsIndex;
 
 	/** get data for current team */
 	struct FPlayerData* GetTeamData() const;
 
+	/** tell game state that this building was added, removed or changed construction state */
+	void NotifyBuildingChanged() const;
+
 	//////////////////////////////////////////////////////////////////////////
 	// UI
 
@@ -102,6 +102,12 @@ public:
 	/** gets spawn queue length string */
 	FText GetSpawnQueueLength() const;
 
+	/** notify that number of queued spawns changed */
+	void NotifySpawnQueueChanged() const;
+
+	/** broadcast when number of queued spawns changes, UI refreshes queue text from it */
+	FSimpleMulticastDelegate OnSpawnQueueChanged;
+
 	/** notify about new game state */
 	void OnGameplayStateChange(EGameplayState::Type NewState);
 
@@ -0,0 +1,61 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AStrategyBuilding;
+
+/**
+ * Keeps every building under construction in a min-heap ordered by finish time,
+ * so no building has to tick while it is being built.
+ */
+struct FStrategyConstructionScheduler
+{
+	/**
+	 * Add building to the schedule.
+	 *
+	 * @param	InBuilding	The building that started construction.
+	 * @param	FinishTime	Gameplay time in seconds at which construction is done.
+	 */
+	void AddBuilding(AStrategyBuilding* InBuilding, float FinishTime);
+
+	/**
+	 * Finish all builds that are due.
+	 *
+	 * @param	CurrentTime	Current gameplay time in seconds.
+	 */
+	void FinishExpiredBuilds(float CurrentTime);
+
+	/** @returns true if there are no builds in progress */
+	bool IsEmpty() const;
+
+	/** @returns gameplay time of the earliest pending finish, only valid if not empty */
+	float GetNextFinishTime() const;
+
+	/** @returns number of pending builds, in no particular order */
+	int32 Num() const;
+
+	/** @returns building of pending build, null if it's gone */
+	AStrategyBuilding* GetBuilding(int32 Index) const;
+
+	/** drop all pending builds */
+	void Reset();
+
+private:
+	/** single scheduled build */
+	struct FEntry
+	{
+		/** gameplay time when construction is finished */
+		float FinishTime;
+
+		/** building under construction, may be gone by the time it's due */
+		TWeakObjectPtr<AStrategyBuilding> Building;
+
+		bool operator<(const FEntry& Other) const
+		{
+			return FinishTime < Other.FinishTime;
+		}
+	};
+
+	/** heap of pending builds, earliest finish on top */
+	TArray<FEntry> Heap;
+};
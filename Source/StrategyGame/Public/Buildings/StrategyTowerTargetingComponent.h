@@ -0,0 +1,118 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "StrategyTypes.h"
+#include "StrategyUnitSpatialIndex.h"
+#include "StrategySimulationTimers.h"
+#include "StrategyTowerTargetingComponent.generated.h"
+
+class AStrategyChar;
+class AStrategyProjectile;
+
+UENUM(BlueprintType)
+namespace ETowerTargetPolicy
+{
+	enum Type
+	{
+		/** enemy closest to the brewery we are defending */
+		First,
+		/** enemy closest to the tower */
+		Nearest,
+		/** enemy with the least health left */
+		LowestHealth,
+		/** enemy with the highest max health */
+		Strongest,
+	};
+}
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTowerFiredDelegate, AStrategyProjectile*, Projectile, AStrategyChar*, Target);
+
+/** Picks targets for a tower from the unit spatial index and fires projectiles at them. */
+UCLASS(ClassGroup=Strategy, meta=(BlueprintSpawnableComponent))
+class UStrategyTowerTargetingComponent : public UActorComponent
+{
+	GENERATED_UCLASS_BODY()
+
+	/** how to choose between enemies in range */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Targeting)
+	TEnumAsByte<ETowerTargetPolicy::Type> TargetPolicy;
+
+	/** targeting range, measured on the ground plane */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Targeting)
+	float Range;
+
+	/** seconds between target queries */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Targeting)
+	float TargetingInterval;
+
+	/** fire automatically at current target */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Projectile)
+	bool bAutoFire;
+
+	/** seconds between shots */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Projectile)
+	float FireInterval;
+
+	/** projectile to spawn */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Projectile)
+	TSubclassOf<AStrategyProjectile> ProjectileClass;
+
+	/** damage passed to projectile */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Projectile)
+	int32 ProjectileDamage;
+
+	/** projectile life span */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Projectile)
+	float ProjectileLifeSpan;
+
+	/** spawn offset of projectile, relative to owner */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category=Projectile)
+	FVector MuzzleOffset;
+
+	/** called after projectile was fired */
+	UPROPERTY(BlueprintAssignable)
+	FTowerFiredDelegate OnProjectileFired;
+
+	// Begin UActorComponent Interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End UActorComponent Interface
+
+	/** query spatial index and pick new target */
+	UFUNCTION(BlueprintCallable, Category=Targeting)
+	void UpdateTarget();
+
+	/** get current target, can be null */
+	UFUNCTION(BlueprintCallable, Category=Targeting)
+	AStrategyChar* GetCurrentTarget() const;
+
+	/** fire projectile at current target, returns spawned projectile or null */
+	UFUNCTION(BlueprintCallable, Category=Projectile)
+	AStrategyProjectile* RequestFire();
+
+protected:
+	/** check if char can still be targeted */
+	bool IsValidTarget(const AStrategyChar* InChar) const;
+
+	/** check if owner is allowed to shoot (e.g. construction is finished) */
+	bool CanOwnerFire() const;
+
+	/** score target according to policy, lower is better */
+	float ScoreTarget(const AStrategyChar* InChar, const FVector& TowerLocation, const FVector& GoalLocation) const;
+
+	/** auto fire timer */
+	void OnAutoFire();
+
+	/** currently selected target */
+	TWeakObjectPtr<AStrategyChar> CurrentTarget;
+
+	/** scratch array for spatial queries */
+	FStrategyUnitSpatialIndex::FCharArray Candidates;
+
+	/** Handle of UpdateTarget simulation timer */
+	FStrategySimulationTimerHandle TimerHandle_UpdateTarget;
+
+	/** Handle of OnAutoFire simulation timer */
+	FStrategySimulationTimerHandle TimerHandle_AutoFire;
+};
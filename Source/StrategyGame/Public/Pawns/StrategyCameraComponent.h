@@ -44,13 +44,6 @@ public:
 	 */
 	void MoveRight( float Val );
 
-	/*
-	 * Exclude an area from the mouse scroll movement update. (This will be reset at the end of each update).
-	 *
-	 * @param	InCoords
-	 */
-	void AddNoScrollZone( FBox InCoords );
-
 	/*
 	 * CLamp the Camera location.
 	 *
@@ -156,7 +149,7 @@ public:
 	 * @param	SwipePosition		Position to check
 	 * @returns	true if given coordinates are withing a no-scroll zone
 	 */
-	bool AreCoordsInNoScrollZone(const FVector2D& SwipePosition);
+	bool AreCoordsInNoScrollZone(const FVector2D& SwipePosition) const;
 
 	/* Reset the swipe/drag */
 	void EndSwipeNow();
@@ -171,8 +164,11 @@ private:
 	/* Update the movement bounds of this component. */
 	void UpdateCameraBounds( const APlayerController* InPlayerController );
 
-	/* List of zones to exclude from scrolling during the camera movement update. */
-	TArray<FBox>	NoScrollZones;
+	/** Return UI areas to exclude from scrolling, kept by the HUD. */
+	const struct FStrategyExclusionZones* GetExclusionZones() const;
+
+	/** Max speed of the spectator movement before edge scrolling changed it, negative until read. */
+	float DefaultSpectatorSpeed;
 
 	/** Initial Zoom alpha when starting pinch. */
 	float InitialPinchAlpha;
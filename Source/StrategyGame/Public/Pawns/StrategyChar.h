@@ -4,10 +4,12 @@
 
 #include "StrategyTypes.h"
 #include "StrategyTeamInterface.h"
+#include "StrategySimulationTimers.h"
 #include "StrategyChar.generated.h"
 
 
 class UStrategyAttachment;
+class AStrategyGameState;
 
 // Base class for the minions
 UCLASS(Abstract)
@@ -15,6 +17,12 @@ class AStrategyChar : public ACharacter, public IStrategyTeamInterface
 {
 	GENERATED_UCLASS_BODY()
 
+	/** snapshots save and restore protected state */
+	friend struct FStrategySnapshot;
+
+	/** unit registry keeps our published index */
+	friend struct FStrategyUnitRegistry;
+
 	/** How many resources this pawn is worth when it dies. */
 	UPROPERTY(EditAnywhere, Category=Pawn)
 	int32 ResourcesToGather;
@@ -46,6 +54,12 @@ public:
 	/** initial setup */
 	virtual void PostInitializeComponents() override;
 
+	/** start health regen */
+	virtual void BeginPlay() override;
+
+	/** stop health regen, unregister team */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** prevent units from basing on each other or buildings */
 	virtual bool CanBeBaseForCharacter(APawn* Pawn) const override;
 
@@ -91,6 +105,18 @@ public:
 	/** set team number */
 	void SetTeamNum(uint8 NewTeamNum);
 
+	/**
+	 * Apply damage that was already modified by game rules, see FStrategyDamageQueue.
+	 * Fires the usual damage events.
+	 *
+	 * @param	Damage			Final damage.
+	 * @param	DamageEvent		Data package that fully describes the damage received.
+	 * @param	EventInstigator	The Controller responsible for the damage.
+	 * @param	DamageCauser	The Actor that directly caused the damage.
+	 * @returns damage taken.
+	 */
+	float ApplyResolvedDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser);
+
 	/** adds active buff to this pawn */
 	void ApplyBuff(const struct FBuffData& Buff);
 
@@ -101,6 +127,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Health)
 	int32 GetHealth() const;
 
+	/** @returns index of our entry in unit registry's published arrays, INDEX_NONE if not published */
+	int32 GetUnitRegistryIndex() const { return UnitRegistryIndex; }
+
 	/** get max health */
 	UFUNCTION(BlueprintCallable, Category=Health)
 	int32 GetMaxHealth() const;
@@ -135,24 +164,53 @@ protected:
 	/** pawn data with added buff effects */
 	FPawnData ModifiedPawnData;
 
-	/** List of active buffs */
+	/** Heap of active time limited buffs, earliest expiring on top */
 	TArray<struct FBuffData> ActiveBuffs;
 
-	/** update pawn data after changes in active buffs */
+	/** Sum of all active buffs, infinite ones included */
+	FPawnData BuffDelta;
+
+	/** update pawn data after changes in active buffs or attachments */
 	void UpdatePawnData();
 
-	/** update pawn's health */
+	/** remove expired buffs and update pawn data */
+	void OnBuffsExpired();
+
+	/** arm simulation timer for the next buff to expire */
+	void ScheduleBuffExpiry();
+
+	/** pass current health regen to game state's regen system */
 	void UpdateHealth();
 
+	/**
+	 * Find closest enemy unit the melee box sweep would hit, using unit spatial index.
+	 *
+	 * @param	GameState		Game state owning the index.
+	 * @param	TraceStart		Start of the sweep.
+	 * @param	TraceDir		Direction of the sweep.
+	 * @param	TraceDistance	Length of the sweep.
+	 * @param	BoxExtent		Half size of the swept box.
+	 * @param	OutHitDistance	How far the box travels before touching the unit, if one was found.
+	 * @returns enemy unit or null.
+	 */
+	AStrategyChar* FindMeleeTarget(const AStrategyGameState* GameState, const FVector& TraceStart, const FVector& TraceDir, float TraceDistance, float BoxExtent, float& OutHitDistance) const;
+
+	/** deal melee damage to hit actor */
+	void ApplyMeleeDamage(AStrategyGameState* GameState, int32 MeleeDamage, const FVector& TraceDir, const FHitResult& Hit);
+
 	/** event called after die animation  to hide character and delete it asap */
 	void OnDieAnimationEnd();
 
 private:
 
-	/** Handle for efficient management of UpdatePawnData timer */
-	FTimerHandle TimerHandle_UpdatePawnData;
+	/** Index of our class in FStrategyClassStatTable */
+	mutable int32 ClassStatsIndex;
+
+	/** Index of our entry in FStrategyUnitRegistry published arrays */
+	int32 UnitRegistryIndex;
+
+	/** Handle of OnBuffsExpired simulation timer */
+	FStrategySimulationTimerHandle TimerHandle_BuffExpiry;
 
-	/** Handle for efficient management of UpdateHealth timer */
-	FTimerHandle TimerHandle_UpdateHealth;
 };
 
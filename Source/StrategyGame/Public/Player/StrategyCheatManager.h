@@ -16,4 +16,44 @@ class UStrategyCheatManager : public UCheatManager
 	 */
 	UFUNCTION(exec)
 	void AddGold(uint32 NewGold);
+
+	/**
+	 * Compare reading base health through class default object against FStrategyClassStatTable.
+	 *
+	 * @param Iterations	Number of lookups per method.
+	 */
+	UFUNCTION(exec)
+	void BenchmarkClassStats(int32 Iterations = 1000000);
+
+	/**
+	 * Compare enemy team checks through IStrategyTeamInterface casts against FStrategyTeamTable.
+	 *
+	 * @param Iterations	Number of checks per method.
+	 */
+	UFUNCTION(exec)
+	void BenchmarkTeamLookup(int32 Iterations = 1000000);
+
+	/**
+	 * Save state of the match to Saved/Snapshots.
+	 *
+	 * @param Name	Snapshot name, without extension.
+	 */
+	UFUNCTION(exec)
+	void SaveSnapshot(const FString& Name = TEXT("Default"));
+
+	/**
+	 * Restore state of the match saved with SaveSnapshot, on the same map.
+	 *
+	 * @param Name	Snapshot name, without extension.
+	 */
+	UFUNCTION(exec)
+	void LoadSnapshot(const FString& Name = TEXT("Default"));
+
+	/** Report time from touch arrival until gesture actions were handled, since last call. */
+	UFUNCTION(exec)
+	void InputLatency();
+
+protected:
+	/** dropped input events already reported */
+	int32 ReportedInputDrops;
 };
@@ -71,6 +71,91 @@ struct FSimpleKeyState
 	}
 };
 
+/** game key gesture detected in a single frame */
+struct FStrategyInputEvent
+{
+	/** detected key, EGameKey */
+	uint8 Key;
+
+	/** detected event, EInputEvent */
+	uint8 Event;
+
+	/** number of times event was detected this frame */
+	uint8 Count;
+
+	/** positions associated with event */
+	FVector2D Position;
+	FVector2D Position2;
+
+	/** accumulated down time */
+	float DownTime;
+
+	/** FPlatformTime::Seconds when the latest touch driving this event reached the controller */
+	double InputTime;
+
+	/** FPlatformTime::Seconds when the event was detected */
+	double DetectTime;
+
+	/** FPlatformTime::Seconds when bound actions finished handling the event */
+	double HandledTime;
+};
+
+/** input to action latency of dispatched gestures */
+struct FStrategyInputLatency
+{
+	/** number of gestures driven by a touch */
+	int32 NumEvents;
+
+	/** summed latency, in seconds */
+	double TotalLatency;
+
+	/** worst latency, in seconds */
+	double MaxLatency;
+
+	FStrategyInputLatency()
+	{
+		FMemory::Memzero(this, sizeof(FStrategyInputLatency));
+	}
+};
+
+/**
+ * Fixed size queue of detected gestures, filled by detection and drained by dispatch.
+ * Lock free for a single producer (game thread detection) and a single consumer,
+ * events are dropped and counted when the consumer falls behind.
+ */
+struct FStrategyInputEventQueue
+{
+	/** number of events kept, power of two */
+	static const uint32 Capacity = 256;
+
+	FStrategyInputEventQueue();
+
+	/** @returns false if queue is full and event was dropped */
+	bool Push(const FStrategyInputEvent& Event);
+
+	/** @returns false if queue is empty */
+	bool Pop(FStrategyInputEvent& OutEvent);
+
+	/** @returns number of events waiting */
+	int32 Num() const;
+
+	/** @returns number of events dropped because queue was full */
+	int32 GetNumDropped() const { return NumDropped.Load(); }
+
+private:
+	/** ring buffer storage */
+	FStrategyInputEvent Events[Capacity];
+
+	/** total events pushed, written by producer only */
+	TAtomic<uint32> Head;
+
+	/** total events popped, written by consumer only */
+	TAtomic<uint32> Tail;
+
+	/** number of dropped events */
+	TAtomic<int32> NumDropped;
+};
+
 UCLASS()
 class UStrategyInput : public UObject
 {
@@ -88,10 +173,31 @@ public:
 	/** get touch anchor position */
 	FVector2D GetTouchAnchor(int32 i) const;
 
+	/** stamp arrival time of touch, called when controller receives it */
+	void NotifyTouchInput(uint32 Handle);
+
+	/** get latency of gestures dispatched since last reset */
+	const FStrategyInputLatency& GetLatency() const { return Latency; }
+
+	/** clear gathered latency */
+	void ResetLatency() { Latency = FStrategyInputLatency(); }
+
+	/** get number of gestures dropped because queue was full */
+	int32 GetNumDroppedEvents() const { return Events.GetNumDropped(); }
+
 protected:
 
-	/** game key states */
-	TMap<EGameKey::Type, FSimpleKeyState> KeyStateMap;
+	/** game key states, indexed by EGameKey */
+	FSimpleKeyState KeyStates[EGameKey::MAX];
+
+	/** detected gestures, filled by detection and drained by dispatch */
+	FStrategyInputEventQueue Events;
+
+	/** latency of dispatched gestures */
+	FStrategyInputLatency Latency;
+
+	/** FPlatformTime::Seconds of the latest input of first two touches */
+	double TouchInputTimes[2];
 
 	/** touch anchors */
 	FVector2D TouchAnchors[2];
@@ -3,10 +3,12 @@
 #pragma once
 
 #include "StrategyTeamInterface.h"
+#include "StrategyViewProjection.h"
 #include "StrategyPlayerController.generated.h"
 
 class AStrategySpectatorPawn;
 class UStrategyCameraComponent;
+class UStrategyInput;
 
 UCLASS()
 class AStrategyPlayerController : public APlayerController, public IStrategyTeamInterface
@@ -18,6 +20,9 @@ public:
 	/** fixed rotation */
 	virtual void UpdateRotation(float DeltaTime) override;
 
+	/** stamp touch arrival time for input detection */
+	virtual bool InputTouch(uint32 Handle, ETouchType::Type Type, const FVector2D& TouchLocation, float Force, FDateTime DeviceTimestamp, uint32 TouchpadIndex) override;
+
 protected:
 	/** update input detection */
 	virtual void ProcessPlayerInput(const float DeltaTime, const bool bGamePaused) override;
@@ -36,6 +41,12 @@ public:
 	/** helper function to toggle input detection. */
 	void SetIgnoreInput(bool bIgnore);
 
+	/** get custom input handler. */
+	UStrategyInput* GetInputHandler() const { return InputHandler; }
+
+	/** get deprojection of current view, rebuilt only when camera or viewport changed. */
+	const FStrategyViewProjection& GetViewProjection() const;
+
 	/** Input handlers. */
 	void OnTapPressed(const FVector2D& ScreenPosition, float DownTime);
 	void OnHoldPressed(const FVector2D& ScreenPosition, float DownTime);
@@ -79,6 +90,9 @@ protected:
 	UPROPERTY()
 	class UStrategyInput* InputHandler;
 
+	/** Deprojection of current view, shared by all screen to world queries. */
+	mutable FStrategyViewProjection ViewProjection;
+
 	/**
 	 * Change current selection (on toggle on the same).
 	 *
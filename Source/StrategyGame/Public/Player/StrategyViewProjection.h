@@ -0,0 +1,73 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Inverse view projection of a local player's view, for turning screen points into world rays.
+ * Projection data is only fetched and inverted again when camera or viewport changed,
+ * so any number of deprojections in a frame share a single matrix inverse.
+ */
+struct FStrategyViewProjection
+{
+	FStrategyViewProjection();
+
+	/**
+	 * Refresh from current view of player.
+	 *
+	 * @param	PlayerController	Local player controller whose view is used.
+	 * @returns false if player has no view to deproject from.
+	 */
+	bool Update(const APlayerController* PlayerController);
+
+	/** @returns true if last update found a view */
+	bool IsValid() const { return bValid; }
+
+	/** @returns number of times matrices were rebuilt, for detecting view changes */
+	uint32 GetRevision() const { return Revision; }
+
+	/**
+	 * Convert point in screen space to ray in world space.
+	 *
+	 * @param	ScreenPosition	Point in viewport pixels.
+	 * @param	RayOrigin		Receives ray origin.
+	 * @param	RayDirection	Receives normalized ray direction.
+	 * @returns false if view isn't valid.
+	 */
+	bool Deproject(const FVector2D& ScreenPosition, FVector& RayOrigin, FVector& RayDirection) const;
+
+	/**
+	 * Intersect rays through points in screen space with a plane.
+	 *
+	 * @param	ScreenPositions	Points in viewport pixels.
+	 * @param	NumPositions	Number of points.
+	 * @param	Plane			Plane to intersect with, usually the ground.
+	 * @param	OutPoints		Receives NumPositions world points.
+	 * @returns false if view isn't valid, OutPoints are not written then.
+	 */
+	bool DeprojectToPlane(const FVector2D* ScreenPositions, int32 NumPositions, const FPlane& Plane, FVector* OutPoints) const;
+
+	/** single point version of DeprojectToPlane */
+	bool DeprojectToPlane(const FVector2D& ScreenPosition, const FPlane& Plane, FVector& OutPoint) const
+	{
+		return DeprojectToPlane(&ScreenPosition, 1, Plane, &OutPoint);
+	}
+
+private:
+	/** inverse of view * projection */
+	FMatrix InvViewProjectionMatrix;
+
+	/** view rect matching the matrix */
+	FIntRect ViewRect;
+
+	/** camera and viewport the matrix was built for */
+	FVector CameraLocation;
+	FRotator CameraRotation;
+	float CameraFOV;
+	FIntPoint ViewportSize;
+
+	/** number of rebuilds */
+	uint32 Revision;
+
+	/** set if last update found a view */
+	bool bValid;
+};
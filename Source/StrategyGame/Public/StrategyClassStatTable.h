@@ -0,0 +1,93 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/** Base values of a class, read once from its default object. */
+struct FStrategyClassStats
+{
+	/** default health */
+	float Health;
+
+	/** default max walk speed, chars only */
+	float WalkSpeed;
+
+	/** default resources, resource nodes only */
+	int32 Resources;
+
+	/** unscaled capsule radius, chars only */
+	float CapsuleRadius;
+
+	/** unscaled capsule half height, chars only */
+	float CapsuleHalfHeight;
+
+	FStrategyClassStats()
+		: Health(0.0f)
+		, WalkSpeed(0.0f)
+		, Resources(0)
+		, CapsuleRadius(0.0f)
+		, CapsuleHalfHeight(0.0f)
+	{
+	}
+};
+
+/**
+ * Table of class default values, filled when a class is first seen.
+ * Actors keep the index of their class, so hot paths don't have to go through GetDefaultObject.
+ * Values are read again in place when default objects are replaced (blueprint recompile) and after world cleanup
+ * (end of PIE session, travel), so indices held by actors stay valid.
+ */
+class FStrategyClassStatTable
+{
+public:
+	/** hook refresh delegates, call once when game module starts */
+	static void Initialize();
+
+	/** unhook refresh delegates */
+	static void Shutdown();
+
+	/** read values of all known classes again */
+	static void RefreshStats();
+
+	/**
+	 * Get index of class in the table, adding it if needed.
+	 *
+	 * @param	InClass		Class of char, building or resource node.
+	 * @returns index to pass to GetStats.
+	 */
+	static int32 GetClassIndex(UClass* InClass);
+
+	/** @returns stats stored under given index */
+	static const FStrategyClassStats& GetStats(int32 ClassIndex);
+
+	/** @returns stats of given class, adding it if needed */
+	static const FStrategyClassStats& GetStats(UClass* InClass);
+
+	/**
+	 * Get stats of object's class, caching the index in the caller.
+	 *
+	 * @param	InObject		Object to get stats for.
+	 * @param	InOutIndex		Cached index, INDEX_NONE if not known yet.
+	 */
+	static const FStrategyClassStats& GetStats(const UObject* InObject, int32& InOutIndex);
+
+private:
+	/** read values from default object of class */
+	static void ReadStats(UClass* InClass, FStrategyClassStats& OutStats);
+
+	/** refresh delegates */
+	static void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+	static void OnPostWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	/** refresh delegate handles */
+	static FDelegateHandle ObjectsReplacedHandle;
+	static FDelegateHandle PostWorldCleanupHandle;
+
+	/** stats by class index */
+	static TArray<FStrategyClassStats> Stats;
+
+	/** classes by class index, to detect reused class pointers */
+	static TArray<TWeakObjectPtr<UClass>> Classes;
+
+	/** class index lookup */
+	static TMap<const UClass*, int32> ClassIndices;
+};
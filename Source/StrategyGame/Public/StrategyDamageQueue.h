@@ -0,0 +1,97 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AStrategyChar;
+class AStrategyGameState;
+
+/**
+ * Collects damage dealt during a frame and resolves it in one pass.
+ * Entries are applied strictly in the order they were queued, so the same sequence of hits
+ * always gives the same deaths and stats.
+ */
+struct FStrategyDamageQueue
+{
+	/**
+	 * Queue damage from a hit.
+	 *
+	 * @param	Victim			Actor to damage.
+	 * @param	Damage			Raw damage, before damage reduction.
+	 * @param	InstigatorTeam	Team of whoever dealt the damage, used for friendly fire check.
+	 * @param	HitDirection	Direction of the hit.
+	 * @param	HitInfo			Hit result passed to point damage event.
+	 * @param	Instigator		Controller responsible for damage, can be null.
+	 * @param	Causer			Actor that caused damage, can be null.
+	 */
+	void QueuePointDamage(AActor* Victim, float Damage, uint8 InstigatorTeam, const FVector& HitDirection, const FHitResult& HitInfo, AController* Instigator, AActor* Causer);
+
+	/**
+	 * Queue damage over time from negative health regen.
+	 * Has no instigator, so it's never dropped as friendly fire, but damage reduction still applies.
+	 *
+	 * @param	Victim			Char to damage.
+	 * @param	Damage			Damage to deal.
+	 */
+	void QueueDamageOverTime(AStrategyChar* Victim, float Damage);
+
+	/**
+	 * Estimate how much health a hit would take, without queuing it.
+	 *
+	 * @param	Victim			Actor to damage.
+	 * @param	Damage			Raw damage, before damage reduction.
+	 * @param	InstigatorTeam	Team of whoever deals the damage.
+	 * @returns damage after friendly fire check and damage reduction, capped at health left after damage already queued.
+	 */
+	float PredictDamage(const AActor* Victim, float Damage, uint8 InstigatorTeam) const;
+
+	/**
+	 * Resolve and apply all queued damage.
+	 *
+	 * @param	GameState	Game state receiving damage stats.
+	 */
+	void Flush(AStrategyGameState* GameState);
+
+	/** @returns number of queued entries */
+	int32 Num() const;
+
+	/** drop all queued damage */
+	void Reset();
+
+private:
+	/** entry flags */
+	enum EFlags
+	{
+		Flag_DamageOverTime = 1 << 0,
+		Flag_Char = 1 << 1,
+	};
+
+	/**
+	 * Resolve damage of a single hit on char.
+	 *
+	 * @returns damage after friendly fire check and damage reduction.
+	 */
+	static float ResolveDamage(float Damage, uint8 InstigatorTeam, uint8 VictimTeam, float DamageReduction);
+
+	/** add resolved damage of a queued hit to victim's pending damage */
+	void AddPending(const AStrategyChar* Victim, float Damage, uint8 InstigatorTeam);
+
+	/** remove first Count entries */
+	void RemoveFirst(int32 Count);
+
+	// queued entries, one index per hit
+
+	TArray<TWeakObjectPtr<AActor>> Victims;
+	TArray<float> Damages;
+	TArray<uint8> InstigatorTeams;
+	TArray<uint8> Flags;
+	TArray<FVector> HitDirections;
+	TArray<FHitResult> HitInfos;
+	TArray<TWeakObjectPtr<AController>> Instigators;
+	TArray<TWeakObjectPtr<AActor>> Causers;
+
+	/** damage after resolve pass, scratch */
+	TArray<float> ResolvedDamages;
+
+	/** resolved damage queued for each char since last flush, so predictions don't overkill */
+	TMap<const AStrategyChar*, float> PendingDamage;
+};
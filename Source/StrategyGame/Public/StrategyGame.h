@@ -17,6 +17,11 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogGame, Log, All);
 
+/** HUD work per frame, see "stat StrategyHUD" */
+DECLARE_STATS_GROUP(TEXT("StrategyHUD"), STATGROUP_StrategyHUD, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Attribute evaluations"), STAT_StrategyHUDAttributeEvaluations, STATGROUP_StrategyHUD, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Text builds"), STAT_StrategyHUDTextBuilds, STATGROUP_StrategyHUD, );
+
 /** when you modify this, please note that this information can be saved with instances
  * also DefaultEngine.ini [/Script/Engine.CollisionProfile] should match with this list **/
 #define COLLISION_WEAPON		ECC_GameTraceChannel1
@@ -30,6 +30,9 @@ class AStrategyGameMode : public AGameModeBase
 	/** Initialize the GameState actor. */
 	virtual void InitGameState() override;
 
+	/** Release assets preloaded by main menu, the match references what it uses by now. */
+	virtual void StartPlay() override;
+
 	/**
 	 * Handle new player, skips pawn spawning.
 	 * @param NewPlayer
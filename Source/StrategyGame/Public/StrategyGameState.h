@@ -4,16 +4,33 @@
 
 #include "StrategyTypes.h"
 #include "StrategyMiniMapCapture.h"
+#include "StrategyConstructionScheduler.h"
+#include "StrategyUnitSpatialIndex.h"
+#include "StrategyVisibilityGrid.h"
+#include "StrategyUnitRegistry.h"
+#include "StrategyHealthRegenSystem.h"
+#include "StrategyDamageQueue.h"
+#include "StrategyMatchSimulation.h"
+#include "StrategySimulationClock.h"
+#include "StrategySimulationTimers.h"
+#include "StrategyReplay.h"
 #include "StrategyGameState.generated.h"
 
 class AStrategyChar;
+class AStrategyBuilding;
 /*class AStrategyMiniMapCapture;*/
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FStrategyResourcesChangedDelegate, uint8 /*TeamNum*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FStrategyGameplayStateChangedDelegate, EGameplayState::Type /*NewState*/);
+
 UCLASS(config=Game)
 class AStrategyGameState : public AGameStateBase
 {
 	GENERATED_UCLASS_BODY()
 
+	/** snapshots save and restore protected state */
+	friend struct FStrategySnapshot;
+
 public:
 	/** Mini map camera component. */
 	TWeakObjectPtr<AStrategyMiniMapCapture> MiniMapCamera;
@@ -31,6 +48,34 @@ public:
 	/** Current difficulty level of the game. */
 	EGameDifficulty::Type GameDifficulty;
 
+	/** Size of a single cell of the unit spatial index */
+	UPROPERTY(config)
+	float UnitGridCellSize;
+
+	/** Size of a single cell of the team visibility grid */
+	UPROPERTY(config)
+	float VisibilityCellSize;
+
+	/** How far team buildings see, for the team visibility grid */
+	UPROPERTY(config)
+	float BuildingSightRadius;
+
+	/** Find melee targets in unit spatial index, physics sweep is then only used for buildings */
+	UPROPERTY(config)
+	bool bUseSpatialMeleeQuery;
+
+	/** Run gameplay in fixed steps of SimulationStep instead of once per frame */
+	UPROPERTY(config)
+	bool bUseFixedSimulationStep;
+
+	/** Length of a fixed simulation step in seconds */
+	UPROPERTY(config)
+	float SimulationStep;
+
+	/** Seed of gameplay random stream, 0 picks a new one each match. -MatchSeed= on command line overrides it */
+	UPROPERTY(config)
+	int32 MatchSeed;
+
 	/*
 	 * Return number of living pawns from a team.
 	 *
@@ -55,6 +100,13 @@ public:
 	 */
 	void OnCharDied(AStrategyChar* InChar);
 
+	/**
+	 * Notification that a character was removed from the game, dead or not.
+	 *
+	 * @param	InChar	The character that was removed.
+	 */
+	void OnCharRemoved(AStrategyChar* InChar);
+
 	/**
 	 * Notification that a character has spawned.
 	 *
@@ -62,6 +114,13 @@ public:
 	 */
 	void OnCharSpawned(AStrategyChar* InChar);
 
+	/**
+	 * Notification that team or pawn data of a character changed.
+	 *
+	 * @param	InChar	The character that changed.
+	 */
+	void OnCharDataChanged(AStrategyChar* InChar);
+
 	/**
 	 * Notification that an actor was damaged.
 	 *
@@ -71,6 +130,90 @@ public:
 	 */
 	void OnActorDamaged(AActor* InActor, float Damage, AController* EventInstigator);
 
+	// Begin Actor interface
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End Actor interface
+
+	/** Get queue of damage to apply at the end of this frame. */
+	FStrategyDamageQueue& GetDamageQueue();
+
+	/** Get system applying health regen and damage over time to chars. */
+	FStrategyHealthRegenSystem& GetHealthRegenSystem();
+
+	/** Get all live units, published at most once per frame. */
+	const FStrategyUnitRegistry& GetUnitRegistry() const;
+
+	/** Get spatial index of live units, rebuilt at most once per frame. */
+	const FStrategyUnitSpatialIndex& GetUnitSpatialIndex() const;
+
+	/** Get buildings under construction. */
+	const FStrategyConstructionScheduler& GetConstructionScheduler() const;
+
+	/** Get what each team can see, updated at most once per frame. */
+	const FStrategyVisibilityGrid& GetVisibilityGrid() const;
+
+	/** Get gameplay time in seconds, use it instead of world time for anything affecting the outcome of a match. */
+	float GetSimulationTime() const;
+
+	/** Get gameplay time between last two simulation steps, for rendering. */
+	float GetInterpolatedTime() const;
+
+	/** Get random stream for gameplay draws, seeded at match start. */
+	FRandomStream& GetRandomStream();
+
+	/** Get clock driving gameplay time. */
+	const FStrategySimulationClock& GetSimulationClock() const;
+
+	/** Get timers on gameplay time, use them instead of world timers for anything affecting the outcome of a match. */
+	FStrategySimulationTimers& GetSimulationTimers();
+
+	/** Get recorder of player commands, null unless started with -RecordReplay= */
+	FStrategyReplayRecorder* GetReplayRecorder() const;
+
+	/**
+	 * Get gameplay time of world's game state.
+	 *
+	 * @param	World	The world to check.
+	 * @returns gameplay time, or world time if there is no game state.
+	 */
+	static float GetWorldSimulationTime(const UWorld* World);
+
+	/**
+	 * Get gameplay random stream of world's game state.
+	 *
+	 * @param	World	The world to check.
+	 * @returns seeded stream, or a shared one if there is no game state.
+	 */
+	static FRandomStream& GetWorldRandomStream(const UWorld* World);
+
+	/**
+	 * Schedule a building to finish its construction.
+	 *
+	 * @param	InBuilding	The building that started construction.
+	 * @param	FinishTime	Gameplay time in seconds at which construction is done.
+	 */
+	void OnBuildStarted(AStrategyBuilding* InBuilding, float FinishTime);
+
+	/** Notification that a building was added, removed or changed its construction state. */
+	void OnBuildingChanged();
+
+	/** Get number bumped on every OnBuildingChanged, for caches of building state. */
+	uint32 GetBuildingsRevision() const;
+
+	/**
+	 * Notification that resources of a team were changed, call after changing ResourcesAvailable.
+	 *
+	 * @param	TeamNum	The team whose resources changed.
+	 */
+	void NotifyResourcesChanged(uint8 TeamNum);
+
+	/** Broadcast on NotifyResourcesChanged, UI updates cached text from it instead of polling. */
+	FStrategyResourcesChangedDelegate OnResourcesChanged;
+
+	/** Broadcast after gameplay state changed, winning team is already set when the game is finished. */
+	FStrategyGameplayStateChangedDelegate OnGameplayStateChanged;
+
 	/**
 	 * Get a team's data.
 	 *
@@ -124,9 +267,6 @@ protected:
 	/** Gameplay information about each player. */
 	mutable TArray<FPlayerData> PlayersData;
 
-	/** Count of live pawns for each team */
-	uint32 LivePawnCounter[EStrategyTeam::MAX];
-
 	/** Team that won.  Set at end of game. */
 	EStrategyTeam::Type WinningTeam;
 
@@ -136,6 +276,55 @@ protected:
 	/** Handle for efficient management of UpdateHealth timer */
 	FTimerHandle TimerHandle_OnGameStart;
 
+	/** Live units, also holds count of live pawns for each team */
+	mutable FStrategyUnitRegistry UnitRegistry;
+
+	/** Live units bucketed by location */
+	mutable FStrategyUnitSpatialIndex UnitSpatialIndex;
+
+	/** Frame number when UnitSpatialIndex was last rebuilt */
+	mutable uint64 UnitSpatialIndexFrame;
+
+	/** What each team can see, from unit and building sight */
+	mutable FStrategyVisibilityGrid VisibilityGrid;
+
+	/** Frame number when VisibilityGrid was last updated */
+	mutable uint64 VisibilityGridFrame;
+
+	/** Damage dealt this frame */
+	FStrategyDamageQueue DamageQueue;
+
+	/** Health regen for all live chars */
+	FStrategyHealthRegenSystem HealthRegenSystem;
+
+	/** Buildings under construction, ordered by finish time */
+	FStrategyConstructionScheduler ConstructionScheduler;
+
+	/** Bumped whenever a building is added, removed or changes construction state */
+	uint32 BuildingsRevision;
+
+	/** Headless match run, only set with -StrategySim */
+	TUniquePtr<FStrategyMatchSimulation> MatchSimulation;
+
+	/** Gameplay time and random stream */
+	FStrategySimulationClock SimulationClock;
+
+	/** Timers fired from simulation steps */
+	FStrategySimulationTimers SimulationTimers;
+
+	/** Records player commands, only set with -RecordReplay= */
+	TUniquePtr<FStrategyReplayRecorder> ReplayRecorder;
+
+	/** Plays back recorded commands, only set with -PlayReplay= */
+	TUniquePtr<FStrategyReplayPlayer> ReplayPlayer;
+
+	/**
+	 * Run game state systems for a single simulation step.
+	 *
+	 * @param	StepDelta	Length of the step in seconds.
+	 */
+	void StepSimulation(float StepDelta);
+
 	/**
 	 * Register new char to get information from it.
 	 *
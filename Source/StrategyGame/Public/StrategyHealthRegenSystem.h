@@ -0,0 +1,69 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AStrategyChar;
+struct FStrategyDamageQueue;
+
+/**
+ * Applies health regen and damage over time to all live chars.
+ * Every char is processed once per RegenInterval, with the work spread evenly across frames.
+ */
+struct FStrategyHealthRegenSystem
+{
+	/** time between two updates of the same char */
+	static const float RegenInterval;
+
+	FStrategyHealthRegenSystem();
+
+	/**
+	 * Start processing char.
+	 *
+	 * @param	InChar	The character to add.
+	 */
+	void AddChar(AStrategyChar* InChar);
+
+	/**
+	 * Stop processing char.
+	 *
+	 * @param	InChar	The character to remove.
+	 */
+	void RemoveChar(AStrategyChar* InChar);
+
+	/**
+	 * Refresh regen and max health after char's pawn data changed.
+	 *
+	 * @param	InChar	The character to refresh.
+	 */
+	void UpdateChar(AStrategyChar* InChar);
+
+	/**
+	 * Process the share of chars due this frame.
+	 *
+	 * @param	DeltaTime	Time since last frame.
+	 * @param	DamageQueue	Queue receiving damage over time.
+	 */
+	void Tick(float DeltaTime, FStrategyDamageQueue& DamageQueue);
+
+	/** drop all chars */
+	void Reset();
+
+private:
+	/** registered chars, indices match Regen and MaxHealth */
+	TArray<AStrategyChar*> Chars;
+
+	/** health change per interval for each char, negative is damage over time */
+	TArray<int32> Regen;
+
+	/** health cap for each char */
+	TArray<int32> MaxHealth;
+
+	/** index of each char in arrays above */
+	TMap<AStrategyChar*, int32> CharIndices;
+
+	/** next char to process */
+	int32 Cursor;
+
+	/** fractional number of chars owed processing */
+	float Budget;
+};
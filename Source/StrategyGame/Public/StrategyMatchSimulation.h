@@ -0,0 +1,125 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "StrategyTypes.h"
+
+class AStrategyGameState;
+
+/**
+ * Runs a match without anyone playing, for balancing and soak tests.
+ * Enabled with -StrategySim, meant to be used along with -nullrhi -nosound -unattended:
+ *
+ *   -SimScript=<file>		player actions to replay, see LoadScript
+ *   -SimOutput=<file>		per second summary as json lines, only logged if not set
+ *   -SimStep=<seconds>		fixed time step, the game runs as fast as the CPU allows (default 1/30)
+ *   -SimSpeed=<scale>		time dilation, used instead of fixed step when -SimStep=0
+ *   -SimTimeLimit=<seconds>	end the match as a draw after this much game time
+ *
+ * The process exits once the match is finished.
+ */
+struct FStrategyMatchSimulation
+{
+	FStrategyMatchSimulation();
+	~FStrategyMatchSimulation();
+
+	/** @returns true if simulation was requested on the command line */
+	static bool IsRequested();
+
+	/**
+	 * Read command line options and script, set up game clock.
+	 *
+	 * @param	InGameState	The game state running the match.
+	 * @returns true if simulation is ready to run.
+	 */
+	bool Init(AStrategyGameState* InGameState);
+
+	/**
+	 * Replay actions that are due and write summary once per second of game time.
+	 *
+	 * @param	DeltaSeconds	Game time since last frame.
+	 * @param	SystemsSeconds	Real time spent in game state systems this frame.
+	 */
+	void Tick(float DeltaSeconds, double SystemsSeconds);
+
+	/**
+	 * Write final summary and quit.
+	 *
+	 * @param	WinningTeam	The team that won.
+	 */
+	void OnGameFinished(EStrategyTeam::Type WinningTeam);
+
+private:
+	/** scripted player action */
+	struct FAction
+	{
+		/** game time in seconds */
+		float Time;
+
+		/** action name */
+		FString Name;
+
+		/** action arguments */
+		TArray<FString> Args;
+	};
+
+	/**
+	 * Load player actions, one per line: "<seconds> <action> [args]", '#' starts a comment.
+	 *   SpawnDwarf						spawn from the player's brewery
+	 *   Upgrade <building> <class path>	ReplaceBuilding on a building placed in the level
+	 *   Tap <resource node>				tap a resource node placed in the level
+	 *   AddGold <amount>					give resources to the player
+	 *
+	 * @param	Path	The script file.
+	 * @returns false if script could not be read.
+	 */
+	bool LoadScript(const FString& Path);
+
+	/** execute single action */
+	void RunAction(const FAction& Action);
+
+	/** write summary of the last second and reset frame stats */
+	void WriteSummary(const TCHAR* Event);
+
+	/** write single line to output and log */
+	void WriteLine(const FString& Line);
+
+	/** game state running the match */
+	TWeakObjectPtr<AStrategyGameState> GameState;
+
+	/** scripted actions, ordered by time */
+	TArray<FAction> Actions;
+
+	/** next action to run */
+	int32 NextAction;
+
+	/** summary file, null if logging only */
+	FArchive* Output;
+
+	/** game time of next summary */
+	float NextSummaryTime;
+
+	/** match ends after this much game time, 0 for no limit */
+	float TimeLimit;
+
+	/** set once the match is over */
+	bool bFinished;
+
+	/** frames since last summary */
+	int32 NumFrames;
+
+	/** real time at the end of last frame */
+	double LastFrameTime;
+
+	/** real time spent in frames since last summary */
+	double FrameSeconds;
+
+	/** longest frame since last summary */
+	double MaxFrameSeconds;
+
+	/** game thread time since last summary */
+	double GameThreadSeconds;
+
+	/** time spent in game state systems since last summary */
+	double SystemsSeconds;
+};
@@ -6,6 +6,11 @@
 
 class UTextureRenderTarget2D;
 
+/**
+ * Top down camera for the mini map background and world bounds.
+ * Only terrain goes into the background, buildings and units are drawn over it by the HUD.
+ * With BakedTerrain set nothing is captured at runtime, otherwise terrain is captured once at load.
+ */
 UCLASS(Blueprintable)
 class AStrategyMiniMapCapture : public ASceneCapture2D
 {
@@ -24,6 +29,10 @@ public:
 #if WITH_EDITOR
 
 protected:
+	/** capture terrain into BakedTerrain, saved along with the map */
+	UFUNCTION(CallInEditor, Category=MiniMap)
+	void BakeTerrain();
+
 	/** filter out to apply delta Yaw */
 	virtual void EditorApplyRotation(const FRotator& DeltaRotation, bool bAltDown, bool bShiftDown, bool bCtrlDown) override;
 	// End Actor interface
@@ -47,6 +56,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=MiniMap)
 	int32 GroundLevel;
 
+	/** terrain seen by the camera, baked in editor; captured at load if not set */
+	UPROPERTY(EditAnywhere, Category=MiniMap)
+	UTexture2D* BakedTerrain;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=AudioListener)
 	float AudioListenerGroundLevel;
 
@@ -62,11 +75,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=AudioListener)
 	FVector AudioListenerLocationOffset;
 
+	/** @returns mini map background, baked terrain if there is one */
+	UTexture* GetTerrainTexture() const;
+
 protected:
 
 	/** updated world bounds */
 	void UpdateWorldBounds();
 
+	/** render terrain into capture target, with buildings and units hidden */
+	void CaptureTerrain();
+
 	UPROPERTY()
 	UTextureRenderTarget2D* MiniMapView;
 
@@ -0,0 +1,77 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/StreamableManager.h"
+#include "StrategyPreloader.generated.h"
+
+/**
+ * Loads the game map and what a match needs ahead of travel, so starting a match doesn't wait on disk.
+ * Started speculatively by the main menu. Batches are requested in priority order:
+ * map packages, then HUD assets, then gameplay classes.
+ * Everything loaded stays referenced through travel and is released once the match has started.
+ */
+UCLASS(config=Game)
+class UStrategyPreloader : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+	/** packages of the game map and its sublevels */
+	UPROPERTY(config)
+	TArray<FString> MapPackages;
+
+	/** minion, projectile and building classes spawned during a match */
+	UPROPERTY(config)
+	TArray<FSoftObjectPath> GameplayClasses;
+
+	/** @returns preloader shared by all worlds */
+	static UStrategyPreloader* Get();
+
+	/** start loading everything that isn't loaded yet, does nothing if already started */
+	void StartPreload();
+
+	/** push progress to the loading screen, also while loading is flushed during travel */
+	void ReportProgressToLoadingScreen();
+
+	/** drop references to preloaded assets, to be called once the match holds its own */
+	void Release();
+
+	/** @returns progress of preload from 0 to 1 */
+	float GetProgress() const;
+
+	/** @returns true if preload was started and everything finished loading */
+	bool IsComplete() const;
+
+private:
+	/** map package finished loading */
+	void OnMapPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+
+	/** update loading screen while async loading is flushed */
+	void OnAsyncLoadingFlushUpdate();
+
+	/** keep world of loaded map package referenced, a package alone doesn't keep its objects from being collected */
+	void AddLoadedMapPackage(UPackage* Package);
+
+	/** names of loaded map packages */
+	TArray<FName> LoadedMapPackages;
+
+	/** worlds of loaded map packages, kept through travel */
+	UPROPERTY(transient)
+	TArray<UWorld*> LoadedMapWorlds;
+
+	/** map packages still loading */
+	TArray<FName> PendingMapPackages;
+
+	/** handles of asset batches */
+	TSharedPtr<FStreamableHandle> HUDAssetsHandle;
+	TSharedPtr<FStreamableHandle> GameplayClassesHandle;
+
+	/** loads asset batches */
+	FStreamableManager StreamableManager;
+
+	/** handle of flush update delegate, while reporting to loading screen */
+	FDelegateHandle FlushUpdateHandle;
+
+	/** set once preload was started, until released */
+	bool bStarted;
+};
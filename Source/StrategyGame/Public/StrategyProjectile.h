@@ -14,6 +14,9 @@ class AStrategyProjectile : public AActor, public IStrategyTeamInterface
 {
 	GENERATED_UCLASS_BODY()
 
+	/** snapshots save and restore protected state */
+	friend struct FStrategySnapshot;
+
 private:
 	/** movement component */
 	UPROPERTY(VisibleDefaultsOnly, Category=Projectile)
@@ -54,6 +57,9 @@ public:
 
 	virtual void LifeSpanExpired() override;
 
+	/** unregister team */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** handle touch to detect enemy pawns */
 	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
 
@@ -0,0 +1,206 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AActor;
+class AStrategyBuilding;
+class AStrategyGameState;
+
+/**
+ * Match replays hold the random seed, the player's commands and a periodic checksum of the match state.
+ * Everything else is simulated again on playback, which needs a fixed simulation step to stay in sync.
+ *
+ * File layout, integers are little endian and "varint" is 7 bits per byte:
+ *   header:	uint32 magic, uint16 version, int32 seed, uint8 fixed step, float step, varint checksum interval, string map
+ *   records:	uint8 type, varint steps since previous record, payload (see ERecord)
+ * Strings are a varint index into strings seen so far, followed by varint length and UTF-8 bytes when new.
+ * Locations are zigzag varints, rounded to whole units.
+ */
+struct FStrategyReplay
+{
+	/** 'SGRP' */
+	static const uint32 Magic = 0x50524753;
+
+	/** bump on any format change */
+	static const uint16 Version = 1;
+
+	/** steps between two checksums */
+	static const int32 ChecksumInterval = 30;
+
+	/** record types */
+	enum ERecord : uint8
+	{
+		/** end of replay, no payload */
+		Record_End = 0,
+		/** tap on actor: string name, location */
+		Record_Tap = 1,
+		/** building upgrade: string name, location, string class path */
+		Record_Upgrade = 2,
+		/** dwarf bought in player's brewery: no payload */
+		Record_SpawnDwarf = 3,
+		/** state checksum: uint32 */
+		Record_Checksum = 4,
+	};
+
+	/**
+	 * Hash state that commands and simulation change: resources, damage and all live units.
+	 *
+	 * @param	GameState	The game state to hash.
+	 */
+	static uint32 ComputeChecksum(const AStrategyGameState* GameState);
+};
+
+/** Writes player commands of the current match into a replay file. */
+struct FStrategyReplayRecorder
+{
+	FStrategyReplayRecorder();
+
+	/**
+	 * Start recording, file is written by Finish.
+	 *
+	 * @param	InPath		File to write.
+	 * @param	GameState	Game state of the match, with simulation clock already reset.
+	 */
+	void Start(const FString& InPath, const AStrategyGameState* GameState);
+
+	/** record tap on actor */
+	void RecordTap(const AStrategyGameState* GameState, const AActor* Target);
+
+	/** record building upgrade */
+	void RecordUpgrade(const AStrategyGameState* GameState, const AStrategyBuilding* Target, const UClass* NewBuildingClass);
+
+	/** record dwarf bought in player's brewery */
+	void RecordSpawnDwarf(const AStrategyGameState* GameState);
+
+	/** notify that a simulation step is done, writes checksum every ChecksumInterval steps */
+	void OnStep(const AStrategyGameState* GameState);
+
+	/**
+	 * Hold frame until real time catches up with gameplay time. Recording runs the engine at a fixed step,
+	 * which doesn't wait for real time by itself.
+	 *
+	 * @param	GameState	Game state of the match.
+	 */
+	void WaitForRealTime(const AStrategyGameState* GameState);
+
+	/** close replay and write it to disk, does nothing after the first call */
+	void Finish(const AStrategyGameState* GameState);
+
+private:
+	/** write record header */
+	void BeginRecord(const AStrategyGameState* GameState, uint8 Type);
+
+	/** write name and location of actor */
+	void WriteTarget(const AActor* Target);
+
+	/** write string, reusing index of strings already written */
+	void WriteString(const FString& String);
+
+	/** replay file */
+	FString Path;
+
+	/** encoded replay */
+	TArray<uint8> Data;
+
+	/** index of strings already written */
+	TMap<FString, int32> Strings;
+
+	/** step count of last record */
+	int64 LastStep;
+
+	/** FPlatformTime::Seconds at which gameplay time was zero, for pacing */
+	double RealTimeOrigin;
+
+	/** set once written to disk */
+	bool bFinished;
+};
+
+/** Reads a replay file and feeds its commands back into the match. */
+struct FStrategyReplayPlayer
+{
+	FStrategyReplayPlayer();
+
+	/**
+	 * Read replay file.
+	 *
+	 * @param	Path	File to read.
+	 * @returns false if file is missing or not a replay of this version.
+	 */
+	bool Load(const FString& Path);
+
+	/** @returns seed of recorded match */
+	int32 GetSeed() const { return Seed; }
+
+	/** @returns true if recorded with fixed simulation step */
+	bool IsFixedStep() const { return bFixedStep; }
+
+	/** @returns length of simulation step */
+	float GetStep() const { return Step; }
+
+	/** @returns map the replay was recorded on */
+	const FString& GetMapName() const { return MapName; }
+
+	/**
+	 * Run commands recorded before the next simulation step.
+	 *
+	 * @param	GameState	Game state of the match.
+	 */
+	void OnPreStep(AStrategyGameState* GameState);
+
+	/**
+	 * Verify checksum recorded after the simulation step that just finished.
+	 *
+	 * @param	GameState	Game state of the match.
+	 */
+	void OnPostStep(AStrategyGameState* GameState);
+
+	/** @returns true once the replay ran out of records */
+	bool IsFinished() const { return bFinished; }
+
+	/** @returns true if simulation went a different way than the recorded match */
+	bool HasDiverged() const { return bDiverged; }
+
+private:
+	/** execute next record and read header of the one after it */
+	void RunRecord(AStrategyGameState* GameState);
+
+	/** read type and step of next record */
+	void ReadRecordHeader();
+
+	/** find actor by name, or building closest to recorded location */
+	AActor* ReadTarget(AStrategyGameState* GameState);
+
+	/** primitive readers, past the end of data they read zeroes */
+	uint8 ReadByte();
+	uint64 ReadVarint();
+	int64 ReadZigZag();
+	uint32 ReadUInt32();
+	FString ReadString();
+
+	/** encoded replay */
+	TArray<uint8> Data;
+
+	/** read position in Data */
+	int32 Offset;
+
+	/** strings read so far */
+	TArray<FString> Strings;
+
+	/** step count at which the next record is due */
+	int64 NextRecordStep;
+
+	/** type of next record */
+	uint8 NextRecordType;
+
+	/** recorded match settings, see header layout */
+	int32 Seed;
+	float Step;
+	bool bFixedStep;
+	FString MapName;
+
+	/** set when all records were played */
+	bool bFinished;
+
+	/** set at first mismatched checksum */
+	bool bDiverged;
+};
@@ -53,6 +53,9 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category=ResourceNode)
 	int32 NumResources;
 
+	/** Index of our class in FStrategyClassStatTable */
+	mutable int32 ClassStatsIndex;
+
 	/** blueprint event: demolished */
 	UFUNCTION(BlueprintImplementableEvent, Category=ResourceNode)
 	void OnDepleted();
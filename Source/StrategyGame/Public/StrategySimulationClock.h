@@ -0,0 +1,89 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Gameplay time and random numbers for a single match.
+ * With a fixed step, time advances in whole steps no matter the frame rate and rendering
+ * interpolates between the last two steps. Otherwise every frame is a step of its own.
+ * All gameplay random draws come from a stream seeded at match start, so a match can be replayed from its seed.
+ */
+struct FStrategySimulationClock
+{
+	FStrategySimulationClock();
+
+	/**
+	 * Restart time from zero and reseed random stream.
+	 *
+	 * @param	bInFixedStep	Advance in steps of InStep instead of once per frame.
+	 * @param	InStep			Length of a fixed step in seconds.
+	 * @param	InSeed			Seed of the random stream.
+	 */
+	void Reset(bool bInFixedStep, float InStep, int32 InSeed);
+
+	/**
+	 * Continue from saved time and random state, keeping seed and step settings.
+	 *
+	 * @param	InTime			Gameplay time in seconds.
+	 * @param	InStepCount		Steps simulated until then.
+	 * @param	InRandomState	Current seed of the random stream, see FRandomStream::GetCurrentSeed.
+	 */
+	void Restore(double InTime, int64 InStepCount, int32 InRandomState);
+
+	/**
+	 * Accumulate frame time.
+	 *
+	 * @param	DeltaSeconds	Time since last frame.
+	 * @returns number of steps to simulate this frame, each GetStepDelta long.
+	 */
+	int32 Advance(float DeltaSeconds);
+
+	/** @returns true if stepping at fixed rate */
+	bool IsFixedStep() const { return bFixedStep; }
+
+	/** @returns length of steps returned by last Advance */
+	float GetStepDelta() const { return StepDelta; }
+
+	/** @returns gameplay time in seconds, after all simulated steps */
+	float GetTime() const { return float(Time); }
+
+	/** @returns number of steps simulated since reset */
+	int64 GetStepCount() const { return StepCount; }
+
+	/** @returns how far rendering is between last step and next one, [0,1) */
+	float GetAlpha() const;
+
+	/** @returns gameplay time as seen by rendering */
+	float GetInterpolatedTime() const;
+
+	/** @returns seed of current match */
+	int32 GetSeed() const { return Seed; }
+
+	/** @returns random stream for gameplay draws */
+	FRandomStream& GetRandom() { return Random; }
+
+private:
+	/** gameplay random stream */
+	FRandomStream Random;
+
+	/** gameplay time, doubles keep fixed steps exact over long matches */
+	double Time;
+
+	/** frame time not yet simulated */
+	double Accumulator;
+
+	/** steps simulated since reset */
+	int64 StepCount;
+
+	/** fixed step length */
+	float Step;
+
+	/** length of steps returned by last Advance */
+	float StepDelta;
+
+	/** seed of current match */
+	int32 Seed;
+
+	/** advance in fixed steps */
+	bool bFixedStep;
+};
@@ -0,0 +1,113 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/** identifies a timer set on FStrategySimulationTimers */
+struct FStrategySimulationTimerHandle
+{
+	FStrategySimulationTimerHandle()
+		: Id(0)
+	{
+	}
+
+	/** @returns true if handle was ever set, the timer itself may have fired or been cleared since */
+	bool IsValid() const { return Id != 0; }
+
+	/** forget timer */
+	void Invalidate() { Id = 0; }
+
+private:
+	friend struct FStrategySimulationTimers;
+
+	/** timer id, 0 if not set */
+	uint32 Id;
+};
+
+/**
+ * Timers on gameplay time, fired from simulation steps instead of the world timer manager.
+ * Due timers fire in order of due time, timers due at the same time in the order they were set,
+ * so a match always runs them in the same order no matter the frame rate.
+ */
+struct FStrategySimulationTimers
+{
+	FStrategySimulationTimers();
+
+	/**
+	 * Start timer, replacing the one handle refers to.
+	 *
+	 * @param	InOutHandle		Handle of the timer.
+	 * @param	Delegate		Called when timer is due, timer is dropped once its object is gone.
+	 * @param	FirstDueTime	Gameplay time of the first call, in seconds.
+	 * @param	Rate			Time between calls when looping, in seconds.
+	 * @param	bLoop			Keep calling every Rate seconds, ignored if Rate isn't positive.
+	 */
+	void SetTimer(FStrategySimulationTimerHandle& InOutHandle, const FTimerDelegate& Delegate, float FirstDueTime, float Rate = 0.0f, bool bLoop = false);
+
+	/**
+	 * Stop timer and invalidate handle.
+	 *
+	 * @param	InOutHandle		Handle of the timer.
+	 */
+	void ClearTimer(FStrategySimulationTimerHandle& InOutHandle);
+
+	/** @returns true if timer is still going to fire */
+	bool IsTimerActive(const FStrategySimulationTimerHandle& Handle) const;
+
+	/**
+	 * Fire all timers due by given time.
+	 *
+	 * @param	CurrentTime		Gameplay time after the step, in seconds.
+	 */
+	void Tick(float CurrentTime);
+
+	/**
+	 * Move all pending timers in time, e.g. when the clock was restored from a snapshot.
+	 *
+	 * @param	Delta	Seconds to add to due times.
+	 */
+	void ShiftTimes(float Delta);
+
+	/** drop all timers */
+	void Reset();
+
+private:
+	/** single pending timer */
+	struct FTimer
+	{
+		/** called when due */
+		FTimerDelegate Delegate;
+
+		/** time between calls, 0 if not looping */
+		float Rate;
+	};
+
+	/** pending call of a timer */
+	struct FEntry
+	{
+		/** gameplay time of the call */
+		double DueTime;
+
+		/** order of scheduling, breaks ties of due time */
+		uint32 Sequence;
+
+		/** timer to call, the call is stale if it's gone */
+		uint32 Id;
+
+		bool operator<(const FEntry& Other) const
+		{
+			return DueTime < Other.DueTime || (DueTime == Other.DueTime && Sequence < Other.Sequence);
+		}
+	};
+
+	/** heap of pending calls, earliest on top */
+	TArray<FEntry> Heap;
+
+	/** active timers by id */
+	TMap<uint32, FTimer> Timers;
+
+	/** id of next timer */
+	uint32 NextId;
+
+	/** sequence of next scheduled call */
+	uint32 NextSequence;
+};
@@ -0,0 +1,59 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class AStrategyGameState;
+
+/**
+ * Full match state saved to disk and restored in place, for jumping straight into a late wave while testing.
+ * Covers game state (team data, gameplay state, warmup timer, simulation clock), breweries, buildings,
+ * minions (transform, health, buffs, attachments, AI action) and projectiles in flight.
+ *
+ * File layout, all fixed size little endian records with no per-object headers:
+ *   header:	uint32 magic, uint32 version, uint32 total size, uint32 section count, section table
+ *   section:	uint32 offset, uint32 count, uint32 stride, uint32 reserved
+ * Each section is a flat array of records aligned to 16 bytes, the file is mapped and read in place.
+ * Classes are stored as an index into a table of null terminated UTF-8 paths, resolved once per class on restore.
+ * Times are stored as seconds remaining, so they work no matter the simulation time at restore.
+ */
+struct FStrategySnapshot
+{
+	/** 'SGSN' */
+	static const uint32 Magic = 0x4E534753;
+
+	/** bump on any record change */
+	static const uint32 Version = 1;
+
+	/** sections, in file order */
+	enum ESection
+	{
+		Section_Match,
+		Section_Teams,
+		Section_Buildings,
+		Section_Chars,
+		Section_Buffs,
+		Section_Projectiles,
+		Section_ClassOffsets,
+		Section_ClassNames,
+		Section_MAX
+	};
+
+	/**
+	 * Write state of the running match.
+	 *
+	 * @param	GameState	Game state of the match.
+	 * @param	Path		File to write.
+	 * @returns false if match isn't running or file could not be written.
+	 */
+	static bool Save(AStrategyGameState* GameState, const FString& Path);
+
+	/**
+	 * Replace state of the running match with a saved one.
+	 * Must be the same map, buildings are matched to the ones in the level by location.
+	 *
+	 * @param	GameState	Game state of the match.
+	 * @param	Path		File to read.
+	 * @returns false if file is missing or not a snapshot of this version.
+	 */
+	static bool Restore(AStrategyGameState* GameState, const FString& Path);
+};
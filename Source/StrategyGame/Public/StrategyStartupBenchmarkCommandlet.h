@@ -0,0 +1,52 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "StrategyStartupBenchmarkCommandlet.generated.h"
+
+/**
+ * Cold start benchmark, launches the game headless (-nullrhi) straight into the game map a number of times
+ * and measures time from process start to the first playable frame, see FStrategyStartupTrace.
+ * Reports percentiles and fails (non zero exit code) if p90 is above the threshold.
+ *
+ *   UE4Editor-Cmd StrategyGame -run=StrategyStartupBenchmark [-Runs=N] [-MaxP90=Seconds] [-Map=/Game/Maps/X]
+ */
+UCLASS(config=Game)
+class UStrategyStartupBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	/** map launched into */
+	UPROPERTY(config)
+	FString Map;
+
+	/** number of launches */
+	UPROPERTY(config)
+	int32 NumRuns;
+
+	/** regression threshold for p90 of time to first playable frame in seconds, 0 disables the check */
+	UPROPERTY(config)
+	float MaxP90Seconds;
+
+	/** a launch that doesn't reach the first playable frame in time is killed and counted as failed */
+	UPROPERTY(config)
+	float RunTimeoutSeconds;
+
+	// Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet interface
+
+private:
+	/**
+	 * Launch the game once and wait for it to exit.
+	 *
+	 * @param	RunIndex		Index of the launch, for file names and logs.
+	 * @param	OutSeconds		Time to first playable frame reported by the game.
+	 * @returns false if the game didn't report a time.
+	 */
+	bool LaunchOnce(int32 RunIndex, double& OutSeconds) const;
+
+	/** @returns nearest rank percentile of sorted times */
+	static double GetPercentile(const TArray<double>& SortedTimes, float Percentile);
+};
@@ -0,0 +1,77 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Timeline of startup phases, from process start to the first playable frame of a match.
+ * Times are seconds since process start. Phases are recorded only until the first playable frame,
+ * then written once to Saved/Profiling/StartupTrace.json in Chrome trace event format (chrome://tracing).
+ * Launched with -StartupBenchmarkResult=<file>, time to first playable frame is also written to that file
+ * and the game exits, see UStrategyStartupBenchmarkCommandlet.
+ */
+struct FStrategyStartupTrace
+{
+	/** hook map loads, call once when game module starts */
+	static void Initialize();
+
+	/** unhook map loads */
+	static void Shutdown();
+
+	/**
+	 * Start a named phase, ended by EndPhase with the same name.
+	 *
+	 * @param	Name	Name of the phase, phases with the same name may not overlap.
+	 */
+	static void BeginPhase(const FString& Name);
+
+	/**
+	 * End the latest open phase with given name, ignored if there is none.
+	 *
+	 * @param	Name	Name of the phase.
+	 */
+	static void EndPhase(const FString& Name);
+
+	/**
+	 * Add phase measured elsewhere, e.g. by a module that can't depend on this one.
+	 *
+	 * @param	Name		Name of the phase.
+	 * @param	StartTime	FPlatformTime::Seconds() when the phase started.
+	 * @param	EndTime		FPlatformTime::Seconds() when the phase ended.
+	 */
+	static void AddPhase(const FString& Name, double StartTime, double EndTime);
+
+	/** first frame of a match the player can act in, closes and writes the trace. Cheap to call every frame */
+	static void MarkFirstPlayableFrame();
+
+	/** @returns true once the first playable frame was reached */
+	static bool IsFinished() { return bFinished; }
+
+private:
+	/** write trace file, and benchmark result if requested */
+	static void Write(double FirstPlayableTime);
+
+	/** map load delegates */
+	static void OnPreLoadMap(const FString& MapName);
+	static void OnPostLoadMap(UWorld* LoadedWorld);
+
+	/** set once the first playable frame was reached */
+	static bool bFinished;
+};
+
+/** times a startup phase for the lifetime of the scope */
+struct FStrategyStartupScope
+{
+	explicit FStrategyStartupScope(const TCHAR* InName)
+		: Name(InName)
+	{
+		FStrategyStartupTrace::BeginPhase(Name);
+	}
+
+	~FStrategyStartupScope()
+	{
+		FStrategyStartupTrace::EndPhase(Name);
+	}
+
+private:
+	const TCHAR* Name;
+};
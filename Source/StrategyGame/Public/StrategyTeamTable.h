@@ -0,0 +1,79 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "StrategyTypes.h"
+
+/**
+ * Team of every registered object, indexed by its object index, so team checks don't need interface casts.
+ * Objects implementing IStrategyTeamInterface register when they get a team and unregister at EndPlay.
+ */
+class FStrategyTeamTable
+{
+public:
+	/** team id of objects that don't belong to any team */
+	static const uint8 NoTeam = EStrategyTeam::MAX;
+
+	/**
+	 * Store team of object.
+	 *
+	 * @param	InObject	Object implementing IStrategyTeamInterface.
+	 * @param	TeamNum		Its current team.
+	 */
+	static void SetTeam(const UObject* InObject, uint8 TeamNum);
+
+	/**
+	 * Forget team of object, must be called before object goes away.
+	 *
+	 * @param	InObject	Previously registered object.
+	 */
+	static void ClearTeam(const UObject* InObject);
+
+	/**
+	 * Get team of object. Unregistered objects fall back to IStrategyTeamInterface.
+	 *
+	 * @param	InObject	Object to check, can be null.
+	 * @returns team number, or NoTeam.
+	 */
+	static uint8 GetTeam(const UObject* InObject);
+
+	/** @returns true if teams are friendly, see AStrategyGameMode::OnFriendlyTeam */
+	static FORCEINLINE bool IsFriendly(uint8 TeamA, uint8 TeamB)
+	{
+		return FriendlyMatrix[TeamA][TeamB];
+	}
+
+	/** @returns true if teams are enemies, see AStrategyGameMode::OnEnemyTeam */
+	static FORCEINLINE bool IsEnemy(uint8 TeamA, uint8 TeamB)
+	{
+		return EnemyMatrix[TeamA][TeamB];
+	}
+
+	/** Unknown team is friendly with everyone, NoTeam only with Unknown */
+	static constexpr bool FriendlyMatrix[EStrategyTeam::MAX + 1][EStrategyTeam::MAX + 1] =
+	{
+		//	Unknown	Player	Enemy	NoTeam
+		{	true,	true,	true,	true	},	// Unknown
+		{	true,	true,	false,	false	},	// Player
+		{	true,	false,	true,	false	},	// Enemy
+		{	true,	false,	false,	false	},	// NoTeam
+	};
+
+	/** only known, different teams are enemies */
+	static constexpr bool EnemyMatrix[EStrategyTeam::MAX + 1][EStrategyTeam::MAX + 1] =
+	{
+		//	Unknown	Player	Enemy	NoTeam
+		{	false,	false,	false,	false	},	// Unknown
+		{	false,	false,	true,	false	},	// Player
+		{	false,	true,	false,	false	},	// Enemy
+		{	false,	false,	false,	false	},	// NoTeam
+	};
+
+private:
+	/** team + 1 by object index, 0 for unregistered objects */
+	static TArray<uint8> TeamByObjectIndex;
+};
+
+static_assert(FStrategyTeamTable::FriendlyMatrix[EStrategyTeam::Unknown][FStrategyTeamTable::NoTeam], "Unknown team is friendly even with actors without team");
+static_assert(!FStrategyTeamTable::EnemyMatrix[EStrategyTeam::Player][EStrategyTeam::Player], "Team can't be enemy of itself");
+static_assert(FStrategyTeamTable::EnemyMatrix[EStrategyTeam::Player][EStrategyTeam::Enemy], "Player and Enemy are enemies");
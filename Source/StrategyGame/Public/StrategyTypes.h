@@ -27,6 +27,7 @@ namespace EGameKey
 		Swipe,
 		SwipeTwoPoints,
 		Pinch,
+		MAX
 	};
 }
 
@@ -126,6 +127,18 @@ struct FPawnData
 		Speed = 0.0;
 		AttackDistance = 100;
 	}
+
+	/** all values zeroed, used for accumulating buff deltas */
+	explicit FPawnData(EForceInit)
+	{
+		AttackMin = 0;
+		AttackMax = 0;
+		DamageReduction = 0;
+		MaxHealthBonus = 0;
+		HealthRegen = 0;
+		Speed = 0.0;
+		AttackDistance = 0;
+	}
 };
 
 USTRUCT()
@@ -162,6 +175,19 @@ struct FBuffData
 	* @param	PawnData		Data to apply.
 	*/
 	void ApplyBuff(struct FPawnData& PawnData);
+
+	/**
+	* Helper function for reverting buff data applied with ApplyBuff.
+	*
+	* @param	PawnData		Data to revert.
+	*/
+	void RemoveBuff(struct FPawnData& PawnData);
+
+	/** heap predicate, earliest expiring buff first */
+	bool operator<(const FBuffData& Other) const
+	{
+		return EndTime < Other.EndTime;
+	}
 };
 
 struct FPlayerData
@@ -0,0 +1,148 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "EngineUtils.h"
+#include "StrategyTypes.h"
+
+class AStrategyChar;
+
+/**
+ * Chars are never iterated as actors: per frame code reads FStrategyUnitRegistry, anything else uses
+ * FStrategyUnitRegistry::SlowActorRange. Left undefined, so iterating them directly doesn't compile.
+ */
+template<> class TActorIterator<AStrategyChar>;
+template<> class TActorRange<AStrategyChar>;
+
+/**
+ * Marks code that runs every frame. Iterating actors while one is open trips a check,
+ * such code should read FStrategyUnitRegistry instead.
+ */
+struct FStrategyPerFrameScope
+{
+	FStrategyPerFrameScope();
+	~FStrategyPerFrameScope();
+
+	/** @returns true if any per frame scope is open */
+	static bool IsActive();
+
+private:
+	/** number of open scopes */
+	static int32 Depth;
+};
+
+/**
+ * All live chars, registered on spawn and removed on death.
+ * Once per frame their state is published into flat arrays sharing the same index.
+ */
+struct FStrategyUnitRegistry
+{
+	FStrategyUnitRegistry();
+
+	/**
+	 * Start tracking char.
+	 *
+	 * @param	InChar	The character to add.
+	 */
+	void AddChar(AStrategyChar* InChar);
+
+	/**
+	 * Stop tracking char, its published entry is cleared right away.
+	 *
+	 * @param	InChar	The character to remove.
+	 */
+	void RemoveChar(AStrategyChar* InChar);
+
+	/**
+	 * Update team count, and published team and damage reduction, of char after its data changed.
+	 *
+	 * @param	InChar	The character that changed.
+	 */
+	void RefreshChar(AStrategyChar* InChar);
+
+	/**
+	 * Copy state of all registered chars into published arrays, does nothing if already done this frame.
+	 *
+	 * @param	FrameNumber	Current frame.
+	 */
+	void Publish(uint64 FrameNumber);
+
+	/** drop all chars */
+	void Reset();
+
+	/** @returns number of published entries, some may be cleared (null char) */
+	int32 Num() const;
+
+	/** @returns number of registered chars of given team, counted as they are added and removed */
+	int32 GetNumLive(uint8 TeamNum) const;
+
+	/** published chars, null if removed since last publish */
+	const TArray<AStrategyChar*>& GetChars() const { return Chars; }
+
+	/** published world locations */
+	const TArray<FVector>& GetLocations() const { return Locations; }
+
+	/** published scaled capsule size, radius in X and half height in Y */
+	const TArray<FVector2D>& GetCapsuleSizes() const { return CapsuleSizes; }
+
+	/** published teams */
+	const TArray<uint8>& GetTeams() const { return Teams; }
+
+	/** published health, zero if removed since last publish */
+	const TArray<float>& GetHealth() const { return Health; }
+
+	/** published max health */
+	const TArray<int32>& GetMaxHealth() const { return MaxHealth; }
+
+	/** published damage reduction, kept up to date by RefreshChar */
+	const TArray<float>& GetDamageReduction() const { return DamageReduction; }
+
+	/** published AI logic state, see AStrategyAIController::IsLogicEnabled */
+	const TArray<bool>& GetLogicEnabled() const { return LogicEnabled; }
+
+	/**
+	 * Gather all actors of given class in world, not allowed inside FStrategyPerFrameScope.
+	 * The only way to iterate chars as actors.
+	 *
+	 * @param	World	The world to iterate.
+	 * @returns actors found, safe to destroy while looping over them.
+	 */
+	template<class T>
+	static TArray<T*> SlowActorRange(UWorld* World)
+	{
+		checkf(!FStrategyPerFrameScope::IsActive(), TEXT("Actor iteration on a per frame path, read FStrategyUnitRegistry instead"));
+
+		TArray<T*> Actors;
+		for (TActorIterator<AActor> It(World, T::StaticClass()); It; ++It)
+		{
+			Actors.Add(static_cast<T*>(*It));
+		}
+		return Actors;
+	}
+
+private:
+	/** registered chars, in no particular order */
+	TArray<AStrategyChar*> Registered;
+
+	/** team each registered char is counted under */
+	TArray<uint8> RegisteredTeams;
+
+	/** index of each char in Registered */
+	TMap<AStrategyChar*, int32> RegisteredIndices;
+
+	/** published arrays below share the same index */
+	TArray<AStrategyChar*> Chars;
+	TArray<FVector> Locations;
+	TArray<FVector2D> CapsuleSizes;
+	TArray<uint8> Teams;
+	TArray<float> Health;
+	TArray<int32> MaxHealth;
+	TArray<float> DamageReduction;
+	TArray<bool> LogicEnabled;
+
+	/** live chars per team */
+	int32 NumLive[EStrategyTeam::MAX];
+
+	/** frame of last publish */
+	uint64 PublishedFrame;
+};
@@ -0,0 +1,88 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "StrategyTypes.h"
+
+class AStrategyChar;
+
+/**
+ * Uniform 2D grid of live units, used for cheap range queries.
+ * Each team has its own grid, and the map is flat, so only X and Y are hashed.
+ */
+struct FStrategyUnitSpatialIndex
+{
+	/** query results, most queries find only a handful of units */
+	typedef TArray<AStrategyChar*, TInlineAllocator<32>> FCharArray;
+
+	FStrategyUnitSpatialIndex();
+
+	/**
+	 * Drop all units, keeps allocated cells around for the next frame.
+	 *
+	 * @param	InCellSize	Size of a single grid cell in world units.
+	 */
+	void Reset(float InCellSize);
+
+	/**
+	 * Add unit at given location.
+	 *
+	 * @param	InChar		The unit to add.
+	 * @param	Location	World location of the unit.
+	 * @param	TeamNum		Team of the unit.
+	 * @param	Radius		Collision radius of the unit.
+	 */
+	void AddUnit(AStrategyChar* InChar, const FVector& Location, uint8 TeamNum, float Radius);
+
+	/**
+	 * Collect units within radius (2D) of origin.
+	 *
+	 * @param	Origin		Center of the query.
+	 * @param	Radius		Radius of the query.
+	 * @param	OutChars	Units found, not sorted.
+	 * @param	TeamNum		Only look at this team, EStrategyTeam::MAX for all teams.
+	 */
+	void QueryRadius(const FVector& Origin, float Radius, FCharArray& OutChars, uint8 TeamNum = EStrategyTeam::MAX) const;
+
+	/**
+	 * Collect units of teams hostile to given team within radius (2D) of origin.
+	 *
+	 * @param	Origin		Center of the query.
+	 * @param	Radius		Radius of the query.
+	 * @param	MyTeamNum	Team asking, see FStrategyTeamTable::IsEnemy.
+	 * @param	OutChars	Units found, not sorted.
+	 */
+	void QueryEnemies(const FVector& Origin, float Radius, uint8 MyTeamNum, FCharArray& OutChars) const;
+
+	/** @returns number of units in the index */
+	int32 Num() const;
+
+	/** @returns largest collision radius of units in the index, queries testing against unit extent grow by it */
+	float GetMaxUnitRadius() const { return MaxUnitRadius; }
+
+private:
+	/** unit stored in a cell */
+	struct FEntry
+	{
+		AStrategyChar* Char;
+		FVector2D Location;
+	};
+
+	/** @returns grid cell containing given location */
+	FIntPoint GetCell(float X, float Y) const;
+
+	/** collect units of single team */
+	void QueryTeam(const FVector& Origin, float Radius, uint8 TeamNum, FCharArray& OutChars) const;
+
+	/** units bucketed by grid cell, for each team */
+	TMap<FIntPoint, TArray<FEntry>> Cells[EStrategyTeam::MAX];
+
+	/** size of a single grid cell */
+	float CellSize;
+
+	/** number of units added since last reset */
+	int32 NumUnits;
+
+	/** largest radius of units added since last reset */
+	float MaxUnitRadius;
+};
@@ -0,0 +1,176 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "StrategyTypes.h"
+
+/**
+ * What each team can see, as one bit per cell over the world bounds, rows packed into 64 bit words.
+ * Each cell also counts the viewers covering it. Updates are incremental: a viewer that changed cell
+ * has its old sight circle removed and the new one added, and a bit flips only when its count goes
+ * to or from zero. Most frames cost one cell lookup per unit plus the circles of units that crossed
+ * a cell edge. Cells are visible if any part of them could be in sight, so a cleared bit safely skips
+ * any finer check.
+ */
+struct FStrategyVisibilityGrid
+{
+	FStrategyVisibilityGrid();
+
+	/**
+	 * Cover new area, drops all viewers.
+	 *
+	 * @param	InBounds	World area to cover, only X and Y are used.
+	 * @param	InCellSize	Size of a single cell in world units.
+	 */
+	void Reset(const FBox& InBounds, float InCellSize);
+
+	/** @returns true if grid covers an area, uninitialized grid reports everything as visible */
+	bool IsInitialized() const { return NumCellsX > 0; }
+
+	/** @returns world area covered */
+	const FBox& GetBounds() const { return Bounds; }
+
+	/** @returns true if static viewers were last set for a different revision */
+	bool NeedsStaticViewers(uint32 Revision) const { return !bHasStaticViewers || Revision != StaticRevision; }
+
+	/**
+	 * Drop static viewers (buildings), to be added again for given revision.
+	 *
+	 * @param	Revision	Revision of the static viewers about to be added.
+	 */
+	void ResetStaticViewers(uint32 Revision);
+
+	/**
+	 * Add viewer that stays until next ResetStaticViewers.
+	 *
+	 * @param	TeamNum		Team the viewer sees for.
+	 * @param	Location	World location of the viewer.
+	 * @param	Radius		Sight radius in world units.
+	 */
+	void AddStaticViewer(uint8 TeamNum, const FVector& Location, float Radius);
+
+	/** start collecting moving viewers (units) for this frame */
+	void BeginUpdate();
+
+	/**
+	 * Add viewer for current update.
+	 *
+	 * @param	TeamNum		Team the viewer sees for.
+	 * @param	Location	World location of the viewer.
+	 * @param	Radius		Sight radius in world units.
+	 */
+	void AddViewer(uint8 TeamNum, const FVector& Location, float Radius);
+
+	/** add and remove circles of viewers that changed since last update */
+	void EndUpdate();
+
+	/**
+	 * Check if location could be seen by team.
+	 *
+	 * @param	TeamNum		Team to check.
+	 * @param	Location	World location.
+	 * @returns true if visible, or outside of the grid, or grid not initialized.
+	 */
+	bool IsVisible(uint8 TeamNum, const FVector& Location) const;
+
+	/** @returns true if cell is visible to team, cell must be inside the grid */
+	FORCEINLINE bool IsCellVisible(uint8 TeamNum, int32 CellX, int32 CellY) const
+	{
+		return (Bits[TeamNum][CellY * WordsPerRow + (CellX >> 6)] >> (CellX & 63)) & 1;
+	}
+
+	/** @returns number of cells visible to team */
+	int32 CountVisibleCells(uint8 TeamNum) const;
+
+	/** @returns number of circles added or removed since reset, for stats */
+	int32 GetNumStamps() const { return NumStamps; }
+
+private:
+	/** viewer quantized to the grid, compared between updates to find changes */
+	struct FViewer
+	{
+		int32 CellX;
+		int32 CellY;
+		int32 MaskIndex;
+
+		bool operator==(const FViewer& Other) const
+		{
+			return CellX == Other.CellX && CellY == Other.CellY && MaskIndex == Other.MaskIndex;
+		}
+
+		bool operator<(const FViewer& Other) const
+		{
+			if (CellY != Other.CellY)
+			{
+				return CellY < Other.CellY;
+			}
+			return CellX != Other.CellX ? CellX < Other.CellX : MaskIndex < Other.MaskIndex;
+		}
+	};
+
+	/** @returns viewer for given location and radius */
+	FViewer MakeViewer(const FVector& Location, float Radius);
+
+	/** @returns index of precomputed circle mask for radius, added if new */
+	int32 GetMaskIndex(float Radius);
+
+	/**
+	 * Add or remove circle of viewer in team counts, flipping bits of cells that gain their first or lose their last viewer.
+	 *
+	 * @param	TeamNum		Team the viewer sees for.
+	 * @param	Viewer		Viewer to stamp.
+	 * @param	bAdd		True to add the circle, false to remove it.
+	 */
+	void Stamp(uint8 TeamNum, const FViewer& Viewer, bool bAdd);
+
+	/** stamp differences between two sorted viewer lists, removing viewers only in Old and adding ones only in New */
+	void StampChanges(uint8 TeamNum, const TArray<FViewer>& Old, const TArray<FViewer>& New);
+
+	/** sort viewers and drop duplicates, so that comparing and stamping them doesn't depend on unit order */
+	static void SortUnique(TArray<FViewer>& InViewers);
+
+	/** world area covered */
+	FBox Bounds;
+
+	/** size of a single cell */
+	float CellSize;
+
+	/** grid size */
+	int32 NumCellsX;
+	int32 NumCellsY;
+
+	/** 64 bit words in a single row */
+	int32 WordsPerRow;
+
+	/** visibility bits for each team, row after row */
+	TArray<uint64> Bits[EStrategyTeam::MAX];
+
+	/** number of viewers covering each cell for each team, row after row */
+	TArray<uint16> ViewerCounts[EStrategyTeam::MAX];
+
+	/** viewers added this update and the ones bits were last built from */
+	TArray<FViewer> Viewers[EStrategyTeam::MAX];
+	TArray<FViewer> BuiltViewers[EStrategyTeam::MAX];
+
+	/** viewers kept between updates, and the ones currently stamped */
+	TArray<FViewer> StaticViewers[EStrategyTeam::MAX];
+	TArray<FViewer> BuiltStaticViewers[EStrategyTeam::MAX];
+
+	/** revision of static viewers */
+	uint32 StaticRevision;
+
+	/** set once static viewers were added after reset */
+	bool bHasStaticViewers;
+
+	/** set when static viewers of team changed */
+	bool bStaticDirty[EStrategyTeam::MAX];
+
+	/** circle masks, half width of each row from -radius to radius, in cells */
+	TArray<TArray<int32>> Masks;
+
+	/** radius in world units of each mask */
+	TArray<float> MaskRadii;
+
+	/** number of circles added or removed since reset */
+	int32 NumStamps;
+};
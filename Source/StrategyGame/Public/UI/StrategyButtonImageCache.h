@@ -0,0 +1,89 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+class ISlateBrushSource;
+
+/**
+ * One bit per texel of a button image, set where the image can be clicked.
+ * Large images are reduced so that no side is over MaxSize, a mask texel is set if any texel it covers is.
+ */
+struct FStrategyHitMask
+{
+	/** texels with alpha from this up can be clicked */
+	static const uint8 AlphaThreshold = 128;
+
+	/** largest mask side in texels */
+	static const int32 MaxSize = 128;
+
+	FStrategyHitMask();
+
+	/** texel size of the mask */
+	int32 SizeX;
+	int32 SizeY;
+
+	/** rows of SizeX bits, padded to whole words. Empty if every texel can be clicked */
+	TArray<uint32> Bits;
+
+	/**
+	 * Check if image can be clicked at a point.
+	 *
+	 * @param	UV	Point on the image, 0..1 on both axes.
+	 * @returns true if texel under the point is set, or the mask has no bits.
+	 */
+	bool IsHit(const FVector2D& UV) const;
+
+	/**
+	 * Build mask from alpha of an image.
+	 *
+	 * @param	Pixels		Image in B8G8R8A8, row after row.
+	 * @param	InSizeX		Width of the image.
+	 * @param	InSizeY		Height of the image.
+	 */
+	void Build(const uint32* Pixels, int32 InSizeX, int32 InSizeY);
+
+#if WITH_EDITORONLY_DATA
+	/**
+	 * Build mask from source data of a texture.
+	 *
+	 * @param	Texture		Texture to read, source must be B8G8R8A8.
+	 * @param	OutMask		Mask to build.
+	 * @returns false if texture has no source data in a supported format.
+	 */
+	static bool BuildFromSource(UTexture2D* Texture, FStrategyHitMask& OutMask);
+#endif
+};
+
+/** Brush and hit mask of a single texture, shared by all buttons showing it. */
+struct FStrategyButtonImage
+{
+	/** brush drawing the texture */
+	TSharedPtr<ISlateBrushSource> Brush;
+
+	/** where the texture can be clicked */
+	TSharedPtr<const FStrategyHitMask> HitMask;
+};
+
+/**
+ * Button images built once per texture and kept for as long as the owning HUD.
+ * Action menus set the same few textures every time they open, with the cache that costs a map lookup.
+ */
+struct FStrategyButtonImageCache
+{
+	/**
+	 * Get image of a texture, built on first use.
+	 *
+	 * @param	Texture	Texture to show on a button, must not be null.
+	 */
+	const FStrategyButtonImage& FindOrAdd(UTexture2D* Texture);
+
+	/** drop all images, buttons keep the ones they are showing */
+	void Empty();
+
+	/** @returns number of cached images */
+	int32 Num() const { return Images.Num(); }
+
+private:
+	/** images by texture */
+	TMap<TWeakObjectPtr<UTexture2D>, FStrategyButtonImage> Images;
+};
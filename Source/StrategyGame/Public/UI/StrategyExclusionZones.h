@@ -0,0 +1,71 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/**
+ * Screen areas covered by UI, where camera edge scrolling and swipes are ignored.
+ * Zones are set from widget geometry. Each one is stamped into the lookup grid with a margin,
+ * so the grid is rebuilt only when a zone is added, removed, or leaves its stamped area.
+ * A point query is one cell lookup plus a rect test for each zone touching that cell.
+ */
+struct FStrategyExclusionZones
+{
+	/** UI areas that can be excluded */
+	enum EZone
+	{
+		Zone_MiniMap,
+		Zone_ActionGrid,
+		Zone_PauseMenu,
+		Zone_MAX
+	};
+
+	/** size of a single lookup cell, in pixels */
+	static const int32 CellSize = 32;
+
+	/** how far a zone can move or grow before the grid is rebuilt, in pixels */
+	static const int32 MoveTolerance = CellSize;
+
+	FStrategyExclusionZones();
+
+	/**
+	 * Set area covered by zone, lookup is rebuilt if it changed.
+	 *
+	 * @param	Zone	Zone to set.
+	 * @param	Rect	Area in viewport pixels, invalid rect removes the zone.
+	 */
+	void SetZone(EZone Zone, const FBox2D& Rect);
+
+	/**
+	 * Check if position is covered by UI.
+	 *
+	 * @param	Position	Position in viewport pixels.
+	 * @returns true if position is inside any zone.
+	 */
+	bool IsExcluded(const FVector2D& Position) const;
+
+	/** @returns number of lookup rebuilds, for stats */
+	int32 GetNumRebuilds() const { return NumRebuilds; }
+
+private:
+	/** rebuild cell masks from zones */
+	void Rebuild();
+
+	/** area of each zone, invalid if not set */
+	FBox2D Zones[Zone_MAX];
+
+	/** area each zone was stamped into cells with, grown by MoveTolerance */
+	FBox2D StampedZones[Zone_MAX];
+
+	/** area covered by cells, union of all zones */
+	FBox2D GridBounds;
+
+	/** grid size */
+	int32 NumCellsX;
+	int32 NumCellsY;
+
+	/** bit per zone touching the cell, row after row */
+	TArray<uint8> CellMasks;
+
+	/** number of lookup rebuilds */
+	int32 NumRebuilds;
+};
@@ -2,9 +2,11 @@
 
 #pragma once
 
+#include "StrategyButtonImageCache.h"
+#include "StrategyExclusionZones.h"
 #include "StrategyHUD.generated.h"
 
-UCLASS()
+UCLASS(config=Game)
 class AStrategyHUD : public AHUD
 {
 	GENERATED_UCLASS_BODY()
@@ -12,9 +14,17 @@ class AStrategyHUD : public AHUD
 public:
 
 	// Begin HUD interface
+	virtual void PostInitializeComponents() override;
 	virtual void DrawHUD() override;
 	// End HUD interface
 
+	/**
+	 * Gets textures and materials the HUD resolves when spawned, to be loaded ahead of the match.
+	 *
+	 * @param	OutAssets	Receives asset paths.
+	 */
+	static void GetPreloadAssets(TArray<FSoftObjectPath>& OutAssets);
+
 	/** Returns true if the "Pause" Menu up. */
 	bool IsPauseMenuUp() const;
 
@@ -47,6 +57,12 @@ public:
 	/** Enables the black screen, used for transition from game */
 	void ShowBlackScreen();
 
+	/** Gets brushes and hit masks shared by all buttons of this HUD */
+	FStrategyButtonImageCache& GetButtonImageCache() { return ButtonImageCache; }
+
+	/** Gets screen areas covered by UI, where the camera doesn't scroll */
+	FStrategyExclusionZones& GetExclusionZones() { return ExclusionZones; }
+
 	/** position to display action grid */
 	FVector2D ActionGridPos;
 
@@ -67,6 +83,10 @@ public:
 	/** current UI scale */
 	float UIScale;
 
+	/** How many times per second unit dots on mini map are rebuilt */
+	UPROPERTY(config)
+	float MiniMapUnitUpdateRate;
+
 protected:
 
 	/** draws mouse pointer */
@@ -75,6 +95,31 @@ protected:
 	/** draws mini map */
 	void DrawMiniMap();
 
+	/**
+	 * Rebuild cached unit dots on mini map, one dot per occupied dot sized cell and team.
+	 *
+	 * @param	GameState	Game state holding the unit registry.
+	 * @param	PlayerTeam	Team shown in player color.
+	 * @param	MapRect		Screen rect of mini map.
+	 */
+	void UpdateMiniMapUnits(const AStrategyGameState* GameState, uint8 PlayerTeam, const FBox2D& MapRect);
+
+	/**
+	 * Rebuild cached building markers on mini map.
+	 *
+	 * @param	GameState	Game state holding team buildings.
+	 * @param	PlayerTeam	Team shown in player color.
+	 * @param	MapRect		Screen rect of mini map.
+	 */
+	void UpdateMiniMapBuildings(const AStrategyGameState* GameState, uint8 PlayerTeam, const FBox2D& MapRect);
+
+	/**
+	 * Project screen corners on the ground for the view rect on mini map, skipped unless view projection changed.
+	 *
+	 * @param	GameState	Game state holding the world bounds.
+	 */
+	void UpdateMiniMapView(const AStrategyGameState* GameState);
+
 	/** builds the slate widgets */
 	void BuildMenuWidgets();
 
@@ -82,14 +127,18 @@ protected:
 	void DrawLives() const;
 
 	/**
-	 * Draws health bar for specific actor.
+	 * Adds health bar to the batch drawn by FlushHealthBars, bars outside of view are skipped.
 	 *
-	 * @param	ForActor	Actor for which the health bar is for.
+	 * @param	Anchor		World location the bar is centered on.
+	 * @param	HalfWidth	Half of bar width, in world units.
 	 * @param	HealthPct	Current Health percentage.
 	 * @param	BarHeight	Height of the health bar
-	 * @param	OffsetY		Y Offset of the health bar.
+	 * @param	bPlayerTeam	Use player team texture.
 	 */
-	void DrawHealthBar(AActor* ForActor, float HealthPct, int32 BarHeight, int OffsetY = 0) const;
+	void AddHealthBar(const FVector& Anchor, float HalfWidth, float HealthPct, float BarHeight, bool bPlayerTeam);
+
+	/** draw batched health bars, one draw per texture */
+	void FlushHealthBars();
 
 	/** draw health bars for actors */
 	void DrawActorsHealth();
@@ -106,6 +155,41 @@ protected:
 	/** actor for which action grid is displayed*/
 	TWeakObjectPtr<AActor> SelectedActor;
 
+	/** batched health bar triangles, kept to reuse memory between frames */
+	TArray<FCanvasUVTri> PlayerHealthBarTris;
+	TArray<FCanvasUVTri> EnemyHealthBarTris;
+	TArray<FCanvasUVTri> HealthBarFillTris;
+
+	/** button images by texture, built the first time a texture is shown */
+	FStrategyButtonImageCache ButtonImageCache;
+
+	/** UI areas excluded from camera scrolling, updated by HUD widget when its layout changes */
+	FStrategyExclusionZones ExclusionZones;
+
+	/** cached mini map building markers, drawn over baked terrain */
+	TArray<FCanvasUVTri> MiniMapBuildingTris;
+
+	/** game state buildings revision the markers were built for */
+	uint32 MiniMapBuildingsRevision;
+
+	/** screen rect building markers were built for */
+	FBox2D MiniMapBuildingRect;
+
+	/** cached mini map unit dots */
+	TArray<FCanvasUVTri> MiniMapUnitTris;
+
+	/** occupied mini map cells, 1 for player team and 2 for others, kept to reuse memory */
+	TArray<uint8> MiniMapUnitCells;
+
+	/** real time when unit dots are rebuilt next */
+	float NextMiniMapUnitUpdateTime;
+
+	/** screen rect unit dots were built for */
+	FBox2D MiniMapUnitRect;
+
+	/** view projection revision MiniMapPoints were computed for */
+	uint32 MiniMapViewRevision;
+
 	/** gray health bar texture */
 	UPROPERTY()
 	class UTexture2D* BarFillTexture;
@@ -142,6 +226,40 @@ protected:
 	UPROPERTY()
 	UTexture2D* LivesTexture;
 
+	/** assets resolved into textures and materials above when HUD is spawned, /Game/UI is always cooked */
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> BarFillAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> PlayerTeamHPAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> EnemyTeamHPAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> DefaultActionAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> DefaultCenterActionAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> ActionPauseAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> MenuButtonAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> ResourceAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UTexture2D> LivesAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UMaterial> MousePointerNeutralAsset;
+
+	UPROPERTY()
+	TSoftObjectPtr<UMaterial> MousePointerAttackAsset;
+
 	/** if we are currently drawing black screen */
 	uint8 bBlackScreenActive : 1;
 };
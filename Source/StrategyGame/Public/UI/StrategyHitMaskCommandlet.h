@@ -0,0 +1,26 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "StrategyHitMaskCommandlet.generated.h"
+
+/**
+ * Attaches hit masks to button textures and saves them, so they are cooked with the textures.
+ * Masks are never built while playing, run this after adding or reimporting button textures:
+ *
+ *   UE4Editor-Cmd StrategyGame -run=StrategyHitMask [-Path=/Game/UI/X]
+ */
+UCLASS(config=Game)
+class UStrategyHitMaskCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	/** content folders holding button textures */
+	UPROPERTY(config)
+	TArray<FString> TexturePaths;
+
+	// Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet interface
+};
@@ -0,0 +1,34 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/AssetUserData.h"
+#include "StrategyHitMaskUserData.generated.h"
+
+/**
+ * Hit mask of a button texture, saved and cooked with the texture so that games don't read texture data.
+ * Added to textures by UStrategyHitMaskCommandlet, rebuilt from texture source on every save.
+ */
+UCLASS()
+class UStrategyHitMaskUserData : public UAssetUserData
+{
+	GENERATED_UCLASS_BODY()
+
+	/** texel size of the mask */
+	UPROPERTY()
+	int32 SizeX;
+
+	UPROPERTY()
+	int32 SizeY;
+
+	/** rows of mask bits, see FStrategyHitMask */
+	UPROPERTY()
+	TArray<uint32> Bits;
+
+	// Begin UObject interface
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+	// End UObject interface
+
+	/** rebuild mask from source data of texture this is attached to, editor only */
+	void Rebuild();
+};
@@ -7,6 +7,7 @@
 #include "SlateExtras.h"
 #include "MoviePlayer.h"
 #include "SThrobber.h"
+#include "SProgressBar.h"
 
 // This module must be loaded "PreLoadingScreen" in the .uproject file, otherwise it will not hook in time!
 
@@ -27,7 +28,13 @@ struct FStrategyGameLoadingScreenBrush : public FSlateDynamicImageBrush, public
 class SStrategyLoadingScreen : public SCompoundWidget
 {
 public:
-	SLATE_BEGIN_ARGS(SStrategyLoadingScreen) {}
+	SLATE_BEGIN_ARGS(SStrategyLoadingScreen)
+		: _Progress(nullptr)
+	{}
+
+	/** progress in thousandths, negative if unknown. Written by game thread, read by loading screen thread */
+	SLATE_ARGUMENT(const FThreadSafeCounter*, Progress)
+
 	SLATE_END_ARGS()
 
 
@@ -35,6 +42,8 @@ public:
 	{
 		static const FName LoadingScreenName(TEXT("/Game/UI/MainMenu/StrategyGame_LoadingScreen.StrategyGame_LoadingScreen"));
 
+		Progress = InArgs._Progress;
+
 		LoadingScreenBrush = MakeShareable( new FStrategyGameLoadingScreenBrush( LoadingScreenName, FVector2D(1920,1080) ) );
 
 		ChildSlot
@@ -60,11 +69,29 @@ public:
 					SNew(SThrobber)
 					.Visibility(this, &SStrategyLoadingScreen::GetLoadIndicatorVisibility)
 				]
+				+SVerticalBox::Slot()
+				.AutoHeight()
+				.Padding(FMargin(10.0f))
+				[
+					SNew(SProgressBar)
+					.Visibility(this, &SStrategyLoadingScreen::GetProgressVisibility)
+					.Percent(this, &SStrategyLoadingScreen::GetProgressPercent)
+				]
 			]
 		];
 	}
 
 private:
+	EVisibility GetProgressVisibility() const
+	{
+		return (Progress != nullptr && Progress->GetValue() >= 0 && !GetMoviePlayer()->IsLoadingFinished()) ? EVisibility::Visible : EVisibility::Collapsed;
+	}
+
+	TOptional<float> GetProgressPercent() const
+	{
+		return Progress != nullptr ? FMath::Clamp(Progress->GetValue() / 1000.0f, 0.0f, 1.0f) : 0.0f;
+	}
+
 	EVisibility GetLoadIndicatorVisibility() const
 	{
 		bool Vis =  GetMoviePlayer()->IsLoadingFinished();
@@ -73,13 +100,25 @@ private:
 
 	/** loading screen image brush */
 	TSharedPtr<FSlateDynamicImageBrush> LoadingScreenBrush;
+
+	/** progress owned by the module */
+	const FThreadSafeCounter* Progress;
 };
 
 class FStrategyGameLoadingScreenModule : public IStrategyGameLoadingScreenModule
 {
 public:
+	FStrategyGameLoadingScreenModule()
+		: Progress(-1)
+		, StartupStartTime(0.0)
+		, StartupEndTime(0.0)
+	{
+	}
+
 	virtual void StartupModule() override
 	{
+		StartupStartTime = FPlatformTime::Seconds();
+
 		//force load for cooker reference
 		LoadObject<UObject>(NULL, TEXT("/Game/UI/MainMenu/StrategyGame_LoadingScreen.StrategyGame_LoadingScreen") );
 
@@ -87,6 +126,8 @@ public:
 		{
 			CreateScreen();
 		}
+
+		StartupEndTime = FPlatformTime::Seconds();
 	}
 
 	virtual bool IsGameModule() const override
@@ -99,15 +140,35 @@ public:
 		CreateScreen();
 	}
 
+	virtual void SetLoadingProgress(float InProgress) override
+	{
+		Progress.Set(InProgress < 0.0f ? -1 : FMath::RoundToInt(FMath::Min(InProgress, 1.0f) * 1000.0f));
+	}
+
+	virtual bool GetStartupTime(double& OutStartTime, double& OutEndTime) const override
+	{
+		OutStartTime = StartupStartTime;
+		OutEndTime = StartupEndTime;
+		return StartupEndTime > 0.0;
+	}
+
 	virtual void CreateScreen()
 	{
 		FLoadingScreenAttributes LoadingScreen;
 		LoadingScreen.bAutoCompleteWhenLoadingCompletes = true;
 		LoadingScreen.MinimumLoadingScreenDisplayTime = 0.f;
-		LoadingScreen.WidgetLoadingScreen = SNew(SStrategyLoadingScreen);
+		LoadingScreen.WidgetLoadingScreen = SNew(SStrategyLoadingScreen).Progress(&Progress);
 		GetMoviePlayer()->SetupLoadingScreen(LoadingScreen);
 	}
 
+private:
+	/** progress shown by loading screen, in thousandths, negative if unknown */
+	FThreadSafeCounter Progress;
+
+	/** when StartupModule started and ended */
+	double StartupStartTime;
+	double StartupEndTime;
+
 };
 
 IMPLEMENT_GAME_MODULE(FStrategyGameLoadingScreenModule, StrategyGameLoadingScreen);
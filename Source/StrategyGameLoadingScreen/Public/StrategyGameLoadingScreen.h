@@ -11,4 +11,10 @@ class IStrategyGameLoadingScreenModule : public IModuleInterface
 public:
 	/** Kicks off the loading screen for in game loading (not startup) */
 	virtual void StartInGameLoadingScreen() = 0;
+
+	/** Sets progress shown by the loading screen, 0..1, negative hides progress bar. Safe to call from any thread */
+	virtual void SetLoadingProgress(float Progress) = 0;
+
+	/** Gets FPlatformTime::Seconds() at start and end of module startup, for startup trace. Returns false if not started */
+	virtual bool GetStartupTime(double& OutStartTime, double& OutEndTime) const = 0;
 };